@@ -58,13 +58,14 @@ public:
     virtual void teardown(PlatformThreadInfo *) override;
 
 protected:
-    // Find the appropriate font manager
-    FontManager_AndroidRef findFontManagerForFont(PlatformInfo_Android *,jobject typefaceObj,const LabelInfo &);
+    // Find the appropriate font manager.  Distance field ones only care about the typeface.
+    FontManager_AndroidRef findFontManagerForFont(PlatformInfo_Android *,jobject typefaceObj,const LabelInfo &,bool sdf);
 
     // Java object that can do the character rendering for us
     jobject charRenderObj = nullptr;
     jobject glyphClassRef = nullptr;
     jmethodID renderMethodID = nullptr;
+    jmethodID renderPlainMethodID = nullptr;
     jfieldID bitmapID = nullptr;
     jfieldID sizeXID = nullptr;
     jfieldID sizeYID = nullptr;
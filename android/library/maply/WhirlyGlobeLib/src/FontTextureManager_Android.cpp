@@ -77,6 +77,8 @@ FontTextureManager_Android::FontTextureManager_Android(PlatformThreadInfo *inst,
 	{
 		renderMethodID = env->GetMethodID(charRenderClass, "renderChar",
 										  "(ILcom/mousebird/maply/LabelInfo;F)Lcom/mousebird/maply/CharRenderer$Glyph;");
+		renderPlainMethodID = env->GetMethodID(charRenderClass, "renderCharPlain",
+											   "(ILcom/mousebird/maply/LabelInfo;F)Lcom/mousebird/maply/CharRenderer$Glyph;");
 		env->DeleteLocalRef(charRenderClass);
 	}
 
@@ -134,6 +136,7 @@ void FontTextureManager_Android::teardown(PlatformThreadInfo* threadInfo)
 
 	charRenderObj = nullptr;
 	renderMethodID = nullptr;
+	renderPlainMethodID = nullptr;
 	glyphClassRef = nullptr;
 }
 
@@ -157,14 +160,34 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
     // If not initialized, set up texture atlas and such
     init();
 
-    auto drawString = std::make_unique<DrawableString>();
-    auto drawStringRep = std::make_unique<DrawStringRep>(drawString->getId());
+    // Distance field glyphs are rendered once at one size and scaled from there
+    const bool sdf = canUseSDF(*labelInfo) && renderPlainMethodID;
+    const float glyphScale = (sdf ? labelInfo->fontSize / sdfSize : 1.0f) / BogusFontScale;
 
     // Look for the font manager that manages the typeface/attribute combo we need
-    auto fm = findFontManagerForFont(threadInfo,labelInfo->typefaceObj,*labelInfo);
+    auto fm = findFontManagerForFont(threadInfo,labelInfo->typefaceObj,*labelInfo,sdf);
+
+    // The font manager covers the typeface and colors, so it, the size, and
+    //  the characters are enough to find a string we've done before
+    std::string cacheKey;
+    cacheKey.reserve(sizeof(SimpleIdentity) + sizeof(float) + codePoints.size() * sizeof(int));
+    const SimpleIdentity fontId = fm->getId();
+    cacheKey.append((const char *)&fontId, sizeof(fontId));
+    cacheKey.append((const char *)&labelInfo->fontSize, sizeof(labelInfo->fontSize));
+    cacheKey.append((const char *)codePoints.data(), codePoints.size() * sizeof(int));
+    if (auto cachedString = findCachedString(cacheKey))
+    {
+        return cachedString;
+    }
+
+    auto drawString = std::make_unique<DrawableString>();
+    auto drawStringRep = std::make_unique<DrawStringRep>(drawString->getId());
+    drawString->sdf = sdf;
 
     // Work through the characters
     GlyphSet glyphsUsed;
+    std::vector<CachedGlyph> cachedGlyphs;
+    cachedGlyphs.reserve(codePoints.size());
     float offsetX = 0.0;
     for (const int glyph : codePoints)
     {
@@ -173,8 +196,8 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
         if (!glyphInfo)
         {
             // Call the renderer
-            jobject glyphObj = env->CallObjectMethod(charRenderObj,renderMethodID,glyph,
-                                                     labelInfo->labelInfoObj,labelInfo->fontSize);
+            jobject glyphObj = env->CallObjectMethod(charRenderObj,sdf ? renderPlainMethodID : renderMethodID,glyph,
+                                                     labelInfo->labelInfoObj,fm->pointSize);
             if (!glyphObj)
             {
                 wkLogLevel(Warn,"Glyph render failed from FontTextureManager_Android: %d",glyph);
@@ -221,9 +244,22 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
                     {
                         assert(info.width * 4 == info.stride);
 
-                        auto rawData = new MutableRawData(bitmapPixels, info.height * info.width * 4);
                         TextureGLES tex("FontTextureManager");
-                        tex.setRawData(rawData, info.width, info.height);
+                        if (sdf)
+                        {
+                            // The distance field adds a border for the falloff
+                            int sdfWidth = 0,sdfHeight = 0;
+                            auto rawData = buildSDFGlyph((const unsigned char *)bitmapPixels, info.width, info.height,
+                                                         info.stride, sdfWidth, sdfHeight);
+                            tex.setRawData(rawData, sdfWidth, sdfHeight);
+                            const float border = (sdfWidth - (int)info.width) / 2.0f;
+                            textureOffset += Point2f(border, border);
+                        }
+                        else
+                        {
+                            auto rawData = new MutableRawData(bitmapPixels, info.height * info.width * 4);
+                            tex.setRawData(rawData, info.width, info.height);
+                        }
 
                         // Add it to the texture atlas
                         SubTexture subTex;
@@ -270,14 +306,15 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
         {
             // Now we make a rectangle that covers the glyph in its texture atlas
             DrawableString::Rect rect;
-            const float scale = 1.0f/BogusFontScale;
+            const float scale = glyphScale;
             const Point2f offset(offsetX,-glyphInfo->offset.y()*scale);
 
             // Note: was -1,-1
             rect.pts[0] = (glyphInfo->offset - glyphInfo->textureOffset) * scale + offset;
             rect.texCoords[0] = TexCoord(0.0,1.0);
             // Note: was 2,2
-            rect.pts[1] = (glyphInfo->size + glyphInfo->textureOffset) * scale + rect.pts[0];
+            // Distance fields get scaled, so they need to cover exactly the texture
+            rect.pts[1] = (glyphInfo->size + (sdf ? 2 : 1) * glyphInfo->textureOffset) * scale + rect.pts[0];
             rect.texCoords[1] = TexCoord(1.0,0.0);
 
             rect.subTex = glyphInfo->subTex;
@@ -286,8 +323,9 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
             drawString->mbr.addPoint(rect.pts[1]);
 
             glyphsUsed.insert(glyphInfo->glyph);
+            cachedGlyphs.push_back(CachedGlyph { fontId, glyphInfo->glyph });
 
-            offsetX += glyphInfo->size.x() / BogusFontScale;
+            offsetX += glyphInfo->size.x() * glyphScale;
         }
     }
 
@@ -303,22 +341,30 @@ std::unique_ptr<DrawableString> FontTextureManager_Android::addString(
 	{
 		// We need to track the glyphs we're using
 		drawStringReps.insert(drawStringRep.release());
+		addCachedString(cacheKey,*drawString,std::move(cachedGlyphs));
 		return drawString;
 	}
 }
 
-FontTextureManager_Android::FontManager_AndroidRef FontTextureManager_Android::findFontManagerForFont(PlatformInfo_Android *threadInfo,jobject typefaceObj,const LabelInfo &inLabelInfo)
+FontTextureManager_Android::FontManager_AndroidRef FontTextureManager_Android::findFontManagerForFont(PlatformInfo_Android *threadInfo,jobject typefaceObj,const LabelInfo &inLabelInfo,bool sdf)
 {
 	const LabelInfoAndroid &labelInfo = (LabelInfoAndroid &)inLabelInfo;
 
+	// Distance fields are plain white at a fixed size, so they only depend on the typeface
+	const float pointSize = sdf ? sdfSize : labelInfo.fontSize;
+	const RGBAColor color = sdf ? RGBAColor::white() : labelInfo.textColor;
+	const RGBAColor outlineColor = sdf ? RGBAColor(0,0,0,0) : labelInfo.outlineColor;
+	const float outlineSize = sdf ? 0.0f : labelInfo.outlineSize;
+
 	for (const auto &it : fontManagers)
 	{
 		if (auto fm = std::dynamic_pointer_cast<FontManager_Android>(it.second))
 		{
-			if (fm->pointSize == labelInfo.fontSize &&
-				fm->color == labelInfo.textColor &&
-				fm->outlineColor == labelInfo.outlineColor &&
-				fm->outlineSize == labelInfo.outlineSize &&
+			if (fm->sdf == sdf &&
+				fm->pointSize == pointSize &&
+				fm->color == color &&
+				fm->outlineColor == outlineColor &&
+				fm->outlineSize == outlineSize &&
 				labelInfo.typefaceIsSame(threadInfo, fm->typefaceObj))
 			{
 				return fm;
@@ -328,10 +374,11 @@ FontTextureManager_Android::FontManager_AndroidRef FontTextureManager_Android::f
 
 	// Didn't find it, so create it
 	auto fm = std::make_shared<FontManager_Android>(threadInfo,typefaceObj);
-	fm->color = labelInfo.textColor;
-	fm->pointSize = labelInfo.fontSize;
-	fm->outlineColor = labelInfo.outlineColor;
-	fm->outlineSize = labelInfo.outlineSize;
+	fm->color = color;
+	fm->pointSize = pointSize;
+	fm->outlineColor = outlineColor;
+	fm->outlineSize = outlineSize;
+	fm->sdf = sdf;
 	fontManagers[fm->getId()] = fm;
 
 //	wkLogLevel(Info,"Font added: fm = %d,",(int)fm->getId());
@@ -624,6 +624,165 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_LayoutManager_getFadeEnabled
     return false;
 }
 
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_setIncrementalLayout
+        (JNIEnv *env, jobject obj, jboolean enable)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            wrap->layoutManager->setIncrementalLayout(enable);
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_LayoutManager_getIncrementalLayout
+        (JNIEnv *env, jobject obj)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            return wrap->layoutManager->getIncrementalLayout();
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return false;
+}
+
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_setLayoutThreads
+        (JNIEnv *env, jobject obj, jint numThreads)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            // Layout gets its own pool so it doesn't end up queued behind tile parsing
+            wrap->layoutManager->setLayoutPool((numThreads > 0) ? std::make_shared<ThreadPool>(numThreads) : ThreadPoolRef());
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_setOverlapIndexNative
+        (JNIEnv *env, jobject obj, jint index)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            wrap->layoutManager->setOverlapIndex((index == OverlapHelper::OverlapTreeIndex) ?
+                                                 OverlapHelper::OverlapTreeIndex : OverlapHelper::OverlapGridIndex);
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
+extern "C"
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_LayoutManager_getOverlapIndexNative
+        (JNIEnv *env, jobject obj)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            return wrap->layoutManager->getOverlapIndex();
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return OverlapHelper::OverlapGridIndex;
+}
+
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_setClusterIndex
+        (JNIEnv *env, jobject obj, jboolean enable)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            wrap->layoutManager->setClusterIndex(enable);
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_LayoutManager_getClusterIndex
+        (JNIEnv *env, jobject obj)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            return wrap->layoutManager->getClusterIndex();
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return false;
+}
+
+extern "C"
+JNIEXPORT jdoubleArray JNICALL Java_com_mousebird_maply_LayoutManager_getLayoutTiming
+        (JNIEnv *env, jobject obj, jstring nameStr)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            const JavaString name(env, nameStr);
+            const auto entry = wrap->layoutManager->getLayoutStats().getTiming(name.getCString());
+            if (entry.numRuns > 0)
+            {
+                return BuildDoubleArray(env, { (double)entry.numRuns, entry.minDur, entry.maxDur,
+                                               entry.avgDur / entry.numRuns });
+            }
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return nullptr;
+}
+
+extern "C"
+JNIEXPORT jdoubleArray JNICALL Java_com_mousebird_maply_LayoutManager_getLayoutCount
+        (JNIEnv *env, jobject obj, jstring nameStr)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            const JavaString name(env, nameStr);
+            const auto entry = wrap->layoutManager->getLayoutStats().getCount(name.getCString());
+            if (entry.numRuns > 0)
+            {
+                return BuildDoubleArray(env, { (double)entry.numRuns, (double)entry.minCount, (double)entry.maxCount,
+                                               (double)entry.avgCount / entry.numRuns, (double)entry.lastCount });
+            }
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return nullptr;
+}
+
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_clearLayoutStats
+        (JNIEnv *env, jobject obj)
+{
+    try
+    {
+        if (auto wrap = LayoutManagerWrapperClassInfo::get(env, obj))
+        {
+            wrap->layoutManager->clearLayoutStats();
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
 extern "C"
 JNIEXPORT void JNICALL Java_com_mousebird_maply_LayoutManager_setShowDebugLayoutBoundaries
         (JNIEnv *env, jobject obj, jboolean show)
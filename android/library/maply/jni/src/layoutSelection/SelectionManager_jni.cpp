@@ -90,6 +90,80 @@ JNIEXPORT jlong JNICALL Java_com_mousebird_maply_SelectionManager_pickObject
     return EmptyIdentity;
 }
 
+// Add the selectable vector features near a screen point, which the component manager handles
+static void AddVectorsAtPoint(ComponentManager *compManager,const ViewStateRef &viewState,SceneRenderer *renderer,
+                              const Point2f &pt2f,double maxDist,std::vector<SelectionManager::SelectedObject> &selObjs)
+{
+    const auto coordAdapter = viewState->coordAdapter;
+    const auto coordSystem = coordAdapter ? coordAdapter->getCoordSystem() : nullptr;
+    if (!coordSystem)
+    {
+        return;
+    }
+
+    const Point2f frameBufSize = renderer->getFramebufferSize();
+    const Point2f frameBufSizeScaled = renderer->getFramebufferSizeScaled();
+
+    // Need the point in geographic
+    Point3d dispPt;
+    if (auto *globeViewState = dynamic_cast<WhirlyGlobe::GlobeViewState *>(viewState.get()))
+    {
+        const auto &matrix = globeViewState->fullMatrices[0];
+        if (!globeViewState->pointOnSphereFromScreen(pt2f, matrix, frameBufSize,dispPt))
+        {
+            return;
+        }
+    }
+    else if (auto *mapViewState = dynamic_cast<Maply::MapViewState *>(viewState.get()))
+    {
+        const auto &matrix = mapViewState->fullMatrices[0];
+        if (!mapViewState->pointOnPlaneFromScreen(pt2f, matrix, frameBufSize, dispPt, false))
+        {
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    const Point3d locPoint = coordAdapter->displayToLocal(dispPt);
+    const Point2f geoPoint = coordSystem->localToGeographic(locPoint);
+    const Point2d geoPoint2d = geoPoint.cast<double>();
+
+    // This one does vector features
+    auto vecObjs = compManager->findVectors(geoPoint2d, maxDist, viewState, frameBufSizeScaled);
+
+    selObjs.reserve(selObjs.size() + vecObjs.size());
+    for (const auto &vecObj : vecObjs)
+    {
+        selObjs.emplace_back(vecObj.second->getId(), 0.0, 0.0);
+        selObjs.back().vecObj = vecObj.second;
+    }
+}
+
+// Wrap up the selected objects for Java, or null if there aren't any
+static jobjectArray MakeSelectedObjectArray(JNIEnv *env,std::vector<SelectionManager::SelectedObject> &selObjs)
+{
+    if (selObjs.empty())
+    {
+        return nullptr;
+    }
+
+    jclass jc = SelectedObjectClassInfo::getClassInfo(env,"com/mousebird/maply/SelectedObject")->getClass();
+    jobjectArray retArray = env->NewObjectArray(selObjs.size(), jc, nullptr);
+    int which = 0;
+    for (auto &selObj : selObjs)
+    {
+        jobject newObj = MakeSelectedObject(env,std::move(selObj));
+        env->SetObjectArrayElement(retArray,which,newObj);
+        env->DeleteLocalRef(newObj);
+        which++;
+    }
+
+    return retArray;
+}
+
 extern "C"
 JNIEXPORT jobjectArray JNICALL Java_com_mousebird_maply_SelectionManager_pickObjects
   (JNIEnv *env, jobject selManageObj, jobject compManageObj,
@@ -107,9 +181,7 @@ JNIEXPORT jobjectArray JNICALL Java_com_mousebird_maply_SelectionManager_pickObj
         }
 
         const auto renderer = (*selectionManager)->getSceneRenderer();
-        const auto coordAdapter = (*viewState)->coordAdapter;
-        const auto coordSystem = coordAdapter ? coordAdapter->getCoordSystem() : nullptr;
-        if (!renderer || !coordSystem)
+        if (!renderer)
         {
             return nullptr;
         }
@@ -120,63 +192,76 @@ JNIEXPORT jobjectArray JNICALL Java_com_mousebird_maply_SelectionManager_pickObj
         const Point2f pt2f = point->cast<float>();
         (*selectionManager)->pickObjects(pt2f, maxDist, *viewState, selObjs);
 
-        const Point2f frameBufSize = renderer->getFramebufferSize();
-        const Point2f frameBufSizeScaled = renderer->getFramebufferSizeScaled();
+        AddVectorsAtPoint(compManager->get(), *viewState, renderer, pt2f, maxDist, selObjs);
 
-        // Need the point in geographic
-        Point3d dispPt;
-        if (auto *globeViewState = dynamic_cast<WhirlyGlobe::GlobeViewState *>(viewState->get()))
-        {
-            const auto &matrix = globeViewState->fullMatrices[0];
-            if (!globeViewState->pointOnSphereFromScreen(pt2f, matrix, frameBufSize,dispPt))
-            {
-                return nullptr;
-            }
-        }
-        else if (auto *mapViewState = dynamic_cast<Maply::MapViewState *>(viewState->get()))
-        {
-            const auto &matrix = mapViewState->fullMatrices[0];
-            if (!mapViewState->pointOnPlaneFromScreen(pt2f, matrix, frameBufSize, dispPt, false))
-            {
-                return nullptr;
-            }
-        }
-        else
+        return MakeSelectedObjectArray(env, selObjs);
+    }
+    MAPLY_STD_JNI_CATCH()
+    return nullptr;
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL Java_com_mousebird_maply_SelectionManager_pickObjectsAtPoints
+  (JNIEnv *env, jobject selManageObj, jobject compManageObj,
+   jobject viewStateObj, jfloatArray pointsArray, jdouble maxDist)
+{
+    try
+    {
+        const auto selectionManager = SelectionManagerClassInfo::get(env,selManageObj);
+        const auto compManager = ComponentManagerClassInfo::get(env,compManageObj);
+        const auto viewState = ViewStateRefClassInfo::get(env, viewStateObj);
+        const auto renderer = selectionManager ? (*selectionManager)->getSceneRenderer() : nullptr;
+        if (!selectionManager || !compManager || !viewState || !renderer || !pointsArray)
         {
             return nullptr;
         }
 
-        const Point3d locPoint = coordAdapter->displayToLocal(dispPt);
-        const Point2f geoPoint = coordSystem->localToGeographic(locPoint);
-        const Point2d geoPoint2d = geoPoint.cast<double>();
+        Point2fVector pts;
+        ConvertFloat2fArray(env, pointsArray, pts);
 
-        // This one does vector features
-        auto vecObjs = (*compManager)->findVectors(geoPoint2d, maxDist, *viewState, frameBufSizeScaled);
+        // The selection manager does all the points in one go
+        std::vector<std::vector<SelectionManager::SelectedObject>> selObjs;
+        (*selectionManager)->pickObjects(pts, maxDist, *viewState, selObjs);
 
-        selObjs.reserve(selObjs.size() + vecObjs.size());
-        for (const auto &vecObj : vecObjs)
+        jclass jc = env->FindClass("[Lcom/mousebird/maply/SelectedObject;");
+        jobjectArray retArray = env->NewObjectArray(pts.size(), jc, nullptr);
+        env->DeleteLocalRef(jc);
+        for (unsigned int ii=0;ii<pts.size();ii++)
         {
-            selObjs.emplace_back(vecObj.second->getId(), 0.0, 0.0);
-            selObjs.back().vecObj = vecObj.second;
+            AddVectorsAtPoint(compManager->get(), *viewState, renderer, pts[ii], maxDist, selObjs[ii]);
+            if (jobjectArray ptArray = MakeSelectedObjectArray(env, selObjs[ii]))
+            {
+                env->SetObjectArrayElement(retArray,ii,ptArray);
+                env->DeleteLocalRef(ptArray);
+            }
         }
 
-        if (selObjs.empty())
+        return retArray;
+    }
+    MAPLY_STD_JNI_CATCH()
+    return nullptr;
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL Java_com_mousebird_maply_SelectionManager_pickObjectsInRegionNative
+  (JNIEnv *env, jobject selManageObj, jobject viewStateObj, jfloatArray regionArray)
+{
+    try
+    {
+        const auto selectionManager = SelectionManagerClassInfo::get(env,selManageObj);
+        const auto viewState = ViewStateRefClassInfo::get(env, viewStateObj);
+        if (!selectionManager || !viewState || !regionArray)
         {
             return nullptr;
         }
 
-        jclass jc = SelectedObjectClassInfo::getClassInfo(env,"com/mousebird/maply/SelectedObject")->getClass();
-        jobjectArray retArray = env->NewObjectArray(selObjs.size(), jc, nullptr);
-        int which = 0;
-        for (auto &selObj : selObjs)
-        {
-            jobject newObj = MakeSelectedObject(env,std::move(selObj));
-            env->SetObjectArrayElement(retArray,which,newObj);
-            env->DeleteLocalRef(newObj);
-            which++;
-        }
+        Point2fVector region;
+        ConvertFloat2fArray(env, regionArray, region);
 
-        return retArray;
+        std::vector<SelectionManager::SelectedObject> selObjs;
+        (*selectionManager)->pickObjectsInRegion(region, *viewState, selObjs);
+
+        return MakeSelectedObjectArray(env, selObjs);
     }
     MAPLY_STD_JNI_CATCH()
     return nullptr;
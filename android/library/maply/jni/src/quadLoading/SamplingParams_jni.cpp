@@ -519,6 +519,42 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_SamplingParams_getSingleLeve
 	return false;
 }
 
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_SamplingParams_setImportanceThreads
+  (JNIEnv *env, jobject obj, jint numThreads)
+{
+	try
+	{
+		if (const auto params = SamplingParamsClassInfo::get(env,obj))
+		{
+			params->importanceThreads = std::max(numThreads, 0);
+		}
+	}
+	catch (...)
+	{
+		__android_log_print(ANDROID_LOG_ERROR, "Maply", "Crash in SamplingParams::setImportanceThreads()");
+	}
+}
+
+extern "C"
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_SamplingParams_getImportanceThreads
+  (JNIEnv *env, jobject obj)
+{
+	try
+	{
+		if (const auto params = SamplingParamsClassInfo::get(env,obj))
+		{
+			return params->importanceThreads;
+		}
+	}
+	catch (...)
+	{
+		__android_log_print(ANDROID_LOG_ERROR, "Maply", "Crash in SamplingParams::getImportanceThreads()");
+	}
+
+	return 0;
+}
+
 extern "C"
 JNIEXPORT void JNICALL Java_com_mousebird_maply_SamplingParams_setLevelLoads
   (JNIEnv *env, jobject obj, jintArray levelArray)
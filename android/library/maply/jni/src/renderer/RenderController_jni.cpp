@@ -272,6 +272,8 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setupShadersNat
 		// Screen space
 		rendWrap.addShader(MaplyScreenSpaceDefaultMotionShader,ProgramGLESRef(BuildScreenSpaceMotionProgramGLES(MaplyScreenSpaceDefaultMotionShader,renderer)));
 		rendWrap.addShader(MaplyScreenSpaceDefaultShader,ProgramGLESRef(BuildScreenSpaceProgramGLES(MaplyScreenSpaceDefaultShader,renderer)));
+		rendWrap.addShader(MaplyScreenSpaceSDFMotionShader,ProgramGLESRef(BuildScreenSpaceSDFMotionProgramGLES(MaplyScreenSpaceSDFMotionShader,renderer)));
+		rendWrap.addShader(MaplyScreenSpaceSDFShader,ProgramGLESRef(BuildScreenSpaceSDFProgramGLES(MaplyScreenSpaceSDFShader,renderer)));
 		// Particles
 		rendWrap.addShader(MaplyParticleSystemPointDefaultShader,ProgramGLESRef(BuildParticleSystemProgramGLES(MaplyParticleSystemPointDefaultShader,renderer)));
 	}
@@ -125,6 +125,20 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_removeShaderProgram(JNIEnv
     MAPLY_STD_JNI_CATCH()
 }
 
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setSDFGlyphs(JNIEnv *env, jobject obj, jboolean enable, jfloat glyphSize, jfloat spread)
+{
+    try
+    {
+        if (Scene *scene = SceneClassInfo::get(env,obj))
+        if (const auto fontTexManager = scene->getFontTextureManager())
+        {
+            fontTexManager->setSDFMode(enable,glyphSize,spread);
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
 extern "C"
 JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_teardownGL(JNIEnv *env, jobject obj)
 {
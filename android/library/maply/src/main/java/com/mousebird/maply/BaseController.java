@@ -1887,6 +1887,76 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 		return selObjs;
 	}
 
+	/**
+	 * Returns the selectable objects near each of a set of screen locations, as for multi-touch or hover.
+	 * The view is only set up once for the whole set.
+	 * @param screenLocs Locations in view coordinates.
+	 * @param maxDist Search distance around each location.
+	 * @return One entry per location, null where nothing was found.
+	 */
+	@Nullable
+	public SelectedObject[][] getObjectsAtScreenLocs(@NotNull Point2d[] screenLocs,double maxDist) {
+		final com.mousebird.maply.View theView = view;
+		if (renderWrapper == null || theView == null) {
+			return null;
+		}
+
+		final Point2d[] frameLocs = screenToFrameLocs(screenLocs);
+		final ViewState theViewState = theView.makeViewState(renderControl);
+		final SelectedObject[][] selObjs = renderControl.selectionManager.pickObjects(
+				renderControl.componentManager,theViewState,frameLocs,maxDist);
+		theViewState.dispose();
+
+		if (selObjs != null) {
+			for (int ii=0;ii<selObjs.length;ii++) {
+				if (selObjs[ii] != null && selObjs[ii].length > 0) {
+					renderControl.componentManager.remapSelectableObjects(selObjs[ii]);
+					selObjs[ii] = filterMissingObjects(selObjs[ii]);
+				}
+			}
+		}
+
+		return selObjs;
+	}
+
+	/**
+	 * Returns the selectable markers, labels and such within a polygon on the screen (a lasso, say).
+	 * Vector features are not included.
+	 * @param region Polygon outline in view coordinates.
+	 */
+	@Nullable
+	public SelectedObject[] getObjectsInScreenRegion(@NotNull Point2d[] region) {
+		final com.mousebird.maply.View theView = view;
+		if (renderWrapper == null || theView == null) {
+			return null;
+		}
+
+		final Point2d[] frameLocs = screenToFrameLocs(region);
+		final ViewState theViewState = theView.makeViewState(renderControl);
+		final SelectedObject[] selObjs = renderControl.selectionManager.pickObjectsInRegion(theViewState,frameLocs);
+		theViewState.dispose();
+
+		if (selObjs != null && selObjs.length > 0) {
+			renderControl.componentManager.remapSelectableObjects(selObjs);
+			return filterMissingObjects(selObjs);
+		}
+
+		return selObjs;
+	}
+
+	// Scale view coordinates to the frame buffer, which is what selection works in
+	private Point2d[] screenToFrameLocs(Point2d[] screenLocs) {
+		final Point2d viewSize = getViewSize();
+		final Point2d frameSize = renderControl.frameSize;
+		final double scaleX = frameSize.getX()/viewSize.getX();
+		final double scaleY = frameSize.getY()/viewSize.getY();
+		final Point2d[] frameLocs = new Point2d[screenLocs.length];
+		for (int ii=0;ii<screenLocs.length;ii++) {
+			frameLocs[ii] = new Point2d(scaleX * screenLocs[ii].getX(),scaleY * screenLocs[ii].getY());
+		}
+		return frameLocs;
+	}
+
 	/**
 	 * Return an array containing all the elements in the provided arrays in the same order.
 	 * Individual arguments may be null or empty.
@@ -2468,6 +2538,62 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 		}
 	}
 
+	/**
+	 * Check whether the layout manager keeps its order and placements between passes
+	 */
+	public boolean getLayoutIncremental() {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				return lm.getIncrementalLayout();
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Keep the layout order and previous placements between layout passes.
+	 * This is much cheaper with lots of labels and markers.  Off by default.
+	 */
+	public void setLayoutIncremental(boolean enable) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.setIncrementalLayout(enable);
+			}
+		}
+	}
+
+	/**
+	 * Choose how the layout manager finds overlapping objects.
+	 * The tree is faster for dense or very large sets of labels and markers.
+	 */
+	public void setLayoutOverlapIndex(LayoutManager.OverlapIndex index) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.setOverlapIndex(index);
+			}
+		}
+	}
+
+	/**
+	 * Pre-cluster large cluster groups on a flat map with a per-zoom index.
+	 * This speeds up clustering with lots of markers.  Off by default.
+	 */
+	public void setLayoutClusterIndex(boolean enable) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.setClusterIndex(enable);
+			}
+		}
+	}
+
 	/**
 	 * This method will add the given MaplyShape derived objects to the current scene.  It will use the parameters in the description dictionary and it will do it on the thread specified.
 	 * @param shapes An array of Shape derived objects
@@ -2633,6 +2759,55 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 		}
 	}
 
+	/**
+	 * Timing for one stage of the label/marker layout since the stats were last cleared.
+	 * Stages are "Layout pass", "Layout rules", "Layout projection", "Layout clustering",
+	 * "Layout along shape" and "Layout drawables".
+	 *
+	 * @return The number of runs and the min, max, and mean time in seconds, or null if there isn't one.
+	 */
+	public double[] getLayoutTiming(String name) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				return lm.getLayoutTiming(name);
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Per-pass object count for the label/marker layout since the stats were last cleared.
+	 * Counts are "Layout objects considered", "Layout objects placed", "Layout objects overlapped",
+	 * "Layout objects over limit", "Layout objects clustered" and "Layout clusters".
+	 *
+	 * @return The number of runs and the min, max, mean and most recent count, or null if there isn't one.
+	 */
+	public double[] getLayoutCount(String name) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				return lm.getLayoutCount(name);
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Start the layout timings and counts over.
+	 */
+	public void clearLayoutStats() {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.clearLayoutStats();
+			}
+		}
+	}
+
 	/**
 	 * True if the renderer was set up as offline.
 	 * Never going to be true for this.
@@ -22,6 +22,7 @@ import android.graphics.Bitmap;
 import android.graphics.Canvas;
 import android.graphics.Color;
 import android.graphics.Paint;
+import android.graphics.Typeface;
 
 import static android.graphics.Paint.*;
 
@@ -61,8 +62,25 @@ class CharRenderer
 			return null;
 		}
 
+		return renderChar(charInt,labelInfo.getTypeface(),fontSize,labelInfo.getTextColor(),
+		                  labelInfo.getOutlineSize(),labelInfo.getOutlineColor());
+	}
+
+	// White with no outline, for glyphs that get turned into distance fields
+	@SuppressWarnings("unused")	// called from C++ code
+	Glyph renderCharPlain(int charInt,LabelInfo labelInfo,float fontSize)
+	{
+		if (labelInfo == null) {
+			return null;
+		}
+
+		return renderChar(charInt,labelInfo.getTypeface(),fontSize,Color.WHITE,0.0f,0);
+	}
+
+	private Glyph renderChar(int charInt,Typeface typeface,float fontSize,int textColor,
+	                         float inOutlineSize,int outlineColor)
+	{
 		final char[] chars = Character.toChars(charInt);
-		final int textColor = labelInfo.getTextColor();
 
 		final int textPaintFlags =
 			Paint.ANTI_ALIAS_FLAG |
@@ -71,7 +89,7 @@ class CharRenderer
 			Paint.SUBPIXEL_TEXT_FLAG;   // glyph advances computed with subpixel accuracy
 
 		Paint textFillPaint = new Paint(textPaintFlags);
-		textFillPaint.setTypeface(labelInfo.getTypeface());
+		textFillPaint.setTypeface(typeface);
 		textFillPaint.setTextSize(fontSize * FontSizeScale);
 		textFillPaint.setColor(textColor);
 		textFillPaint.setAntiAlias(true);
@@ -90,7 +108,7 @@ class CharRenderer
 
 		final float width = widths[0] + fontPadX * 2.0f;
 		final float height = fontHeight + fontPadY * 2.0f;
-		final float outlineSize = labelInfo.getOutlineSize() * FontSizeScale;
+		final float outlineSize = inOutlineSize * FontSizeScale;
 
 		final Bitmap bitmap = Bitmap.createBitmap(
 				(int)Math.ceil(width + 2.0f * outlineSize),
@@ -106,7 +124,7 @@ class CharRenderer
 			final Paint textOutlinePaint = new Paint(textFillPaint);
 			textOutlinePaint.setStyle(Paint.Style.STROKE);
 			textOutlinePaint.setStrokeWidth(2.0f * outlineSize);
-			textOutlinePaint.setColor(labelInfo.getOutlineColor());
+			textOutlinePaint.setColor(outlineColor);
 			textOutlinePaint.setTypeface(textFillPaint.getTypeface());
 			canvas.drawText(chars, 0, 1,
 					fontPadX + outlineSize,
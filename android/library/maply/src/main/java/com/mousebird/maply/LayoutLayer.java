@@ -41,6 +41,9 @@ class LayoutLayer extends Layer implements LayerThread.ViewWatcherInterface
 	{
 		super.startLayer(inLayerThread);
 
+		// Spread the bigger layout passes over the other cores
+		layoutManager.setLayoutThreads(Math.max(1, Runtime.getRuntime().availableProcessors() - 1));
+
 		scheduleUpdate();
 
 		BaseController control = maplyControl.get();
@@ -67,6 +70,7 @@ class LayoutLayer extends Layer implements LayerThread.ViewWatcherInterface
 		cancelUpdate();
 
 		layoutManager.clearClusterGenerators();
+		layoutManager.setLayoutThreads(0);
 	}
 
 	// Called when the view state changes
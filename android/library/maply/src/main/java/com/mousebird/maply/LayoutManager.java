@@ -94,6 +94,72 @@ class LayoutManager
 	public native void setFadeEnabled(boolean enable);
 	public native boolean getFadeEnabled();
 
+	/**
+	 * Keep the layout order and previous placements between layout passes.
+	 * Objects that haven't moved much on screen try their last spot first.
+	 */
+	public native void setIncrementalLayout(boolean enable);
+	public native boolean getIncrementalLayout();
+
+	/**
+	 * Project objects to the screen and work out clusters across this many threads.
+	 * The threads are used only for layout.
+	 *
+	 * @param numThreads Number of threads, or zero to do it all on the layout thread.
+	 */
+	public native void setLayoutThreads(int numThreads);
+
+	/**
+	 * How the layout finds objects that might overlap.
+	 * The tree is faster for dense or very large sets of objects.
+	 */
+	public enum OverlapIndex {Grid,Tree}
+
+	/**
+	 * Choose how the layout finds overlapping objects.  The grid is the default.
+	 */
+	public void setOverlapIndex(OverlapIndex index) {
+		setOverlapIndexNative(index.ordinal());
+	}
+
+	/**
+	 * Return how the layout finds overlapping objects.
+	 */
+	public OverlapIndex getOverlapIndex() {
+		return OverlapIndex.values()[getOverlapIndexNative()];
+	}
+
+	private native void setOverlapIndexNative(int index);
+	private native int getOverlapIndexNative();
+
+	/**
+	 * Pre-cluster large cluster groups on a flat map with a per-zoom index.
+	 * Points very close together go straight into a cluster rather than being checked one by one.
+	 */
+	public native void setClusterIndex(boolean enable);
+	public native boolean getClusterIndex();
+
+	/**
+	 * Timing for one stage of the layout passes since the stats were last cleared,
+	 * such as "Layout pass", "Layout rules" or "Layout clustering".
+	 *
+	 * @return The number of runs and the min, max, and mean time in seconds, or null if it hasn't run.
+	 */
+	public native double[] getLayoutTiming(String name);
+
+	/**
+	 * Per-pass count for the layout passes since the stats were last cleared,
+	 * such as "Layout objects placed" or "Layout objects overlapped".
+	 *
+	 * @return The number of runs and the min, max, mean and most recent count, or null if it hasn't run.
+	 */
+	public native double[] getLayoutCount(String name);
+
+	/**
+	 * Start the layout timings and counts over.
+	 */
+	public native void clearLayoutStats();
+
 	static
 	{
 		nativeInit();
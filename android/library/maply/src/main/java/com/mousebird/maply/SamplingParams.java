@@ -187,6 +187,18 @@ public class SamplingParams
      */
     public native boolean getSingleLevel();
 
+    /**
+     * Number of threads to evaluate tile importance on.
+     * Zero (the default) evaluates everything on the layer thread.
+     * Ignored if the coordinate system isn't thread safe.
+     */
+    public native void setImportanceThreads(int numThreads);
+
+    /**
+     * Number of threads to evaluate tile importance on.
+     */
+    public native int getImportanceThreads();
+
     /**
      * Detail the levels you want loaded in target level mode.
      * The layer calculates the optimal target level.
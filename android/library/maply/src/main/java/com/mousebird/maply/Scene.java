@@ -47,6 +47,17 @@ public class Scene
 	 */
 	public native void copyZoomSlots(Scene otherScene, float offset);
 
+	/**
+	 * Render label glyphs as signed distance fields.
+	 * Each glyph is rendered once per typeface and scaled to whatever size a label
+	 * needs, rather than once per size.  Labels with outlines or custom shaders
+	 * still get regular glyphs.  Set this before adding any labels.
+	 * @param enable Turn distance field glyphs on or off
+	 * @param glyphSize Size the glyphs are rendered at
+	 * @param spread Distance (in pixels at glyphSize) the field extends past the glyph edges
+	 */
+	public native void setSDFGlyphs(boolean enable,float glyphSize,float spread);
+
 	/**
 	 * Tear down the OpenGL resources.  Context needs to be set first.
 	 */
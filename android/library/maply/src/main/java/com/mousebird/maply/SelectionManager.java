@@ -33,6 +33,35 @@ class SelectionManager
 											   Point2d screenLoc,
 											   double maxDist);
 
+	// Look for the objects near each of a set of screen points, all for the same view
+	public SelectedObject[][] pickObjects(ComponentManager compManage,
+										  ViewState view,
+										  Point2d[] screenLocs,
+										  double maxDist) {
+		return pickObjectsAtPoints(compManage, view, flattenPoints(screenLocs), maxDist);
+	}
+
+	// Look for the objects the selection manager is handling within a screen polygon.
+	// Vectors aren't included.
+	public SelectedObject[] pickObjectsInRegion(ViewState view, Point2d[] region) {
+		return pickObjectsInRegionNative(view, flattenPoints(region));
+	}
+
+	private static float[] flattenPoints(Point2d[] pts) {
+		final float[] vals = new float[2*pts.length];
+		for (int ii=0;ii<pts.length;ii++) {
+			vals[2*ii] = (float)pts[ii].getX();
+			vals[2*ii+1] = (float)pts[ii].getY();
+		}
+		return vals;
+	}
+
+	private native SelectedObject[][] pickObjectsAtPoints(ComponentManager compManage,
+														  ViewState view,
+														  float[] screenLocs,
+														  double maxDist);
+	private native SelectedObject[] pickObjectsInRegionNative(ViewState view, float[] region);
+
 	static {
 		nativeInit();
 	}
@@ -55,16 +55,20 @@ friend class BasicDrawableBuilderGLES;
 friend class BasicDrawableBuilderMTL;
     
 public:
-    /// Simple triangle.  Can obviously only have 2^16 vertices
+    /// Simple triangle.  Vertex IDs are kept at full size here and
+    ///  narrowed to 16 bits when the index buffer is built, if they fit.
     class Triangle
     {
     public:
         Triangle() = default;
         /// Construct with vertex IDs
-        Triangle(unsigned short v0,unsigned short v1,unsigned short v2);
-        unsigned short verts[3] = {0};
+        Triangle(uint32_t v0,uint32_t v1,uint32_t v2);
+        uint32_t verts[3] = {0};
     };
 
+    /// Copy triangle vertex IDs into an index buffer of 16 or 32 bit values
+    static void CopyIndices(const std::vector<Triangle> &tris,bool use32Bit,void *dest);
+
     /// Construct empty
     BasicDrawable(const std::string &name);
     virtual ~BasicDrawable();
@@ -113,6 +117,12 @@ public:
     /// Set the active transform matrix
     virtual void setMatrix(const Eigen::Matrix4d *inMat);
     
+    /// True if the index buffer uses 32 bit values rather than 16
+    bool uses32BitIndices() const { return use32BitIndices; }
+
+    /// Size of a single vertex index in the index buffer
+    unsigned int indexSize() const { return use32BitIndices ? 4 : 2; }
+
     /// Check if the force Z buffer on mode is on
     virtual bool getRequestZBuffer() const override;
     virtual void setRequestZBuffer(bool val);
@@ -273,6 +283,8 @@ public:
     // We'll nuke the data arrays when we hand over the data to GL
     unsigned int numPoints = 0;
     unsigned int numTris = 0;
+    // Set by the builder if the vertex IDs won't fit in 16 bits
+    bool use32BitIndices = false;
     RGBAColor color = RGBAColor::white();
     bool hasOverrideColor = false;  // If set, we've changed the default color
     
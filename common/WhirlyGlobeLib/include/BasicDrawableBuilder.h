@@ -181,6 +181,37 @@ public:
     /// Number of triangles added so far
     virtual unsigned int getNumTris() const;
 
+    /// Pick 16 or 32 bit indices, or let the builder decide based on the number of points
+    virtual void setIndexPolicy(DrawableIndexPolicy policy) { indexPolicy = policy; }
+    DrawableIndexPolicy getIndexPolicy() const { return indexPolicy; }
+
+    /// Most points we want in this drawable, given the index policy
+    unsigned int getMaxPoints() const { return MaxDrawablePointsForPolicy(indexPolicy); }
+
+    /// Most triangles we want in this drawable, given the index policy
+    unsigned int getMaxTriangles() const { return MaxDrawableTrianglesForPolicy(indexPolicy); }
+
+    /// True if the drawable will need 32 bit indices for what's been added so far
+    bool needs32BitIndices() const;
+
+    /// A single attribute within an interleaved vertex
+    struct InterleavedAttribute
+    {
+        StringIdentity nameID;
+        BDAttributeDataType type;
+        unsigned int offset;
+    };
+
+    /** Build vertices straight into a single interleaved buffer rather than separate arrays.
+        Each vertex starts with a Point3f position and the attributes follow at the given offsets.
+        This has to be called before any points are added and the other point and attribute
+        calls shouldn't be mixed in after.  InterleavedVertexBuilder is the easy way to use it.
+      */
+    virtual void setupInterleaved(unsigned int vertexSize,const std::vector<InterleavedAttribute> &attrs,unsigned int numReserve = 0);
+
+    /// True if vertices are going into a single interleaved buffer
+    bool isInterleaved() const { return interleavedVertexSize != 0; }
+
     /// Return a given point
     virtual Point3d getPoint(int which) const;
 
@@ -273,6 +304,12 @@ public:
     std::vector<Eigen::Vector3f> points;
     std::vector<BasicDrawable::Triangle> tris;
 
+    // Interleaved vertex data, if we're building it that way
+    std::vector<unsigned char> interleavedVerts;
+    unsigned int interleavedVertexSize = 0;
+    // Offset within an interleaved vertex for each of the vertex attributes, 0 if it's not there
+    std::vector<unsigned int> interleavedOffsets;
+
     // The basic drawable we're building up
     BasicDrawableRef basicDraw;
 
@@ -291,7 +328,16 @@ protected:
 
     void setName(std::string name);
 
+    /// Split interleaved vertices back out into points and attribute arrays,
+    ///  for renderers that want them that way
+    void unpackInterleaved();
+
+    /// Warn (once) and return true if a point or attribute call is mixed in with interleaved vertices
+    bool mixedWithInterleaved(const char *what);
+
     bool includeExp = false;
+    bool warnedInterleaved = false;
+    DrawableIndexPolicy indexPolicy = DrawableIndex16;
 
     ColorExpressionInfoRef colorExp;
     FloatExpressionInfoRef opacityExp;
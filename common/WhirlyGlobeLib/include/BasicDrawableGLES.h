@@ -62,6 +62,9 @@ public:
     /// Size of a single vertex used in creating an interleaved buffer.
     virtual unsigned int singleVertexSize();
 
+    /// Index type for the element buffer, as passed to glDrawElements
+    GLenum glIndexType() const { return use32BitIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT; }
+
     /// Add a single point to the GL Buffer.
     /// Override this to add your own data to interleaved vertex buffers.
     virtual void addPointToBuffer(unsigned char *basePtr,int which,const Point3d *center);
@@ -70,6 +73,8 @@ public:
     // Unprocessed data arrays
     std::vector<Eigen::Vector3f> points;
     std::vector<Triangle> tris;
+    // Vertices that came in already interleaved, in place of points and the attribute arrays
+    std::vector<unsigned char> interleavedVerts;
 
     // Attribute that should be applied to the given program index if using VAOs
     struct VertAttrDefault
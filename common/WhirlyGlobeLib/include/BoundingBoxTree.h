@@ -0,0 +1,130 @@
+/*  BoundingBoxTree.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <vector>
+#import <unordered_map>
+#import "Identifiable.h"
+#import "WhirlyVector.h"
+
+namespace WhirlyKit
+{
+
+/** A dynamic tree of axis aligned 3D boxes, each tagged with an ID.
+    Boxes can be added and removed at any time and the tree keeps itself
+    balanced as it goes.  Queries only descend into the nodes the caller
+    is interested in, so they look at a small part of a big tree.
+    Not thread safe.
+  */
+class BoundingBoxTree
+{
+public:
+    struct Box
+    {
+        Point3d ll,ur;
+    };
+
+    BoundingBoxTree() = default;
+
+    /// Add a box for the given ID, replacing any it already had
+    void addBox(SimpleIdentity boxID,const Box &box);
+
+    /// Remove the box for the given ID.  Returns false if it wasn't there.
+    bool removeBox(SimpleIdentity boxID);
+
+    /// True if there's a box for the given ID
+    bool hasBox(SimpleIdentity boxID) const { return leaves.find(boxID) != leaves.end(); }
+
+    /// Number of boxes in the tree
+    size_t size() const { return leaves.size(); }
+    bool empty() const { return leaves.empty(); }
+
+    /// Remove everything
+    void clear();
+
+    /// Make room for the given number of boxes
+    void reserve(size_t numBoxes);
+
+    /** Walk the tree.  nodeTest is called with the bounds of each node we
+        reach and we only go further if it returns true.  Leaves that pass
+        nodeTest have their ID handed to leafFunc.
+      */
+    template<typename NodeTest,typename LeafFunc>
+    void query(NodeTest &&nodeTest,LeafFunc &&leafFunc) const
+    {
+        if (root < 0)
+        {
+            return;
+        }
+
+        std::vector<int> stack;
+        stack.reserve(64);
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const Node &node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!nodeTest(node.box))
+            {
+                continue;
+            }
+
+            if (node.child0 < 0)
+            {
+                leafFunc(node.boxID);
+            }
+            else
+            {
+                stack.push_back(node.child1);
+                stack.push_back(node.child0);
+            }
+        }
+    }
+
+protected:
+    struct Node
+    {
+        Box box;
+        int parent = -1;
+        // Leaves have no children.  Free nodes are chained through child1.
+        int child0 = -1,child1 = -1;
+        int height = 0;
+        SimpleIdentity boxID = EmptyIdentity;
+    };
+
+    static Box boxUnion(const Box &a,const Box &b);
+    static double boxArea(const Box &box);
+
+    int allocNode();
+    void freeNode(int which);
+
+    // Put a leaf in the cheapest spot we can find
+    void insertLeaf(int leaf);
+    // Take a leaf out and fix up what was above it
+    void removeLeaf(int leaf);
+    // Recalculate bounds and heights from here up to the root
+    void refit(int which);
+    // Rotate the taller child up if the node is lopsided, returns the node now in its place
+    int balance(int which);
+
+    std::vector<Node> nodes;
+    int root = -1;
+    int freeList = -1;
+    std::unordered_map<SimpleIdentity,int> leaves;
+};
+
+}
@@ -19,6 +19,7 @@
 #import <vector>
 #import <set>
 #import <map>
+#import <atomic>
 #import "Identifiable.h"
 #import "StringIndexer.h"
 #import "WhirlyKitView.h"
@@ -80,6 +81,11 @@ public:
     /// Set this if you need to be run before the active models are run
     virtual bool needPreExecute();
 
+    /// Small change requests are recycled through a pool rather than the heap.
+    /// Blocks are 16 byte aligned.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr,size_t size);
+
     /// If non-zero we'll execute this request after the given absolute time
     TimeInterval when = 0.0;
 };
@@ -99,5 +105,91 @@ typedef struct ChangeSorter
 } ChangeSorter;
 /// This version is sorted by when to run it
 typedef std::set<ChangeRequest *,ChangeSorter> SortedChangeSet;
+
+/** Multiple producer, single consumer queue of change requests.
+    Any thread may push changes without taking a lock.  The renderer
+    drains everything queued so far in one go.  Changes pushed by
+    a given thread come back out in the order they were pushed.
+  */
+class ChangeRequestQueue
+{
+public:
+    ChangeRequestQueue() = default;
+    ChangeRequestQueue(const ChangeRequestQueue &) = delete;
+    ChangeRequestQueue &operator = (const ChangeRequestQueue &) = delete;
+    /// Deletes any change requests that were never drained
+    ~ChangeRequestQueue();
+
+    /// Add a single change.  Safe from any thread.
+    void push(ChangeRequest *change);
+    /// Add a batch of changes.  Safe from any thread.
+    void push(const ChangeSet &changes);
+
+    /// Move everything queued so far onto the end of the given change set.
+    /// Only the consumer (the renderer) should call this.
+    /// Returns the number of requests moved.
+    int drain(ChangeSet &changes);
+
+    /// True if nothing has been pushed since the last drain
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    /// Number of requests waiting to be drained
+    int size() const { return count.load(std::memory_order_relaxed); }
+
+protected:
+    struct Node
+    {
+        ChangeRequest *single = nullptr;
+        ChangeSet changes;
+        Node *next = nullptr;
+    };
+
+    void pushNode(Node *node,int num);
+
+    // Most recently pushed batch first
+    std::atomic<Node *> head { nullptr };
+    std::atomic<int> count { 0 };
+};
+
+/** Min-heap of change requests that should run at a given time.
+    This is only touched by the consumer, so it isn't locked.
+  */
+class TimedChangeHeap
+{
+public:
+    TimedChangeHeap() = default;
+    TimedChangeHeap(const TimedChangeHeap &) = delete;
+    TimedChangeHeap &operator = (const TimedChangeHeap &) = delete;
+    /// Deletes any change requests that never ran
+    ~TimedChangeHeap() { clear(); }
+
+    /// Add a change with a non-zero time
+    void push(ChangeRequest *change);
+
+    /// Move the changes that are ready as of the given time onto the end of the change set, earliest first.
+    /// Returns the number moved.
+    int popReady(TimeInterval now,ChangeSet &changes);
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    /// Time of the earliest change, or zero if there isn't one
+    TimeInterval nextTime() const { return heap.empty() ? 0.0 : heap.front()->when; }
+
+    /// Delete all the changes
+    void clear();
+
+protected:
+    // Inverted ordering puts the earliest change at the front of the heap
+    struct Later
+    {
+        bool operator () (const ChangeRequest *a,const ChangeRequest *b) const
+        {
+            return ChangeSorter()(b, a);
+        }
+    };
+
+    std::vector<ChangeRequest *> heap;
+};
     
 }
@@ -18,6 +18,7 @@
 
 #import <memory>
 #import "WhirlyGeometry.h"
+#import "Identifiable.h"
 
 namespace WhirlyKit
 {
@@ -73,6 +74,9 @@ public:
     
     /// Return true if the given coordinate system is the same as the one passed in
     virtual bool isSameAs(const CoordSystem *coordSys) const { return false; }
+
+    /// Return true if conversions can be run from several threads at once
+    virtual bool isThreadSafe() const { return true; }
 };
     
 typedef std::shared_ptr<CoordSystem> CoordSystemRef;
@@ -93,7 +97,8 @@ public:
     CoordSystemDisplayAdapter(CoordSystem *coordSys,Point3d center) :
             coordSys(coordSys),
             center(center),
-            scale(1.0,1.0,1.0)
+            scale(1.0,1.0,1.0),
+            generation(Identifiable::genId())
     {
         assert(coordSys);
     }
@@ -130,7 +135,7 @@ public:
     Point3d getCenter() const { return center; }
     
     /// Set the scale for coordinates going to/from display space
-    void setScale(const Point3d &inScale) { scale = inScale; }
+    void setScale(const Point3d &inScale) { scale = inScale; generation = Identifiable::genId(); }
     
     /// Return the display space scale
     Point3d getScale() const { return scale; }
@@ -153,10 +158,15 @@ public:
     /// Return true if this is a projected coordinate system.
     /// False for others, like geographic.
     virtual bool isFlat() const = 0;
+
+    /// Unique to this adapter and its current scale.
+    /// Use it to key cached display geometry rather than the pointer, which may be reused.
+    SimpleIdentity getGeneration() const { return generation; }
     
 protected:
     Point3d center;
     Point3d scale;
+    SimpleIdentity generation;
     const CoordSystem *coordSys;
 };
 
@@ -381,4 +381,10 @@ protected:
     std::vector<DictionaryEntryCRef> vals;
 };
 
+/// Parse a hex color without the leading '#', as RGB, ARGB, RRGGBB or AARRGGBB
+RGBAColor parseColor(const char* p, RGBAColor defVal);
+
+/// Convert a packed ARGB value to a color
+RGBAColor ARGBtoRGBAColor(uint32_t v);
+
 }
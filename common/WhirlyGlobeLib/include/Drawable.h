@@ -138,8 +138,6 @@ typedef std::shared_ptr<Drawable> DrawableRef;
 class DrawableChangeRequest : public ChangeRequest
 {
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
-
     /// Construct with the ID of the Drawable we'll be changing
     DrawableChangeRequest(SimpleIdentity drawId) : drawId(drawId) { }
     virtual ~DrawableChangeRequest() { }
@@ -164,4 +162,23 @@ static const unsigned int MaxDrawablePoints = ((1<<16)-1);
 /// Maximum number of triangles we want in a drawable
 static const unsigned int MaxDrawableTriangles = (MaxDrawablePoints / 3);
 
+/// How a drawable picks the size of its vertex indices.
+/// 16 bit indices limit a drawable to 64k vertices.  Auto uses 16 bits if
+///  everything fits and 32 bits if it doesn't.
+typedef enum {DrawableIndex16,DrawableIndex32,DrawableIndexAuto} DrawableIndexPolicy;
+
+/// Maximum number of points we want in a drawable with 32 bit indices
+static const unsigned int MaxDrawablePoints32 = (1<<20);
+
+/// Maximum number of triangles we want in a drawable with 32 bit indices
+static const unsigned int MaxDrawableTriangles32 = MaxDrawablePoints32;
+
+/// Maximum number of points for a drawable using the given index policy
+static inline unsigned int MaxDrawablePointsForPolicy(DrawableIndexPolicy policy)
+    { return (policy == DrawableIndex16) ? MaxDrawablePoints : MaxDrawablePoints32; }
+
+/// Maximum number of triangles for a drawable using the given index policy
+static inline unsigned int MaxDrawableTrianglesForPolicy(DrawableIndexPolicy policy)
+    { return (policy == DrawableIndex16) ? MaxDrawableTriangles : MaxDrawableTriangles32; }
+
 }
@@ -29,6 +29,11 @@
 namespace WhirlyKit
 {
 
+/// How a dynamic texture finds room for new pieces.
+/// The grid looks for a block of free cells, the skyline packs pieces along
+///  the top edge of what's already there and reuses what's been released.
+typedef enum {DynamicTextureGrid,DynamicTextureSkyline} DynamicTextureLayout;
+
 /** The dynamic texture can have pieces of itself replaced in the layer thread while
     being used in the renderer.  It's used to implement dynamic texture atlases.
   */
@@ -38,7 +43,7 @@ public:
     /// Constructor for sorting
     DynamicTexture(const std::string &name);
     DynamicTexture(SimpleIdentity myId) : TextureBase(myId), layoutGrid(NULL) { }
-    virtual void setup(int texSize,int cellSize,TextureType type,bool clearTextures);
+    virtual void setup(int texSize,int cellSize,TextureType type,bool clearTextures,DynamicTextureLayout layout=DynamicTextureGrid);
     virtual ~DynamicTexture();
     
     /// Represents a region in the texture
@@ -93,6 +98,25 @@ public:
     void getUtilization(int &numCell,int &usedCell);
     
 protected:
+    /// A run of columns filled up to (but not including) row y, in cells
+    struct SkylineSpan
+    {
+        int x,y,width;
+    };
+
+    // Skyline version of findRegion
+    bool findSkylineRegion(int cellsX,int cellsY,Region &region);
+    // Hand back space below the skyline, merging it with its neighbors
+    void addFreeRegion(Region region);
+    // Drop the skyline if the region is sitting right under it
+    bool lowerSkyline(const Region &region);
+    // Make sure a span starts at the given column and return its index
+    int splitSkyline(int x);
+    // Glue together neighboring spans at the same height
+    void mergeSkyline();
+    // Everything's free again
+    void resetSkyline();
+
     /// Used for debugging
     std::string name;
     
@@ -119,6 +143,14 @@ protected:
 
     /// If set, overwrite texture data with empty pixels
     bool clearTextures;
+
+    DynamicTextureLayout layout = DynamicTextureGrid;
+    /// Skyline layout.  Left to right across the texture.
+    std::vector<SkylineSpan> skyline;
+    /// Skyline layout.  Open space under the skyline, from gaps and releases.
+    std::vector<Region> freeRegions;
+    /// Skyline layout.  Cells currently handed out.
+    int usedCells = 0;
 };
     
 typedef std::shared_ptr<DynamicTexture> DynamicTextureRef;
@@ -197,6 +229,11 @@ public:
     /// Return the dynamic texture's format
     TextureType getFormat();
     
+    /// How the dynamic textures find room for new pieces.  Set this before adding any.
+    /// The skyline packs small pieces (like glyphs) much more tightly and works well with small cells.
+    void setLayout(DynamicTextureLayout inLayout) { layout = inLayout; }
+    DynamicTextureLayout getLayout() const { return layout; }
+
     /// Fudge factor for border pixels.  We'll add this/pixelSize to the lower left
     ///  and subtract this/pixelSize from the upper right for each texture application.
     void setPixelFudgeFactor(float pixFudge);
@@ -231,6 +268,8 @@ public:
     
     /// Get some basic info out
     void getUsage(int &numRegions,int &dynamicTextures);
+    /// This version also returns the cells in use and the total across all the dynamic textures
+    void getUsage(int &numRegions,int &dynamicTextures,int &usedCells,int &numCells);
     
     /// Print out some utilization info
     void log();
@@ -248,6 +287,7 @@ protected:
     int cellSize;
     /// Interpolation type
     float pixelFudge;
+    DynamicTextureLayout layout;
     bool mainThreadMerge;
 
     /// If set, overwrite texture data with empty pixels
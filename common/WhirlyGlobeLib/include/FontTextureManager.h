@@ -19,6 +19,8 @@
 #import <math.h>
 #import <set>
 #import <map>
+#import <list>
+#import <unordered_map>
 #import "Identifiable.h"
 #import "BasicDrawable.h"
 #import "TextureAtlas.h"
@@ -97,6 +99,8 @@ public:
     RGBAColor outlineColor;
     float outlineSize;
     float pointSize;
+    /// Glyphs are distance fields rendered at pointSize, to be scaled to whatever size is needed
+    bool sdf = false;
     
 protected:
     // Maps Glyphs (shorts) to texture and region
@@ -125,8 +129,13 @@ struct DrawableString : public Identifiable
 
     /// Bounding box of the string in coordinates related to the font size
     Mbr mbr;
+
+    /// Glyph textures are distance fields and need a shader that understands that
+    bool sdf = false;
 };
 
+class LabelInfo;
+
 /** Used to manage a dynamic texture set containing glyphs from
     various fonts.
   */
@@ -172,9 +181,64 @@ public:
 
     virtual void teardown(PlatformThreadInfo*) = 0;
 
-protected:    
+    /// Number of laid out strings we keep around for reuse.  Zero turns the cache off.
+    void setStringCacheSize(unsigned int size);
+    unsigned int getStringCacheSize() const { return maxCachedStrings; }
+
+    /** Render glyphs as signed distance fields where we can.
+        Each glyph is rendered once per font at sdfSize and scaled to the size a label
+        wants, instead of once for every size.  The distance runs out to sdfSpread pixels.
+        Only works for labels without outlines that use the default screen space
+        shaders, which are swapped for the distance field versions.
+        Set this before adding any strings.
+      */
+    void setSDFMode(bool enable,float sdfSize=32.0,float sdfSpread=4.0);
+    bool getSDFMode() const { return sdfMode; }
+
+    /// The distance field version of the given screen space program, or EmptyIdentity if there isn't one
+    SimpleIdentity getSDFProgramID(SimpleIdentity programID);
+
+protected:
+    /// The font and glyph behind one glyph rectangle in a cached string
+    struct CachedGlyph
+    {
+        SimpleIdentity fontId;
+        WKGlyph glyph;
+    };
+
+    /// A string we've already laid out, along with the glyphs it used
+    struct CachedString
+    {
+        std::vector<DrawableString::Rect> glyphPolys;
+        std::vector<CachedGlyph> glyphs;
+        Mbr mbr;
+        bool sdf;
+    };
+    typedef std::list<std::pair<std::string,CachedString>> CachedStringList;
+
     void init();
 
+    /** Look for a string laid out earlier with the same key.
+        The key should cover the text and everything that picks the font.
+        If all its glyphs are still in the atlas we add references to them and
+        return a new drawable string, skipping the shaping and glyph lookups.
+        Caller must hold the lock.
+      */
+    std::unique_ptr<DrawableString> findCachedString(const std::string &key);
+
+    /// Remember a string we just laid out.  glyphs run parallel to its glyphPolys.
+    /// Caller must hold the lock.
+    void addCachedString(const std::string &key,const DrawableString &drawStr,std::vector<CachedGlyph> glyphs);
+
+    /// True if the label can use distance field glyphs
+    bool canUseSDF(const LabelInfo &labelInfo);
+
+    /** Turn a rendered glyph into a distance field, using the alpha of the RGBA image.
+        Returns a white RGBA image with the distance in alpha.  It's sdfSpread
+        pixels bigger on each side to leave room for the falloff.
+      */
+    RawData *buildSDFGlyph(const unsigned char *rgba,int width,int height,int rowBytes,int &outWidth,int &outHeight) const;
+
     FontManagerMap fontManagers;
 
     SceneRenderer *sceneRender;
@@ -182,6 +246,15 @@ protected:
     DynamicTextureAtlas *texAtlas;
     DrawStringRepSet drawStringReps;
     std::mutex lock;    
+
+    // Most recently used strings are at the front
+    CachedStringList cachedStrings;
+    std::unordered_map<std::string,CachedStringList::iterator> cachedStringMap;
+    unsigned int maxCachedStrings = 1024;
+
+    bool sdfMode = false;
+    float sdfSize = 32.0;
+    float sdfSpread = 4.0;
 };
     
 typedef std::shared_ptr<FontTextureManager> FontTextureManagerRef;
@@ -0,0 +1,118 @@
+/*  InterleavedVertexBuilder.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <array>
+#import <cstring>
+#import "BasicDrawableBuilder.h"
+
+namespace WhirlyKit
+{
+
+/// Attribute data type for a C++ type we can put in an interleaved vertex
+template<typename T> struct InterleavedAttributeType;
+template<> struct InterleavedAttributeType<Eigen::Vector4f> { static constexpr BDAttributeDataType type = BDFloat4Type; };
+template<> struct InterleavedAttributeType<Eigen::Vector3f> { static constexpr BDAttributeDataType type = BDFloat3Type; };
+template<> struct InterleavedAttributeType<Eigen::Vector2f> { static constexpr BDAttributeDataType type = BDFloat2Type; };
+template<> struct InterleavedAttributeType<RGBAColor>       { static constexpr BDAttributeDataType type = BDChar4Type; };
+template<> struct InterleavedAttributeType<float>           { static constexpr BDAttributeDataType type = BDFloatType; };
+template<> struct InterleavedAttributeType<int>             { static constexpr BDAttributeDataType type = BDIntType; };
+template<> struct InterleavedAttributeType<int64_t>         { static constexpr BDAttributeDataType type = BDInt64Type; };
+template<> struct InterleavedAttributeType<TexCoord> : InterleavedAttributeType<Eigen::Vector2f> { };
+
+/** Writes vertices straight into a basic drawable builder's interleaved buffer.
+    The layout is fixed at compile time: a Point3f position followed by Attrs, in order.
+    Adding a vertex is a handful of copies with no virtual calls or type checks and
+    the GLES renderer uploads the buffer as is.
+
+    InterleavedVertexBuilder<Point3f,RGBAColor> verts(drawable,{a_normalNameID,a_colorNameID},numPts);
+    verts.addVertex(pt,norm,color);
+  */
+template<typename... Attrs>
+class InterleavedVertexBuilder
+{
+public:
+    static constexpr unsigned int NumAttrs = sizeof...(Attrs);
+    static_assert((true && ... && (sizeof(Attrs) % 4 == 0)), "Interleaved attributes should be packed 4 byte values");
+
+    /// Size of a whole vertex, position included
+    static constexpr unsigned int VertexSize = sizeof(Point3f) + (0 + ... + (unsigned int)sizeof(Attrs));
+
+    /// Offsets of the attributes within a vertex
+    static constexpr std::array<unsigned int,NumAttrs> Offsets = []{
+        constexpr unsigned int sizes[] = { (unsigned int)sizeof(Attrs)..., 0 };
+        std::array<unsigned int,NumAttrs> offsets {};
+        unsigned int offset = sizeof(Point3f);
+        for (unsigned int ii=0;ii<NumAttrs;ii++)
+        {
+            offsets[ii] = offset;
+            offset += sizes[ii];
+        }
+        return offsets;
+    }();
+
+    /// Set up the builder for this layout.  nameIDs are the shader attribute names for Attrs, in order.
+    InterleavedVertexBuilder(BasicDrawableBuilder *drawable,const std::array<StringIdentity,NumAttrs> &nameIDs,unsigned int numReserve = 0)
+        : drawable(drawable)
+    {
+        constexpr BDAttributeDataType types[] = { InterleavedAttributeType<Attrs>::type..., BDDataTypeMax };
+        std::vector<BasicDrawableBuilder::InterleavedAttribute> attrs;
+        attrs.reserve(NumAttrs);
+        for (unsigned int ii=0;ii<NumAttrs;ii++)
+            attrs.push_back(BasicDrawableBuilder::InterleavedAttribute { nameIDs[ii], types[ii], Offsets[ii] });
+        drawable->setupInterleaved(VertexSize, attrs, numReserve);
+    }
+
+    /// Add a single vertex and return its index
+    unsigned int addVertex(const Point3f &pt,const Attrs &... attrs)
+    {
+        auto &verts = drawable->interleavedVerts;
+        const size_t start = verts.size();
+        verts.resize(start + VertexSize);
+        write(&verts[start], pt, attrs...);
+        return (unsigned int)(start / VertexSize);
+    }
+
+    /// Add room for a number of vertices to be filled in with setVertex.  Returns the first index.
+    unsigned int addVertices(unsigned int count)
+    {
+        auto &verts = drawable->interleavedVerts;
+        const size_t start = verts.size();
+        verts.resize(start + (size_t)count * VertexSize);
+        return (unsigned int)(start / VertexSize);
+    }
+
+    /// Fill in a vertex that's already been added
+    void setVertex(unsigned int which,const Point3f &pt,const Attrs &... attrs)
+    {
+        write(&drawable->interleavedVerts[(size_t)which * VertexSize], pt, attrs...);
+    }
+
+    /// Number of vertices added so far
+    unsigned int getNumPoints() const { return (unsigned int)(drawable->interleavedVerts.size() / VertexSize); }
+
+protected:
+    static void write(unsigned char *ptr,const Point3f &pt,const Attrs &... attrs)
+    {
+        memcpy(ptr, pt.data(), sizeof(Point3f));
+        ptr += sizeof(Point3f);
+        ((memcpy(ptr, (const void *)&attrs, sizeof(Attrs)), ptr += sizeof(Attrs)), ...);
+    }
+
+    BasicDrawableBuilder *drawable;
+};
+
+}
@@ -0,0 +1,161 @@
+/*  InternedDictionaryC.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <string>
+#import <string_view>
+#import <unordered_map>
+#import <vector>
+#import "Dictionary.h"
+
+namespace WhirlyKit
+{
+
+class MutableDictionaryC;
+typedef std::shared_ptr<MutableDictionaryC> MutableDictionaryCRef;
+
+/// A single string, int, or double value.
+/// Converts to other types the same way MutableDictionaryC does, for
+///  dictionaries that store their values some other way.
+struct DictionaryValueC
+{
+    DictionaryType type = DictTypeNone;
+    int intVal = 0;
+    double doubleVal = 0.0;
+    std::string_view stringVal;
+
+    int getInt(int defVal) const;
+    int64_t getInt64(int64_t defVal) const;
+    SimpleIdentity getIdentity() const;
+    bool getBool(bool defVal) const;
+    RGBAColor getColor(const RGBAColor &defVal) const;
+    double getDouble(double defVal) const;
+    std::string getString(const std::string &defVal) const;
+    /// Make a standalone entry, or null if there's no value
+    DictionaryEntryRef getEntry() const;
+};
+
+/// Keys and values shared by a group of InternedDictionaryC objects.
+/// Typically all the features in one vector tile layer, which repeat
+///  the same keys and many of the same values.
+/// Not thread safe while it's being added to.  Once it's handed out
+///  it should only be read.
+class InternedDictionaryTable
+{
+public:
+    InternedDictionaryTable() = default;
+
+    /// Add a key if it's not already there and return its index
+    uint32_t addKey(std::string_view key);
+
+    /// Add values and return their index.  These aren't checked for duplicates.
+    uint32_t addString(std::string_view val);
+    uint32_t addInt(int val);
+    uint32_t addDouble(double val);
+
+    /// Index of the given key, or -1 if it's not here
+    int findKey(const std::string &key) const;
+
+    const std::string &getKey(uint32_t which) const { return keys[which]; }
+    DictionaryType getValueType(uint32_t which) const { return values[which].type; }
+    DictionaryValueC getValue(uint32_t which) const;
+
+    size_t numKeys() const { return keys.size(); }
+    size_t numValues() const { return values.size(); }
+
+protected:
+    struct Value
+    {
+        DictionaryType type;
+        int intVal;
+        double doubleVal;
+        std::string stringVal;
+    };
+
+    std::vector<std::string> keys;
+    std::unordered_map<std::string,uint32_t> keyMap;
+    std::vector<Value> values;
+};
+typedef std::shared_ptr<InternedDictionaryTable> InternedDictionaryTableRef;
+
+class InternedDictionaryC;
+typedef std::shared_ptr<InternedDictionaryC> InternedDictionaryCRef;
+
+/** A dictionary made of indices into a shared table of keys and values.
+    Lots of these can share one table, so a dictionary is just a small
+    array of key/value indices.
+    Reads look at the table.  The first change copies the contents into
+    a MutableDictionaryC which takes over from then on.
+  */
+class InternedDictionaryC : public MutableDictionary
+{
+public:
+    /// A key index and a value index into the table
+    struct Field
+    {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    /// Fields should have unique keys
+    InternedDictionaryC(InternedDictionaryTableRef table,std::vector<Field> fields);
+    virtual ~InternedDictionaryC() = default;
+
+    /// Make a separate copy of this dictionary.  Unchanged ones share the table.
+    virtual MutableDictionaryRef copy() const override;
+
+    virtual int count() const override;
+    virtual bool empty() const override;
+    virtual bool hasField(const std::string &name) const override;
+    virtual DictionaryType getType(const std::string &name) const override;
+    virtual int getInt(const std::string &name,int defVal=0) const override;
+    virtual int64_t getInt64(const std::string &name,int64_t defVal=0) const override;
+    virtual SimpleIdentity getIdentity(const std::string &name) const override;
+    virtual bool getBool(const std::string &name,bool defVal=false) const override;
+    virtual RGBAColor getColor(const std::string &name,const RGBAColor &defVal) const override;
+    virtual double getDouble(const std::string &name,double defVal=0.0) const override;
+    virtual std::string getString(const std::string &name) const override;
+    virtual std::string getString(const std::string &name,const std::string &defVal) const override;
+    virtual DictionaryRef getDict(const std::string &name) const override;
+    virtual DictionaryEntryRef getEntry(const std::string &name) const override;
+    virtual std::vector<DictionaryEntryRef> getArray(const std::string &name) const override;
+    virtual std::vector<std::string> getKeys() const override;
+
+    virtual void clear() override;
+    virtual void removeField(const std::string &name) override;
+    virtual void setInt(const std::string &name,int val) override;
+    virtual void setInt64(const std::string &name,int64_t val) override;
+    virtual void setIdentifiable(const std::string &name,SimpleIdentity val) override;
+    virtual void setDouble(const std::string &name,double val) override;
+    virtual void setString(const std::string &name,const std::string &val) override;
+    virtual void addEntries(const Dictionary *other) override;
+
+    /// True once the contents have been copied out of the table
+    bool isModified() const { return (bool)dict; }
+
+protected:
+    // Look up a value in the table
+    DictionaryValueC find(const std::string &name) const;
+
+    // Copy everything out of the table for changes
+    MutableDictionaryC &modify();
+
+    InternedDictionaryTableRef table;
+    std::vector<Field> fields;
+    MutableDictionaryCRef dict;
+};
+
+}
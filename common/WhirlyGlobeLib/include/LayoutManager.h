@@ -24,6 +24,8 @@
 #import "SelectionManager.h"
 #import "OverlapHelper.h"
 #import "VectorManager.h"
+#import "ThreadPool.h"
+#import "PerformanceTimer.h"
 
 #import <math.h>
 #import <map>
@@ -133,6 +135,18 @@ struct LayoutObjectEntry : public Identifiable
 
     // Set if we changed something during evaluation
     bool changed = true;
+
+    // Set if it passed the visibility checks on the last pass
+    bool used = false;
+    // Where it landed on the screen and which orientation it got on the last pass.
+    // Used by incremental layout to keep stable objects where they were.
+    Point2f screenPt {MAXFLOAT,MAXFLOAT};
+    int orient = -1;
+
+    // Screen position and rotation for this pass, worked out before placement
+    Point2f projPt {0,0};
+    Eigen::Matrix2d projRot = Eigen::Matrix2d::Identity();
+    bool projInside = false;
 };
 typedef std::shared_ptr<LayoutObjectEntry> LayoutObjectEntryRef;
 typedef std::set<LayoutObjectEntryRef,IdentifiableRefSorter> LayoutEntrySet;
@@ -277,6 +291,9 @@ public:
     /// Return the active objects in a form the selection manager can handle
     void getScreenSpaceObjects(const SelectionManager::PlacementInfo &pInfo,
                                std::vector<ScreenSpaceObjectLocation> &screenSpaceObjs);
+
+    /// Changes whenever the objects getScreenSpaceObjects() would return might have changed
+    int getScreenSpaceGeneration() const { return screenSpaceGeneration.load(std::memory_order_acquire); }
     
     /// Add a generator for cluster images
     void addClusterGenerator(PlatformThreadInfo *,ClusterGenerator *clusterGen);
@@ -298,6 +315,45 @@ public:
         hasUpdates = true;
     }
 
+    /// Keep the sorted layout order and previous placements between passes.
+    /// Objects that haven't moved much on screen try their last placement first,
+    ///  and the order is only rebuilt when objects come, go, or change visibility.
+    void setIncrementalLayout(bool enable);
+    bool getIncrementalLayout() const { return incrementalLayout; }
+
+    /// How far (in pixels) an object can move and still be considered stable for incremental layout
+    void setIncrementalThreshold(float pixels);
+    float getIncrementalThreshold() const { return incrementalThreshold; }
+
+    /// Choose how overlaps are found.  The tree is faster for dense or very large sets of objects.
+    void setOverlapIndex(OverlapHelper::IndexType indexType);
+    OverlapHelper::IndexType getOverlapIndex() const { return overlapIndex; }
+
+    /// Project objects to the screen across the threads in this pool before placing them.
+    /// Placement itself depends on the order and stays on the calling thread.
+    /// Cluster groups are also worked out in parallel.
+    void setLayoutPool(ThreadPoolRef pool);
+
+    /// Pre-cluster large cluster groups on a flat map with a per-zoom index.
+    /// Points closer together than a fraction of the cluster size go straight into a cluster
+    ///  rather than being checked one by one.  The index is kept between passes and rebuilt
+    ///  when the objects in a group change.
+    void setClusterIndex(bool enable);
+    bool getClusterIndex() const { return clusterIndexEnabled; }
+
+    /** Timings and counts for the layout passes since the stats were last cleared (thread safe).
+        Timings: "Layout pass", "Layout rules", "Layout projection", "Layout clustering",
+         "Layout along shape" and "Layout drawables".
+        Counts, one per pass: "Layout objects considered", "Layout objects placed",
+         "Layout objects overlapped", "Layout objects over limit", "Layout objects clustered"
+         and "Layout clusters".
+        As with the renderer, the averages are running totals to be divided by the number of runs.
+      */
+    PerformanceTimer getLayoutStats() const;
+
+    /// Start the layout stats over
+    void clearLayoutStats();
+
     /// Don't run a layout pass until at least the specified absolute time
     /// (e.g., when scheduled animations complete)
     void deferUntil(TimeInterval minTime);
@@ -364,6 +420,13 @@ protected:
 
     typedef std::set<ClusteredObjects *,ClusteredObjectsSorter> ClusteredObjectsSet;
 
+    /// Pre-clustering index for one cluster group
+    struct ClusterIndexEntry
+    {
+        size_t signature = 0;
+        ClusterIndexRef index;
+    };
+
     void runLayoutClustering(PlatformThreadInfo *threadInfo,
                              LayoutContainerVec &layoutObjs,
                              ClusteredObjectsSet &clusterGroups,
@@ -430,6 +493,21 @@ protected:
     bool fadeEnabled = false;
     /// Consider the "on" state of the drawables in the scene when checking visibility
     bool checkDrawableOn = true;
+    /// Used for the projection and clustering phases, if set
+    ThreadPoolRef layoutPool;
+    /// Use the pre-clustering index for big cluster groups
+    bool clusterIndexEnabled = false;
+    /// Pre-clustering indices by cluster ID, only touched by the layout
+    std::unordered_map<int,ClusterIndexEntry> clusterIndexes;
+    /// How the overlap helper finds things that are in the way
+    OverlapHelper::IndexType overlapIndex = OverlapHelper::OverlapGridIndex;
+    /// Reuse the layout order and placements from the last pass
+    bool incrementalLayout = false;
+    float incrementalThreshold = 2.0f;
+    /// Bumped whenever the objects, their enables, or the overrides change
+    int layoutGeneration = 0;
+    /// Bumped whenever the visible objects or their placements might have changed
+    std::atomic<int> screenSpaceGeneration { 0 };
     /// Time we'll take to appear/disappear objects
     TimeInterval newObjectFadeIn = 0.2f;
     TimeInterval oldObjectFadeOut = 0.2f;
@@ -449,12 +527,23 @@ protected:
     ClusterGenerator *clusterGen = nullptr;
     /// Features we'll force to always display
     std::unordered_set<std::string> overrideUUIDs;
+    /// Overrides from the previous run
+    std::unordered_set<std::string> prevOverrideUUIDs;
+    /// Generation of the previous run's objects, -1 if they can't be reused
+    int prevLayoutGeneration = -1;
+    /// Sorted objects from the previous run, for incremental layout
+    LayoutContainerVec sortedLayoutObjs;
+    bool sortedLayoutValid = false;
     
     SimpleIDSet debugVecIDs;  // Used to display debug lines for text layout
     SimpleIdentity vecProgID = EmptyIdentity;
 
     // Scene manager lock protects some things, this protects others
     std::timed_mutex internalLock;
+
+    // Stats for the layout passes, with their own lock so they can be read at any time
+    mutable std::mutex statsLock;
+    PerformanceTimer layoutStats;
     
     // Mapping of object unique IDs to drawables from the previous run
     UnorderedIDSetbyUID uniqueDrawableIDs;
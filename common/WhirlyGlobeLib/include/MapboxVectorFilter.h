@@ -21,6 +21,7 @@
 #import "Dictionary.h"
 #import "QuadTreeNew.h"
 #import <string>
+#import <unordered_set>
 
 namespace WhirlyKit
 {
@@ -44,6 +45,7 @@ public:
     MapboxVectorFilter();
     
     /// @brief Parse the filter info out of the style entry
+    /// @details On success the filter tree is also flattened into a list of ops for testFeature
     bool parse(const std::vector<DictionaryEntryRef> &styleEntry,MapboxVectorStyleSetImpl *styleSet);
 
     /// @brief Test a feature's attributes against the filter
@@ -66,6 +68,63 @@ public:
 
     /// @brief For All and Any these are the MapboxVectorFilters to evaluate
     std::vector<MapboxVectorFilterRef> subFilters;
+
+protected:
+    /// Compiled op types.  Anything we don't have a fast path for is Tree.
+    typedef enum {MBOpAll,MBOpAny,MBOpGeomEqual,MBOpGeomNotEqual,MBOpHas,MBOpNotHas,MBOpCompare,MBOpIn,MBOpNotIn,MBOpTree} OpType;
+
+    /// One node of the flattened filter.
+    /// Children of All and Any follow their parent, end points just past the last one.
+    struct Op
+    {
+        OpType type;
+        unsigned int end;
+        /// The filter this came from, for the attribute name and the fallback
+        const MapboxVectorFilter *filter;
+        /// Comparison value, as a number and as a string
+        double num;
+        std::string str;
+        /// Index into valueSets for In and NotIn
+        int valueSet;
+    };
+
+    /// Values for the in and !in operators, split out by type
+    struct ValueSet
+    {
+        std::unordered_set<std::string> strings;
+        std::unordered_set<int> ints;
+        std::vector<double> doubles;
+        std::vector<int64_t> int64s;
+
+        bool hasNumbers() const { return !ints.empty() || !doubles.empty() || !int64s.empty(); }
+        /// Check a feature value against the numeric values
+        bool matchNumber(const DictionaryEntry &featAttrVal) const;
+    };
+
+    /// Things we only want to look up once per feature
+    struct EvalContext
+    {
+        bool haveGeomType = false;
+        int geomType = -1;
+    };
+
+    // Parse without compiling, for the sub-filters
+    bool parseFilter(const std::vector<DictionaryEntryRef> &styleEntry,MapboxVectorStyleSetImpl *styleSet);
+
+    // Evaluate by walking the filter tree
+    bool testTree(const Dictionary &attrs,const QuadTreeIdentifier &tileID) const;
+
+    // Flatten the filter tree into ops
+    void compile();
+    void compileFilter(const MapboxVectorFilter *filter);
+
+    // Evaluate the op at the given index, including its children
+    bool testOp(unsigned int which,const Dictionary &attrs,const QuadTreeIdentifier &tileID,EvalContext &context) const;
+    bool testCompare(const Op &op,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const;
+    bool testIn(const Op &op,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const;
+
+    std::vector<Op> ops;
+    std::vector<ValueSet> valueSets;
 };
 
 }
@@ -21,6 +21,7 @@
 #import "QuadTreeNew.h"
 #import "ImageTile.h"
 #import "ComponentManager.h"
+#import "ThreadPool.h"
 
 namespace WhirlyKit
 {
@@ -113,6 +114,21 @@ public:
     /// Parse everything, even if there's no style for it
     void setParseAll(bool b = true) { parseAll = b; }
 
+    /// Supplies thread info for a pool thread, given the thread info of the caller
+    using ThreadInfoFunction = std::function<PlatformThreadInfo *(PlatformThreadInfo *)>;
+
+    /// Runs a single style build, for platforms that need to set something up around it
+    using TaskWrapperFunction = std::function<void(const std::function<void()> &)>;
+
+    /// Build the styles in parallel on the given pool rather than one after another.
+    /// Each style builds into its own VectorTileData and the results are merged in
+    ///  style order, so the output is the same as the serial version.
+    /// Styles must be safe to build concurrently.  If the platform needs per-thread
+    ///  info, threadInfoFn must supply it for the pool threads.  If set, wrapFn
+    ///  is run around each style build (e.g. to drain an autorelease pool).
+    void setBuildPool(ThreadPoolRef pool,ThreadInfoFunction threadInfoFn = ThreadInfoFunction(),
+                      TaskWrapperFunction wrapFn = TaskWrapperFunction());
+
     /// Add a category for a particulary style ID
     /// These are used for sorting later on
     void addCategory(const std::string &category,long long styleID);
@@ -175,8 +191,21 @@ protected:
     std::string filterName;
     std::set<std::string> filterValues;
 
+    /// Run the styles over the vector objects sorted into the tile data, one after another
+    bool buildStyles(PlatformThreadInfo *styleInst,VectorTileData *tileData,const CancelFunction &cancelFn);
+
+    /// Run the styles over the vector objects sorted into the tile data, on the build pool
+    bool buildStylesParallel(PlatformThreadInfo *styleInst,VectorTileData *tileData,const CancelFunction &cancelFn);
+
+    /// Merge the results from one style into the tile data
+    void mergeStyleData(long long styleID,VectorTileData *tileData,VectorTileData *styleData);
+
     VectorStyleDelegateImplRef styleDelegate;
     std::map<long long,std::string> styleCategories;
+
+    ThreadPoolRef buildPool;
+    ThreadInfoFunction buildThreadInfoFn;
+    TaskWrapperFunction buildWrapFn;
 };
 
 typedef std::shared_ptr<MapboxVectorTileParser> MapboxVectorTileParserRef;
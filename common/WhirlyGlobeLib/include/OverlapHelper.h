@@ -21,6 +21,7 @@
 #import <math.h>
 #import <set>
 #import <map>
+#import <unordered_map>
 #import "Identifiable.h"
 #import "BasicDrawable.h"
 #import "Scene.h"
@@ -28,6 +29,7 @@
 #import "ScreenSpaceBuilder.h"
 #import "SelectionManager.h"
 #import "WhirlyVector.h"
+#import "BoundingBoxTree.h"
 
 
 namespace WhirlyKit
@@ -39,7 +41,12 @@ using LayoutObjectEntryRef = std::shared_ptr<LayoutObjectEntry>;
 // We use this to avoid overlapping labels
 struct OverlapHelper
 {
-    OverlapHelper(const Mbr &mbr,int sizeX,int sizeY,size_t totalObjs);
+    // How we find the objects that might be in the way.
+    // The grid finds candidates by cell and then runs an exact ConvexPolyIntersect on each.
+    // The tree finds them by bounding box and compares oriented boxes, which is exact for rectangles.
+    typedef enum {OverlapGridIndex,OverlapTreeIndex} IndexType;
+
+    OverlapHelper(const Mbr &mbr,int sizeX,int sizeY,size_t totalObjs,IndexType indexType = OverlapGridIndex);
 
     // Try to add an object.  Might fail (kind of the whole point).
     bool addCheckObject(const Point2dVector &pts, const char* mergeID = nullptr);
@@ -60,6 +67,26 @@ protected:
     void addObject(Point2dVector pts, std::string mergeID,
                    int sx, int sy, int ex, int ey);
 
+    // Box around an object, lined up with its first edge
+    struct OrientedBox
+    {
+        Point2d center;
+        Point2d axis0,axis1;
+        double extent0,extent1;
+    };
+
+    static OrientedBox calcOrientedBox(const Point2dVector &pts);
+    static BoundingBoxTree::Box calcTreeBounds(const Point2dVector &pts);
+    static bool boxesOverlap(const OrientedBox &a,const OrientedBox &b);
+    static bool boundsOverlap(const BoundingBoxTree::Box &a,const BoundingBoxTree::Box &b);
+
+    // Merge ID as an index, or -1 if we've never seen it
+    int findMergeID(const char *mergeID) const;
+    int addMergeID(const std::string &mergeID);
+
+    bool treeCheckObject(const OrientedBox &box,const BoundingBoxTree::Box &bounds,int mergeIdx);
+    void treeAddObject(const OrientedBox &box,const BoundingBoxTree::Box &bounds,int mergeIdx);
+
     struct GridCell
     {
         // Indexes into objects vector
@@ -111,6 +138,14 @@ protected:
     std::vector<BoundedObject> objects;
     std::vector<GridCell> grid;
 
+    IndexType indexType;
+
+    // Objects in the tree index and their merge IDs.  Tree IDs are indexes into these.
+    std::vector<OrientedBox> boxes;
+    std::vector<int> boxMergeIDs;
+    std::unordered_map<std::string,int> mergeIDs;
+    BoundingBoxTree tree;
+
     // Estimate the fraction of objects likely to fall in a given cell
     const double overlapHeuristic = 0.1;
 
@@ -128,6 +163,10 @@ public:
     // Add an object, possibly forming a group
     void addObject(LayoutObjectEntryRef objEntry,const Point2dVector &pts);
 
+    // Add a group of objects we already know will cluster together.
+    // Overlaps with everything else are sorted out in resolveClusters.
+    void addCluster(const std::vector<LayoutObjectEntryRef> &objEntries,const std::vector<Point2dVector> &pts);
+
     // Deal with cluster to cluster overlap
     void resolveClusters(volatile bool &cancel);
     
@@ -162,8 +201,8 @@ public:
     // Remove the given index from the cells it covers
     void removeFromCells(const Mbr &objMbr, int index);
     
-    // Return all the objects within the overlap
-    void findObjectsWithin(const Mbr &mbr,std::set<int> &objSet);
+    // Return all the objects within the overlap, sorted and without duplicates
+    void findObjectsWithin(const Mbr &mbr,std::vector<int> &objs);
     
     void calcCells(const Mbr &mbr,int &sx,int &sy,int &ex,int &ey);
 
@@ -173,11 +212,60 @@ public:
     std::vector<SimpleObject> simpleObjects;
     std::vector<ClusterObject> clusterObjects;
 
-    // Grid we're sorting into for fast lookup
+    // Grid we're sorting into for fast lookup.
+    // Each cell is an unordered list of simple (>= 0) and cluster (< 0) indices.
     int sizeX,sizeY;
     float resScale;
     Point2d cellSize;
-    std::vector<std::set<int> > grid;
+    std::vector<std::vector<int> > grid;
+    std::vector<int> foundObjs;
+
+protected:
+    // Set up the box for a cluster around its center and add it to the grid
+    void placeCluster(int clusterID);
+};
+
+/** Pre-clusters points in a flat 2D space at a series of scales, the way supercluster does.
+    Level k merges everything within levelRadius(k) of a seed node from level k-1,
+    the radius doubling each time.  Levels are built the first time they're asked for
+    and kept, so the same index can be used for as long as the points don't change.
+    Not thread safe.
+  */
+class ClusterIndex
+{
+public:
+    ClusterIndex(Point2dVector pts);
+
+    /// Levels we'll build, finest to coarsest
+    static const int MaxLevels = 24;
+
+    /// A group of points
+    struct Node
+    {
+        Point2d center;
+        std::vector<int> points;
+    };
+
+    /// Number of points we were built with
+    size_t numPoints() const { return pts.size(); }
+
+    /// Merge radius for the given level
+    double levelRadius(int level) const { return baseRadius * (double)(1 << level); }
+
+    /// Coarsest level whose radius is no more than the given value, or -1 if they're all bigger
+    int levelForRadius(double radius) const;
+
+    /// The nodes at the given level, building it (and what's below it) if need be
+    const std::vector<Node> &getLevel(int level);
+
+protected:
+    void buildLevel(int level);
+
+    Point2dVector pts;
+    double baseRadius;
+    std::vector<std::vector<Node>> levels;
+    std::vector<bool> levelValid;
 };
+typedef std::shared_ptr<ClusterIndex> ClusterIndexRef;
     
 }
@@ -20,6 +20,7 @@
 
 #import <string>
 #import <map>
+#import <vector>
 #import "WhirlyTypes.h"
 
 namespace WhirlyKit
@@ -52,12 +53,13 @@ public:
     {
         bool operator < (const CountEntry &that) const;
         
-        void addCount(int count);
+        void addCount(int64_t count);
         
-        int minCount = std::numeric_limits<int>::max();
-        int maxCount = 0;
-        int avgCount = 0;
-        int lastCount = 0;
+        int64_t minCount = std::numeric_limits<int64_t>::max();
+        int64_t maxCount = 0;
+        // Running total, divide by numRuns for the mean
+        int64_t avgCount = 0;
+        int64_t lastCount = 0;
     };
     
     /// Start timing the given thing
@@ -66,11 +68,23 @@ public:
     /// Stop timing the given thing and add it to the existing timings
     void stopTiming(const std::string &);
 
+    /// Add a duration that was measured some other way
+    void addTime(const std::string &what,TimeInterval dur);
+
     /// Get a timing entry
     TimeEntry getTiming(const std::string &) const;
 
+    /// All the timing entries, sorted by name
+    std::vector<TimeEntry> getTimings() const;
+
     /// Add a count for a particular instance
-    void addCount(const std::string &what,int count);
+    void addCount(const std::string &what,int64_t count);
+
+    /// Get a count entry
+    CountEntry getCount(const std::string &) const;
+
+    /// All the count entries, sorted by name
+    std::vector<CountEntry> getCounts() const;
     
     /// Print out a string
     void report(const std::string &what);
@@ -52,6 +52,9 @@ public:
     
     /// True if the other system is Spherical Mercator with the same origin
     virtual bool isSameAs(const CoordSystem *coordSys) const override;
+
+    /// Proj.4 transforms share state, so keep them to one thread at a time
+    virtual bool isThreadSafe() const override { return false; }
     
     /// Check that it actually created the pj structures
     bool isValid() const { return pj != nullptr; }
@@ -64,6 +64,15 @@ public:
                                      const Mbr &mbr,
                                      const ViewStateRef &viewState,
                                      const Point2f &frameSize) = 0;
+
+    /// Return importance values for a group of tiles.
+    /// By default this calls importanceForTile() for each one.
+    virtual void importanceForTiles(int numTiles,
+                                    const QuadTreeIdentifier *idents,
+                                    const Mbr *mbrs,
+                                    const ViewStateRef &viewState,
+                                    const Point2f &frameSize,
+                                    double *importances);
     
     /// Called when the view state changes.  If you're caching info, do it here.
     virtual void newViewState(ViewStateRef viewState) = 0;
@@ -177,6 +186,7 @@ public:
 protected:
     // QuadTreeNew overrides
     virtual double importance(const Node &node) override;
+    virtual void batchImportance(int numNodes,const ImportantNode *nodes,double *importances) override;
     virtual bool visible(const Node &node) override;
     
     QuadDataStructure *dataStructure;
@@ -21,6 +21,7 @@
 #import "QuadSamplingParams.h"
 #import "QuadDisplayControllerNew.h"
 #import "QuadTileBuilder.h"
+#import "ScreenImportance.h"
 
 namespace WhirlyKit
 {
@@ -43,6 +44,9 @@ public:
     
     // Return the builder we're using
     QuadTileBuilderRef getBuilder() const { return builder; }
+
+    // Display solids for tile evaluation, shared with other samplers using the same parameters
+    DisplaySolidCacheRef getSolidCache() const { return solidCache; }
     
     // Add a new builder delegate to watch tile related events
     // Returns true if we need to notify the delegate
@@ -89,6 +93,14 @@ public:
                                      const Mbr &mbr,
                                      const ViewStateRef &viewState,
                                      const Point2f &frameSize) override;
+
+    /// Return importance values for a group of tiles, evaluated together
+    virtual void importanceForTiles(int numTiles,
+                                    const QuadTreeIdentifier *idents,
+                                    const Mbr *mbrs,
+                                    const ViewStateRef &viewState,
+                                    const Point2f &frameSize,
+                                    double *importances) override;
     
     /// Called when the view state changes.  If you're caching info, do it here.
     virtual void newViewState(ViewStateRef viewState) override;
@@ -133,6 +145,7 @@ protected:
     
     SamplingParams params;
     QuadDisplayControllerNewRef displayControl;
+    DisplaySolidCacheRef solidCache;
 
     WhirlyKit::Scene *scene = nullptr;
     SceneRenderer *renderer = nullptr;
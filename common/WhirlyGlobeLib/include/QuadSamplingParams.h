@@ -88,6 +88,11 @@ public:
     
     /// Do we need globe geometry for this sampling set or nah?
     bool generateGeom;
+
+    /// Number of threads to evaluate tile importance on.
+    /// Zero (the default) evaluates everything on the layer thread.
+    /// Ignored if the coordinate system isn't thread safe.
+    int importanceThreads;
     
     /**
      Detail the levels you want loaded in target level mode.
@@ -19,6 +19,7 @@
  */
 
 #import "WhirlyVector.h"
+#import "ThreadPool.h"
 #import <set>
 
 namespace WhirlyKit
@@ -127,6 +128,13 @@ public:
     ImportantNodeSet calcCoverageImportance(const std::vector<double> &minImportance,int maxNodes,
                                             bool siblingNodes,std::vector<double> &maxRejectedImport);
     
+    /** Same result as calcCoverageImportance, but evaluated breadth first.
+        Each level is a flat frontier of nodes and only the top of the
+        importance ordering is sorted, rather than building ordered sets.
+      */
+    ImportantNodeSet calcCoverageImportanceFlat(const std::vector<double> &minImportance,int maxNodes,
+                                                bool siblingNodes,std::vector<double> &maxRejectedImport);
+
     /** Calculate the set of nodes to load based on importance.
         First figure out the highest level we could load.
         Try to load all visible tiles at that level.
@@ -142,12 +150,28 @@ public:
 public:
     // Filled in by the subclass
     virtual double importance(const Node &node) = 0;
+    // Importance for a group of nodes.  Calls importance() on each unless you do something smarter.
+    virtual void batchImportance(int numNodes,const ImportantNode *nodes,double *importances);
     virtual bool visible(const Node &node) = 0;
     
     // Recursively visit the quad tree evaluating as we go
     void evalNodeImportance(ImportantNode &node,const std::vector<double> &minImportance,
                             ImportantNodeSet &importSet,std::vector<double> &maxRejectedImport);
 
+    // Evaluate the tree one level at a time, collecting every node that passes its level's importance.
+    // If the frontier reaches splitSize, stop and leave the unevaluated frontier in place.
+    void evalImportanceFrontier(std::vector<ImportantNode> &frontier,const std::vector<double> &minImportance,
+                                std::vector<ImportantNode> &importNodes,std::vector<double> &maxRejectedImport,
+                                size_t splitSize = 0);
+
+    // Evaluate the tree from the min level down, handing subtrees to the importance pool if there is one
+    void evalImportance(const std::vector<double> &minImportance,
+                        std::vector<ImportantNode> &importNodes,std::vector<double> &maxRejectedImport);
+
+    /// Evaluate node importance across the threads in this pool.
+    /// importance() must be safe to call from multiple threads.
+    void setImportancePool(ThreadPoolRef pool) { importancePool = std::move(pool); }
+
     // This version uses pure visibility and goes down to a predefined level
     bool evalNodeVisible(ImportantNode node,const std::vector<double> &minImportance,int maxNodes,
                          const std::set<int> &levelsToLoad,int maxLevel,ImportantNodeSet &visibleSet);
@@ -164,6 +188,8 @@ public:
 
 protected:
     volatile bool shutdown = false;
+
+    ThreadPoolRef importancePool;
 };
 
 }
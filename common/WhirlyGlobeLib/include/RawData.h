@@ -103,6 +103,8 @@ public:
     MutableRawData(void *data,unsigned int size);
     // Allocate the given space
     MutableRawData(unsigned int size);
+    // Take over the given bytes
+    MutableRawData(std::vector<unsigned char> &&inData) : data(std::move(inData)) { }
     virtual ~MutableRawData() = default;
     // Return a pointer to the raw data we're keeping
     virtual const unsigned char *getRawData() const override;
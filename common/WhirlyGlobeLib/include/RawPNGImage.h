@@ -19,10 +19,77 @@
  */
 
 #import <vector>
+#import <memory>
 
 namespace WhirlyKit
 {
 
+/**
+ Decodes PNG data into raw pixels.
+ Gray images come out as one byte per pixel, passed through the value map if there is one.
+ Everything else comes out as 4 byte RGBA.
+ Implementations should be safe to call from multiple threads at once.
+ */
+class RawPNGDecoder
+{
+public:
+    virtual ~RawPNGDecoder() = default;
+
+    /// Read the size and output bytes per pixel from the header.  Returns 0 on success.
+    virtual unsigned int inspect(const unsigned char *data,size_t length,
+                                 unsigned int &width,unsigned int &height,int &byteWidth) = 0;
+
+    /// Decode into dest, which must hold width*height*byteWidth bytes as reported by inspect().
+    /// Entries in the value map that are negative leave those values alone.
+    /// Returns 0 on success.
+    virtual unsigned int decode(const unsigned char *data,size_t length,
+                                const std::vector<int> &valueMap,
+                                unsigned char *dest) = 0;
+};
+typedef std::shared_ptr<RawPNGDecoder> RawPNGDecoderRef;
+
+/// Decodes with lodepng, which handles every PNG variant
+class LodePNGDecoder : public RawPNGDecoder
+{
+public:
+    virtual unsigned int inspect(const unsigned char *data,size_t length,
+                                 unsigned int &width,unsigned int &height,int &byteWidth) override;
+    virtual unsigned int decode(const unsigned char *data,size_t length,
+                                const std::vector<int> &valueMap,
+                                unsigned char *dest) override;
+};
+
+/**
+ Decodes a row at a time with zlib straight into the destination,
+ applying the value map as it goes.
+ Handles 8 and 16 bit gray, gray/alpha, RGB, and RGBA images that aren't interlaced.
+ Anything else (or anything it can't make sense of) goes to lodepng.
+ */
+class StreamingPNGDecoder : public RawPNGDecoder
+{
+public:
+    StreamingPNGDecoder();
+
+    virtual unsigned int inspect(const unsigned char *data,size_t length,
+                                 unsigned int &width,unsigned int &height,int &byteWidth) override;
+    virtual unsigned int decode(const unsigned char *data,size_t length,
+                                const std::vector<int> &valueMap,
+                                unsigned char *dest) override;
+
+protected:
+    // Returns false if this isn't a PNG we handle
+    bool decodeStreaming(const unsigned char *data,size_t length,
+                         const std::vector<int> &valueMap,
+                         unsigned char *dest);
+
+    RawPNGDecoderRef fallback;
+};
+
+/// Set the decoder used by RawPNGImageLoaderInterpreter.  Passing null restores the default.
+extern void SetRawPNGDecoder(RawPNGDecoderRef decoder);
+/// Decoder used by RawPNGImageLoaderInterpreter
+extern RawPNGDecoderRef GetRawPNGDecoder();
+
 /**
  Pulls the raw data out of a PNG image.
  Returns NULL on failure, check the err value.
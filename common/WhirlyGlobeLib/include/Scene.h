@@ -267,7 +267,7 @@ public:
     /// You can get the coordinate system we're using from that.
     CoordSystemDisplayAdapter *getCoordAdapter() const;
     
-    /// Add a single change request.  You can call this from any thread, it locks.
+    /// Add a single change request.  You can call this from any thread, it doesn't lock.
     /// If you have more than one, don't iterate, use the other version.
     void addChangeRequest(ChangeRequest *newChange);
     /// Add a list of change requets.  You can call this from any thread.
@@ -440,6 +440,9 @@ public:
 protected:
     /// Don't be calling this
     void setDisplayAdapter(CoordSystemDisplayAdapter *newCoordAdapter);
+
+    /// Move queued change requests into the immediate or timed lists.  Render thread only.
+    void drainChangeRequests();
     
     /// Passed around to setup and teardown renderer assets
     const RenderSetupInfo *setupInfo;
@@ -463,11 +466,16 @@ protected:
     /// Mutex for accessing textures
     mutable std::mutex textureLock;
 
-    mutable std::mutex changeRequestLock;
-    /// We keep a list of change requests to execute
-    /// This can be accessed in multiple threads, so we lock it
+    /// Change requests from any thread land here without locking
+    ChangeRequestQueue pendingChangeRequests;
+    /// Change requests drained from the queue, waiting to execute.  Render thread only.
     ChangeSet changeRequests;
-    SortedChangeSet timedChangeRequests;
+    /// Number of entries in changeRequests, for other threads
+    std::atomic<int> numChangeRequests { 0 };
+    /// Change requests waiting on a specific time.  Render thread only.
+    TimedChangeHeap timedChangeRequests;
+    /// Earliest time in timedChangeRequests (or 0), for other threads
+    std::atomic<TimeInterval> nextTimedChange { 0.0 };
 
         mutable std::mutex subTexLock;
     typedef std::set<SubTexture> SubTextureSet;
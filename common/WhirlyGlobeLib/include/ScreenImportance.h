@@ -27,6 +27,8 @@
 #import "GlobeMath.h"
 #import "QuadTreeNew.h"
 #import "SceneRenderer.h"
+#import <list>
+#import <unordered_map>
 
 
 namespace WhirlyKit
@@ -72,6 +74,84 @@ public:
     
 typedef std::shared_ptr<DisplaySolid> DisplaySolidRef;
 
+/** Least recently used cache of display solids.
+    Building a display solid means running the tile corners through the coordinate
+    system and display adapter, which adds up when several layers sample the same tiles.
+    A cache is tied to one source coordinate system.  Entries are keyed by tile
+    and display adapter and are rebuilt if the tile bounds change.
+    Safe to use from multiple threads.
+  */
+class DisplaySolidCache
+{
+public:
+    DisplaySolidCache(CoordSystemRef coordSys,size_t maxEntries = 4096);
+
+    /// The source coordinate system solids are built in
+    const CoordSystemRef &getCoordSystem() const { return coordSys; }
+
+    /// Return the display solid for a tile, building it if need be
+    DisplaySolidRef getSolid(const QuadTreeIdentifier &ident,const Mbr &mbr,CoordSystemDisplayAdapter *coordAdapter);
+
+    /// Fill in display solids for a group of tiles, building the ones we don't have
+    void getSolids(int numTiles,const QuadTreeIdentifier *idents,const Mbr *mbrs,
+                   CoordSystemDisplayAdapter *coordAdapter,DisplaySolidRef *solids);
+
+    /// Number of entries currently cached
+    size_t size() const;
+
+    /// Lookups that found a usable solid
+    size_t getNumHits() const;
+
+    /// Lookups that had to build a solid
+    size_t getNumMisses() const;
+
+    /// Clear out the entries, but not the counters
+    void clear();
+
+protected:
+    struct Key
+    {
+        int x,y,level;
+        // Adapter generation rather than the pointer, which can be reused after teardown
+        SimpleIdentity adapterGen;
+        bool operator == (const Key &that) const
+        {
+            return x == that.x && y == that.y && level == that.level && adapterGen == that.adapterGen;
+        }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const
+        {
+            return std::hash<int64_t>()(QuadTreeIdentifier::NodeNumber(key.x,key.y,key.level)) ^
+                   std::hash<SimpleIdentity>()(key.adapterGen);
+        }
+    };
+    struct Entry
+    {
+        Key key;
+        Mbr mbr;
+        DisplaySolidRef solid;
+    };
+    typedef std::list<Entry> EntryList;
+
+    // Look for a solid, moving it to the front if found.  Lock must be held.
+    DisplaySolidRef findLocked(const Key &key,const Mbr &mbr);
+    // Add or replace a solid and trim the list.  Lock must be held.
+    void addLocked(const Key &key,const Mbr &mbr,const DisplaySolidRef &solid);
+
+    CoordSystemRef coordSys;
+    size_t maxEntries;
+
+    mutable std::mutex lock;
+    // Most recently used at the front
+    EntryList entries;
+    std::unordered_map<Key,EntryList::iterator,KeyHash> entryMap;
+    size_t numHits = 0;
+    size_t numMisses = 0;
+};
+typedef std::shared_ptr<DisplaySolidCache> DisplaySolidCacheRef;
+
 /// Check if any part of the given tile is on screen
 bool TileIsOnScreen(WhirlyKit::ViewState *viewState,const WhirlyKit::Point2f &frameSize,WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,const WhirlyKit::Mbr &nodeMbr,const QuadTreeIdentifier &nodeIdent,DisplaySolidRef &dispSold);
 
@@ -81,6 +161,19 @@ double ScreenImportance(WhirlyKit::ViewState *viewState,const WhirlyKit::Point2f
 /// This one is for reusing the <c>DisplaySolid</c>
 double ScreenImportance(WhirlyKit::ViewState *viewState,const WhirlyKit::Point2f &frameSize,const Point3d &notUsed, int pixelsSqare,WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,const WhirlyKit::Mbr &nodeMbr, const QuadTreeIdentifier &nodeIdent,DisplaySolidRef &dispSold);
 
+/** Calculate importance for a batch of tiles at once.
+    Matches ScreenImportance() for each tile to within about 1e-5, but the projection
+    is shared across the batch.  Points are transformed in float relative to their polygon,
+    which keeps precision at high zoom levels and lets the compiler vectorize.
+    Polygons entirely on screen are measured straight from those, polygons entirely
+    off screen are skipped and only the ones in between go through the general clipping.
+    dispSolids is optional.  If present, entries are used if set and filled in if not.
+  */
+void ScreenImportanceBatch(WhirlyKit::ViewState *viewState,const WhirlyKit::Point2f &frameSize,int pixelsSquare,
+                           WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,
+                           int numTiles,const WhirlyKit::Mbr *nodeMbrs,const QuadTreeIdentifier *nodeIdents,
+                           DisplaySolidRef *dispSolids,double *importances);
+
 /// Utility function to calculate importance based on pixel screen size.
 /// This version takes a min/max height and is optimized for volumes.
 double ScreenImportance(WhirlyKit::ViewState *viewState,const WhirlyKit::Point2f &frameSize,int pixelsSquare,WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,const WhirlyKit::Mbr &nodeMbr, double minZ,double maxZ, const QuadTreeIdentifier &nodeIdent,DisplaySolidRef &dispSold);
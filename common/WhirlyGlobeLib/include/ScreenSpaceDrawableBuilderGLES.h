@@ -33,6 +33,9 @@ ProgramGLES *BuildScreenSpaceProgramGLES(const std::string &name,SceneRenderer *
 ProgramGLES *BuildScreenSpaceMotionProgramGLES(const std::string &name,SceneRenderer *render);
 ProgramGLES *BuildScreenSpace2DProgramGLES(const std::string &name,SceneRenderer *render);
 ProgramGLES *BuildScreenSpaceMotion2DProgramGLES(const std::string &name,SceneRenderer *render);
+/// These versions treat the texture alpha as a signed distance field (for glyphs)
+ProgramGLES *BuildScreenSpaceSDFProgramGLES(const std::string &name,SceneRenderer *render);
+ProgramGLES *BuildScreenSpaceSDFMotionProgramGLES(const std::string &name,SceneRenderer *render);
     
 /// The OpenGL version sets uniforms
 struct ScreenSpaceTweakerGLES : public ScreenSpaceTweaker
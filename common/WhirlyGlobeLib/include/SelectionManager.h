@@ -27,6 +27,7 @@
 #import "Scene.h"
 #import "ScreenSpaceBuilder.h"
 #import "VectorObject.h"
+#import "BoundingBoxTree.h"
 
 namespace WhirlyKit
 {
@@ -195,7 +196,10 @@ typedef std::set<WhirlyKit::BillboardSelectable> BillboardSelectableSet;
      when the caller uses pickObject.
  
     All objects are currently being projected to the 2D screen and
-     evaluated for distance there.
+     evaluated for distance there.  The 3D rectangles, polytopes, and
+     linears are kept in bounding box trees so a pick only projects the
+     ones that might be near the touch point.  Screen space objects are
+     projected once per view and looked up in a grid after that.
  
     The selection manager is entirely thread safe except for destruction.
  */
@@ -305,6 +309,21 @@ public:
     /// Find all the objects within a given distance and return them, sorted by distance
     void pickObjects(const Point2f &touchPt,float maxDist,
                      const ViewStateRef &viewState,std::vector<SelectedObject> &selObjs);
+
+    /// Pick at a whole set of points for the same view, as for multi-touch or hover.
+    /// The view and screen space objects are only worked out once.
+    /// Each point gets its own list of objects, sorted by distance.
+    void pickObjects(const Point2fVector &touchPts,float maxDist,const ViewStateRef &viewState,
+                     std::vector<std::vector<SelectedObject>> &selObjs);
+
+    /// Find all the objects that overlap the given screen polygon (a lasso, say)
+    ///  and return them sorted by distance from the eye
+    void pickObjectsInRegion(const Point2fVector &region,const ViewStateRef &viewState,
+                             std::vector<SelectedObject> &selObjs);
+
+    /// Find all the objects that overlap the given screen rectangle
+    void pickObjectsInRegion(const Mbr &region,const ViewStateRef &viewState,
+                             std::vector<SelectedObject> &selObjs);
     
     // Everything we need to project a world coordinate to one or more screen locations
     class PlacementInfo
@@ -327,6 +346,29 @@ public:
     };
 
 protected:
+    // Everything about a view we need to answer picks, worked out once
+    struct PickContext
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
+        PickContext(const ViewStateRef &viewState,SceneRenderer *renderer,TimeInterval now);
+
+        /// False if we can't pick in this kind of view
+        bool isValid() const { return pInfo.globeViewState || pInfo.mapViewState; }
+
+        PlacementInfo pInfo;
+        TimeInterval now;
+        Eigen::Matrix4d modelTrans;
+        Eigen::Matrix4d normalMat;
+        Eigen::Vector3d eyeVec;
+        Point3d eyePos;
+        Point2f frameBufferSize;
+
+        /// Moving screen space objects and their screen polygons at this time
+        std::vector<ScreenSpaceObjectLocation> movingObjs;
+        std::vector<std::vector<Point2fVector>> movingPolys;
+    };
+
     static Eigen::Matrix2d calcScreenRot(float &screenRot,
                                          const ViewStateRef &viewState,
                                          const WhirlyGlobe::GlobeViewState *globeViewState,
@@ -340,7 +382,38 @@ protected:
     static void projectWorldPointToScreen(const Point3d &worldLoc,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale);
 
     // Convert rect selectables into more generic screen space objects
-    void getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenObjs,TimeInterval now);
+    void getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenObjs);
+
+    // Convert the moving rect selectables into screen space objects for the given time
+    void getMovingScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenObjs,TimeInterval now);
+
+    // Screen polygons for each place a screen space object shows up
+    void calcScreenPolys(const ScreenSpaceObjectLocation &screenObj,const PlacementInfo &pInfo,
+                         const Eigen::Matrix4d &modelTrans,const Eigen::Matrix4d &normalMat,
+                         const Point2f &frameBufferSize,std::vector<Point2fVector> &polys);
+
+    // Project the static screen space objects for this view, unless we already have
+    void updateScreenObjectCache(const PlacementInfo &pInfo,const Eigen::Matrix4d &modelTrans,
+                                 const Eigen::Matrix4d &normalMat,const Point2f &frameBufferSize,
+                                 int layoutGeneration);
+
+    // Indices of the cached screen space objects that might overlap the screen area, in order
+    void findScreenObjects(const Mbr &searchMbr,std::vector<int> &which) const;
+
+    // Project the screen space objects for picking.  Call with the lock held.
+    void setupPick(PickContext &ctx);
+
+    // Point pick within an already set up context
+    void pickObjects(const PickContext &ctx,const Point2f &touchPt,float maxDist,
+                     bool multi,std::vector<SelectedObject> &selObjs);
+
+    // Region pick within an already set up context
+    void pickObjectsInRegion(const PickContext &ctx,const Point2fVector &region,
+                             std::vector<SelectedObject> &selObjs);
+
+    // Add the selected objects for a screen space object
+    void addScreenObjSelected(const ScreenSpaceObjectLocation &screenObj,double screenDist,
+                              std::vector<SelectedObject> &selObjs) const;
 
     // Internal object picking method
     void pickObjects(const Point2f &touchPt,float maxDist,const ViewStateRef &viewState,
@@ -355,6 +428,37 @@ protected:
     WhirlyKit::MovingPolytopeSelectableSet movingPolytopeSelectables;
     WhirlyKit::LinearSelectableSet linearSelectables;
     WhirlyKit::BillboardSelectableSet billboardSelectables;
+
+    /// Bounds of the enabled selectables of each kind, by ID
+    BoundingBoxTree rect3DTree;
+    BoundingBoxTree polytopeTree;
+    BoundingBoxTree linearTree;
+
+    /// Bumped when the screen space rectangles change
+    int screenRectGeneration = 0;
+
+    /// Static screen space objects projected for a particular view
+    struct ScreenObjectCache
+    {
+        ViewStateRef viewState;
+        Point2f frameSize = { 0.0f, 0.0f };
+        float scale = 0.0f;
+        int rectGeneration = -1;
+        int layoutGeneration = -1;
+
+        /// Our own rectangles come first, then the layout manager's objects
+        std::vector<ScreenSpaceObjectLocation> objs;
+        int numRectObjs = 0;
+        /// Screen polygons for each object
+        std::vector<std::vector<Point2fVector>> polys;
+
+        /// Objects sorted into cells by their screen bounds
+        Mbr gridMbr;
+        int gridSizeX = 0, gridSizeY = 0;
+        Point2f cellSize = { 0.0f, 0.0f };
+        std::vector<std::vector<int>> grid;
+    };
+    ScreenObjectCache screenObjCache;
 };
 typedef std::shared_ptr<SelectionManager> SelectionManagerRef;
  
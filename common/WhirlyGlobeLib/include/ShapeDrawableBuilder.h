@@ -21,6 +21,7 @@
 #import "BaseInfo.h"
 #import "BasicDrawable.h"
 #import "BasicDrawableBuilder.h"
+#import "InterleavedVertexBuilder.h"
 #import "SceneRenderer.h"
 
 namespace WhirlyKit
@@ -134,11 +135,17 @@ public:
     // Creates a new local drawable with all the appropriate settings
     void setupNewDrawable();
 
+    // Add a vertex to the current drawable, the texture coordinate is dropped if it isn't textured
+    unsigned int addVertex(const Point3f &pt,const Point3f &norm,RGBAColor color,const TexCoord &texCoord = TexCoord(0.0,0.0));
+
     CoordSystemDisplayAdapter *coordAdapter;    
     SceneRenderer *sceneRender;
     Mbr drawMbr;
     const ShapeInfo &shapeInfo;
     BasicDrawableBuilderRef drawable;
+    // Writes interleaved vertices into the current drawable, only one of these is set up at a time
+    std::unique_ptr<InterleavedVertexBuilder<Point3f,RGBAColor>> verts;
+    std::unique_ptr<InterleavedVertexBuilder<Point3f,RGBAColor,TexCoord>> texVerts;
     std::vector<BasicDrawableBuilderRef> drawables;
     std::vector<SimpleIdentity> texIDs;
     Point3d center;
@@ -117,6 +117,8 @@
 #define MaplyScreenSpaceDefaultShader WKString("Default Screenspace")
 #define MaplyScreenSpaceMaskShader WKString("Screenspace mask")
 #define MaplyScreenSpaceExpShader WKString("Screenspace with expressions")
+#define MaplyScreenSpaceSDFShader WKString("Screenspace distance field")
+#define MaplyScreenSpaceSDFMotionShader WKString("Screenspace distance field Motion")
 
 #define MaplyParticleSystemPointDefaultShader WKString("Default Part Sys (Point)")
 
@@ -0,0 +1,34 @@
+/*  SignedDistanceField.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <vector>
+
+namespace WhirlyKit
+{
+
+/** Build a signed distance field from an antialiased coverage image (like a rendered glyph).
+    The coverage values are read every pixelStride bytes along a row and rowStride bytes
+    between rows, so you can point this at the alpha channel of an RGBA image.
+    The output is width x height single byte values.  The edge is at 128 and distances
+    out to spread pixels on either side run from 255 (inside) down to 0 (outside).
+    Add a border of at least spread pixels to the input if you want the whole falloff.
+  */
+void BuildSignedDistanceField(const unsigned char *coverage,int width,int height,
+                              int pixelStride,int rowStride,float spread,
+                              std::vector<unsigned char> &distField);
+
+}
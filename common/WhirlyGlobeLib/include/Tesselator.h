@@ -25,14 +25,20 @@
 namespace WhirlyKit
 {
 
+/// How to tesselate polygons.
+/// Ear clipping is much faster for the simple polygons (with holes) we mostly see.
+/// libtess handles anything, including self-intersecting loops.
+/// Auto ear clips, checks the result, and falls back to libtess if it doesn't cover the polygon.
+typedef enum {TesselateAuto,TesselateEarClip,TesselateLibTess} TesselateMethod;
+
 /** Tesselate the given ring, returning a list of triangles.
     This is a fairly simple tesselator. */
-void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris);
+void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris,TesselateMethod method = TesselateAuto);
 
 /** Tesselate the given areal feature.  The first ring is the outer,
     all others are meant to be holes.
   */
-void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
+void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris,TesselateMethod method = TesselateAuto);
 
 
 }
@@ -89,6 +89,10 @@ public:
 	    
     /// Process the data for display based on the format.
     RawDataRef processData();
+
+    /// Process the data for display, converting into the given buffer rather than a new allocation.
+    /// The result may point into the buffer, so it's only good until the buffer is reused.
+    RawDataRef processData(std::vector<unsigned char> &buffer);
     
     /// Set up from raw PKM (ETC2/EAC) data
     void setPKMData(RawDataRef data);
@@ -146,4 +150,17 @@ extern RawDataRef ConvertAToA(const RawDataRef &inData,int width,int height);
 extern RawDataRef ConvertRGToRG(const RawDataRef &inData,int width,int height);
 extern RawDataRef ConvertRGBATo8(const RawDataRef &inData,WKSingleByteSource source);
 
+// Versions of the above that convert into a buffer the caller can reuse.
+// The buffer is resized to fit, and these always convert even if the data is already aligned.
+extern void ConvertRGBATo16(const RawData &inData,int width,int height,bool pad,std::vector<unsigned char> &outData);
+extern void ConvertRGBATo565(const RawData &inData,std::vector<unsigned char> &outData);
+extern void ConvertRGBATo4444(const RawData &inData,std::vector<unsigned char> &outData);
+extern void ConvertRGBATo5551(const RawData &inData,std::vector<unsigned char> &outData);
+extern void ConvertAToA(const RawData &inData,int width,int height,std::vector<unsigned char> &outData);
+extern void ConvertRGToRG(const RawData &inData,int width,int height,std::vector<unsigned char> &outData);
+extern void ConvertRGBATo8(const RawData &inData,WKSingleByteSource source,std::vector<unsigned char> &outData);
+
+// Free a reused conversion buffer if a big texture blew it up past what's worth keeping
+extern void TrimConvertBuffer(std::vector<unsigned char> &buffer);
+
 }
@@ -0,0 +1,123 @@
+/*  ThreadPool.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <vector>
+#import <deque>
+#import <thread>
+#import <mutex>
+#import <condition_variable>
+#import <atomic>
+#import <functional>
+#import <memory>
+
+namespace WhirlyKit
+{
+
+class ThreadPool;
+typedef std::shared_ptr<ThreadPool> ThreadPoolRef;
+
+/** Work stealing thread pool.
+    Each worker keeps its own queue of tasks and steals from the others
+    when it runs dry.  Tasks are grouped so the caller can wait on a
+    batch of work.  A thread waiting on a group runs that group's queued
+    tasks itself, so tasks may start and wait on groups of their own.
+    It never picks up anyone else's work while it waits.
+  */
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /// Keeps track of a batch of tasks so we can wait for them
+    class Group
+    {
+    public:
+        Group() = default;
+        Group(const Group &) = delete;
+        Group &operator = (const Group &) = delete;
+
+    protected:
+        friend class ThreadPool;
+        // Tasks not finished yet
+        std::atomic<int> pending { 0 };
+        // Tasks still sitting in a queue
+        std::atomic<int> queued { 0 };
+    };
+
+    /// Start up the given number of worker threads
+    ThreadPool(int numThreads);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator = (const ThreadPool &) = delete;
+    /// Finishes outstanding tasks and shuts down the workers
+    ~ThreadPool();
+
+    /// Number of worker threads
+    int getNumThreads() const { return (int)workers.size(); }
+
+    /// Queue a task as part of the given group
+    void run(Group &group,Task task);
+
+    /// Wait for all the tasks in the group to finish, running the group's tasks in the meantime
+    void wait(Group &group);
+
+    /// Run func(ii) for every ii in [begin,end) and wait for them all.
+    /// The range is split into chunks of at least minChunk.
+    void parallelFor(int begin,int end,int minChunk,const std::function<void(int)> &func);
+
+    /// Return a pool with the given number of threads that can be shared by anyone else asking for the same size
+    static ThreadPoolRef sharedPool(int numThreads);
+
+protected:
+    struct QueuedTask
+    {
+        Task task;
+        Group *group;
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<QueuedTask> tasks;
+        std::thread thread;
+    };
+
+    // Main loop for a worker
+    void workerMain(int which);
+
+    // Find and run one task, if there is one.  which is the worker index, or -1 if not a worker.
+    // If group is set, only tasks from that group will do.
+    bool runOne(int which,const Group *group);
+
+    // Pull a task from our own queue (back) or someone else's (front)
+    bool takeTask(int which,const Group *group,QueuedTask &task);
+
+    // Take the newest (or oldest) task in the queue that's part of the group, or any task if there's no group
+    static bool takeFromQueue(std::deque<QueuedTask> &tasks,const Group *group,bool newest,QueuedTask &task);
+
+    // Index of the worker the current thread is, or -1
+    int workerIndex() const;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned> nextWorker { 0 };
+    std::atomic<int> numQueued { 0 };
+
+    std::mutex sleepLock;
+    std::condition_variable sleepCond;
+    bool shutdown = false;
+};
+
+}
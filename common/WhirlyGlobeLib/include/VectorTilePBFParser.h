@@ -9,6 +9,8 @@
 #ifndef VectorTilePBFParser_h
 #define VectorTilePBFParser_h
 
+#include <Dictionary.h>
+#include <InternedDictionaryC.h>
 #include <Identifiable.h>
 #include <VectorData.h>
 #include <WhirlyVector.h>
@@ -31,13 +33,11 @@ typedef struct _vector_tile_Tile_Value vector_tile_Tile_Value;
 namespace WhirlyKit
 {
 
-class MutableDictionaryC;
 class PlatformThreadInfo;
 class VectorTileData;
 class VectorStyleDelegateImpl;
 class VectorObject;
 
-typedef std::shared_ptr<MutableDictionaryC> MutableDictionaryCRef;
 typedef std::shared_ptr<VectorObject> VectorObjectRef;
 
 class VectorTilePBFParser
@@ -57,8 +57,15 @@ public:
         std::vector<VectorObjectRef>* keepVectors = nullptr,
         CancelFunction isCancelled = [](auto){return false;});
 
+    /// Parse the tile.  The data must stay valid until this returns.
     bool parse(const uint8_t* data, size_t length);
 
+    /// In zero-copy mode (the default) feature tags and geometry are left packed in the tile
+    /// data and style filters run directly against it.  Attributes and geometry are only
+    /// built for features a style accepts.  Turn it off to build attributes up front.
+    void setZeroCopy(bool inZeroCopy) { _zeroCopy = inZeroCopy; }
+    bool getZeroCopy() const { return _zeroCopy; }
+
     unsigned getLayerCount() const { return _layerCount; }
     unsigned getFeatureCount() const { return _featureCount; }
     
@@ -121,14 +128,74 @@ private:
         SmallValueType type;
     };
 
+    // A feature's tags or geometry.  Normally a span of packed varints within the tile data.
+    // If the encoder didn't pack them, they're decoded up front and this is a range of the fallback vector.
+    struct PackedInts
+    {
+        const uint8_t *packed = nullptr;
+        uint32_t packedBytes = 0;
+        uint32_t start = 0;
+        uint32_t end = 0;
+    };
+
+    // Passed to the nanopb callback for tags or geometry
+    struct PackedIntsArg
+    {
+        PackedInts ints;
+        std::vector<uint32_t> *unpacked;
+        const uint8_t *tileBegin;
+        const uint8_t *tileEnd;
+    };
+
     struct Feature
     {
-        uint32_t tagIndex;
-        uint32_t geomIndex;
+        PackedInts tags;
+        PackedInts geom;
         MapnikGeometryType geomType;
-        Feature() : tagIndex(0), geomIndex(0), geomType(GeomTypeUnknown) {}
-        Feature(uint32_t tagIdx, uint32_t geomIdx, MapnikGeometryType gType)
-            : tagIndex(tagIdx), geomIndex(geomIdx), geomType(gType) { }
+        Feature() : geomType(GeomTypeUnknown) {}
+        Feature(const PackedInts &tags, const PackedInts &geom, MapnikGeometryType gType)
+            : tags(tags), geom(geom), geomType(gType) { }
+    };
+
+    // Read-only view of a feature's attributes, straight out of the tile data.
+    // Style filters look at this so we only build dictionaries for the features we keep.
+    // Matches what the equivalent MutableDictionaryC would return.
+    class FeatureAttributes : public Dictionary
+    {
+    public:
+        FeatureAttributes(const VectorTilePBFParser &parser) : parser(parser) { }
+
+        // Point at a new feature
+        void reset(const std::string &layerName, MapnikGeometryType geomType, int layerOrder,
+                   const uint32_t *tags, size_t numTags);
+
+        virtual int count() const override;
+        virtual bool empty() const override { return count() == 0; }
+        virtual bool hasField(const std::string &name) const override;
+        virtual DictionaryType getType(const std::string &name) const override;
+        virtual int getInt(const std::string &name,int defVal) const override;
+        virtual int64_t getInt64(const std::string &name,int64_t defVal) const override;
+        virtual SimpleIdentity getIdentity(const std::string &name) const override;
+        virtual bool getBool(const std::string &name,bool defVal) const override;
+        virtual RGBAColor getColor(const std::string &name,const RGBAColor &defVal) const override;
+        virtual double getDouble(const std::string &name,double defVal) const override;
+        virtual std::string getString(const std::string &name) const override;
+        virtual std::string getString(const std::string &name,const std::string &defVal) const override;
+        virtual DictionaryRef getDict(const std::string &name) const override;
+        virtual DictionaryEntryRef getEntry(const std::string &name) const override;
+        virtual std::vector<DictionaryEntryRef> getArray(const std::string &name) const override;
+        virtual std::vector<std::string> getKeys() const override;
+
+    protected:
+        // Look up a value, later tags win, just like setting them in order
+        DictionaryValueC find(const std::string &name) const;
+
+        const VectorTilePBFParser &parser;
+        const std::string *layerName = nullptr;
+        MapnikGeometryType geomType = GeomTypeUnknown;
+        int layerOrder = 0;
+        const uint32_t *tags = nullptr;
+        size_t numTags = 0;
     };
 
 private:
@@ -141,6 +208,7 @@ private:
     static bool stringDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool stringVecDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool intVecDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
+    static bool packedIntsDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool valueVecDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
 
     // Wrapped callbacks
@@ -148,8 +216,14 @@ private:
     inline bool featureDecode(pb_istream_t *stream, const pb_field_iter_t *field);
 
     // Parsing methods
-    inline bool processTags(const MutableDictionaryCRef &attributes, size_t tagIdx, size_t geomIdx, const Feature &feature);
-    inline bool checkStyles(SimpleIDUSet& styleIDs, const MutableDictionaryCRef &attributes, const std::string &layerName);
+    inline bool unpackInts(const PackedInts &ints, const std::vector<uint32_t> &unpacked,
+                           std::vector<uint32_t> &scratch, const uint32_t *&values, size_t &count);
+    inline InternedDictionaryCRef processTags(MapnikGeometryType geomType, const uint32_t *tags, size_t tagCount);
+    inline void startLayerTable(const std::string &layerName);
+    inline uint32_t tableKey(uint32_t keyIndex);
+    inline int tableValue(uint32_t valueIndex);
+    inline uint32_t tableGeomType(MapnikGeometryType geomType);
+    inline bool checkStyles(SimpleIDUSet& styleIDs, const Dictionary &attributes, const std::string &layerName);
     inline void parseLineString(const uint32_t *geometry, size_t geomCount, ShapeSet& shapes) const;
     inline bool parsePolygon(const uint32_t *geometry, size_t geomCount, VectorAreal& shape);
     inline bool parsePoints(const uint32_t *geometry, size_t geomCount, VectorPoints& shape);
@@ -163,8 +237,6 @@ private:
 
     // We assume features are mostly geometry
     static inline int featureHeuristic(int layerBytesLeft) { return layerBytesLeft / 100; }
-    static inline int featureTagHeuristic(int layerBytesLeft) { return layerBytesLeft / 50; }
-    static inline int featureGeometryHeuristic(int layerBytesLeft) { return layerBytesLeft / 10; }
     static inline int featureStyleHeuristic() { return 50; }
 
 private:
@@ -182,6 +254,8 @@ private:
     std::vector<std::string_view> _layerKeys;
     std::vector<SmallValue> _layerValues;
     std::string _parseError;
+    const uint8_t *_tileBegin = nullptr;
+    const uint8_t *_tileEnd = nullptr;
 
 private:
     // Data provided by the caller
@@ -196,8 +270,28 @@ private:
     std::vector<VectorObjectRef>* _keepVectors = nullptr;
     CancelFunction _checkCancelled;
 
+    bool _zeroCopy = true;
+
+    // Keys and values from the current layer, copied out of the tile as the
+    // features we keep need them.  All of the layer's feature attributes share it.
+    struct LayerTable
+    {
+        InternedDictionaryTableRef table;
+        std::vector<int> keys;      // Layer key index to table index, or -1
+        std::vector<int> values;    // Same for values
+        std::vector<std::pair<MapnikGeometryType,uint32_t>> geomTypes;
+        uint32_t layerNameKey = 0;
+        uint32_t geometryTypeKey = 0;
+        uint32_t layerOrderKey = 0;
+        uint32_t layerNameValue = 0;
+        uint32_t layerOrderValue = 0;
+    };
+    LayerTable _layerTable;
+
     // Reused storage
     VectorRing tempRing;
+    std::vector<uint32_t> _tagScratch;
+    std::vector<uint32_t> _geomScratch;
 
     // State used during parsing
     const MbrD _bbox;
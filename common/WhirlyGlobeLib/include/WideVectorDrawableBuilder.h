@@ -178,6 +178,12 @@ public:
     
     /// Numer of triangles added so far
     unsigned int getNumTris();
+
+    /// Most points we want in the drawable
+    unsigned int getMaxPoints();
+
+    /// Most triangles we want in the drawable
+    unsigned int getMaxTriangles();
     
     // Return the basic drawable for the simple and complex cases
     virtual BasicDrawableRef getBasicDrawable();
@@ -28,10 +28,29 @@ using namespace Eigen;
 namespace WhirlyKit
 {
     
-BasicDrawable::Triangle::Triangle(unsigned short v0,unsigned short v1,unsigned short v2)
+BasicDrawable::Triangle::Triangle(uint32_t v0,uint32_t v1,uint32_t v2)
 {
     verts[0] = v0;  verts[1] = v1;  verts[2] = v2;
 }
+
+void BasicDrawable::CopyIndices(const std::vector<Triangle> &tris,bool use32Bit,void *dest)
+{
+    if (use32Bit)
+    {
+        static_assert(sizeof(Triangle) == 3*sizeof(uint32_t), "Triangle is expected to be packed");
+        memcpy(dest, tris.data(), tris.size() * sizeof(Triangle));
+    }
+    else
+    {
+        auto *idx = (uint16_t *)dest;
+        for (const auto &tri : tris)
+        {
+            *idx++ = (uint16_t)tri.verts[0];
+            *idx++ = (uint16_t)tri.verts[1];
+            *idx++ = (uint16_t)tri.verts[2];
+        }
+    }
+}
     
 BasicDrawable::BasicDrawable(const std::string &name) :
     Drawable(name),
@@ -18,6 +18,8 @@
 
 #import "BasicDrawableBuilder.h"
 #import "SceneRenderer.h"
+#import "WhirlyKitLog.h"
+#import "Expect.h"
 
 using namespace Eigen;
 
@@ -381,18 +383,24 @@ void BasicDrawableBuilder::setClipCoords(bool clipCoords)
 
 unsigned int BasicDrawableBuilder::addPoint(const Point3f &pt)
 {
+    if (mixedWithInterleaved("addPoint"))
+        return getNumPoints();
     points.push_back(pt);
     return (unsigned int)(points.size()-1);
 }
 
 unsigned int BasicDrawableBuilder::addPoint(const Point3d &pt)
 {
+    if (mixedWithInterleaved("addPoint"))
+        return getNumPoints();
     points.push_back(Point3f(pt.x(),pt.y(),pt.z()));
     return (unsigned int)(points.size()-1);
 }
     
 unsigned int BasicDrawableBuilder::getNumPoints() const
 {
+    if (isInterleaved())
+        return (unsigned int)(interleavedVerts.size() / interleavedVertexSize);
     return points.size();
 }
 
@@ -401,8 +409,121 @@ unsigned int BasicDrawableBuilder::getNumTris() const
     return tris.size();
 }
 
+bool BasicDrawableBuilder::needs32BitIndices() const
+{
+    switch (indexPolicy)
+    {
+        case DrawableIndex16:   return false;
+        case DrawableIndex32:   return true;
+        case DrawableIndexAuto: return getNumPoints() > (1<<16);
+    }
+    return false;
+}
+
+void BasicDrawableBuilder::setupInterleaved(unsigned int vertexSize,const std::vector<InterleavedAttribute> &attrs,unsigned int numReserve)
+{
+    if (!points.empty() || !interleavedVerts.empty())
+    {
+        wkLogLevel(Warn, "BasicDrawableBuilder: Can't switch to interleaved vertices after adding points");
+        return;
+    }
+
+    interleavedVertexSize = vertexSize;
+    interleavedVerts.reserve((size_t)numReserve * vertexSize);
+
+    // Hook each one up to an existing attribute or make a new one
+    interleavedOffsets.assign(basicDraw->vertexAttributes.size(), 0);
+    for (const auto &attr : attrs)
+    {
+        int which = findAttribute(attr.nameID);
+        if (which < 0)
+        {
+            which = addAttribute(attr.type,attr.nameID);
+        }
+        else if (basicDraw->vertexAttributes[which]->getDataType() != attr.type)
+        {
+            wkLogLevel(Warn, "BasicDrawableBuilder: Interleaved attribute type doesn't match existing attribute");
+            continue;
+        }
+        if ((size_t)which >= interleavedOffsets.size())
+            interleavedOffsets.resize(which+1, 0);
+        interleavedOffsets[which] = attr.offset;
+    }
+}
+
+// Copy one attribute out of the interleaved vertices into its own array
+template<typename T>
+static void UnpackInterleavedAttribute(const std::vector<unsigned char> &verts,unsigned int vertexSize,
+                                       unsigned int offset,VertexAttribute *attr)
+{
+    const size_t numVerts = verts.size() / vertexSize;
+    attr->reserve((int)numVerts);
+    auto &vals = *(std::vector<T> *)attr->data;
+    vals.resize(numVerts);
+    for (size_t ii=0;ii<numVerts;ii++)
+        memcpy((void *)&vals[ii], &verts[ii * vertexSize + offset], sizeof(T));
+}
+
+void BasicDrawableBuilder::unpackInterleaved()
+{
+    if (!isInterleaved())
+        return;
+
+    const unsigned int numVerts = getNumPoints();
+    points.resize(numVerts);
+    for (unsigned int ii=0;ii<numVerts;ii++)
+        memcpy(points[ii].data(), &interleavedVerts[ii * interleavedVertexSize], sizeof(Point3f));
+
+    for (unsigned int which=0;which<interleavedOffsets.size();which++)
+    {
+        const unsigned int offset = interleavedOffsets[which];
+        if (offset == 0)
+            continue;
+        VertexAttribute *attr = basicDraw->vertexAttributes[which];
+        attr->clear();
+        switch (attr->getDataType())
+        {
+            case BDFloat4Type: UnpackInterleavedAttribute<Vector4f>(interleavedVerts,interleavedVertexSize,offset,attr);  break;
+            case BDFloat3Type: UnpackInterleavedAttribute<Vector3f>(interleavedVerts,interleavedVertexSize,offset,attr);  break;
+            case BDChar4Type:  UnpackInterleavedAttribute<RGBAColor>(interleavedVerts,interleavedVertexSize,offset,attr); break;
+            case BDFloat2Type: UnpackInterleavedAttribute<Vector2f>(interleavedVerts,interleavedVertexSize,offset,attr);  break;
+            case BDFloatType:  UnpackInterleavedAttribute<float>(interleavedVerts,interleavedVertexSize,offset,attr);     break;
+            case BDIntType:    UnpackInterleavedAttribute<int>(interleavedVerts,interleavedVertexSize,offset,attr);       break;
+            case BDInt64Type:  UnpackInterleavedAttribute<int64_t>(interleavedVerts,interleavedVertexSize,offset,attr);   break;
+            case BDDataTypeMax: break;
+        }
+    }
+
+    interleavedVerts.clear();
+    interleavedVerts.shrink_to_fit();
+    interleavedOffsets.clear();
+    interleavedVertexSize = 0;
+}
+
+bool BasicDrawableBuilder::mixedWithInterleaved(const char *what)
+{
+    if (LIKELY(!isInterleaved()))
+        return false;
+
+    if (!warnedInterleaved)
+    {
+        wkLogLevel(Warn, "BasicDrawableBuilder: %s doesn't work with interleaved vertices, ignoring", what);
+        warnedInterleaved = true;
+    }
+    return true;
+}
+
 Point3d BasicDrawableBuilder::getPoint(int which) const
 {
+    if (isInterleaved())
+    {
+        if (which < 0 || which >= (int)getNumPoints())
+            return Point3d(0,0,0);
+        Point3f pt;
+        memcpy(pt.data(), &interleavedVerts[which * interleavedVertexSize], sizeof(Point3f));
+        return Point3d(pt.x(),pt.y(),pt.z());
+    }
+
     if (which >= points.size())
         return Point3d(0,0,0);
     const Point3f &pt = points[which];
@@ -412,6 +533,9 @@ Point3d BasicDrawableBuilder::getPoint(int which) const
 
 void BasicDrawableBuilder::addTexCoord(int which,TexCoord coord)
 {
+    if (mixedWithInterleaved("addTexCoord"))
+        return;
+
     if (which == -1)
     {
         // In this mode, add duplicate texture coords in each of the vertex attrs
@@ -426,7 +550,7 @@ void BasicDrawableBuilder::addTexCoord(int which,TexCoord coord)
 
 void BasicDrawableBuilder::addColor(RGBAColor color)
 {
-    if (basicDraw->colorEntry < 0)
+    if (basicDraw->colorEntry < 0 || mixedWithInterleaved("addColor"))
         return;
     
     basicDraw->vertexAttributes[basicDraw->colorEntry]->addColor(color);
@@ -434,7 +558,7 @@ void BasicDrawableBuilder::addColor(RGBAColor color)
 
 void BasicDrawableBuilder::addNormal(const Point3f &norm)
 {
-    if (basicDraw->normalEntry < 0)
+    if (basicDraw->normalEntry < 0 || mixedWithInterleaved("addNormal"))
         return;
     
     basicDraw->vertexAttributes[basicDraw->normalEntry]->addVector3f(norm);
@@ -553,27 +677,53 @@ void BasicDrawableBuilder::addVertexAttributes(const SingleVertexAttributeSet &a
 }
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,const Eigen::Vector2f &vec)
-{ basicDraw->vertexAttributes[attrId]->addVector2f(vec); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addVector2f(vec);
+}
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,const Eigen::Vector3f &vec)
-{ basicDraw->vertexAttributes[attrId]->addVector3f(vec); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addVector3f(vec);
+}
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,const Eigen::Vector4f &vec)
-{ basicDraw->vertexAttributes[attrId]->addVector4f(vec); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addVector4f(vec);
+}
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,const RGBAColor &color)
-{ basicDraw->vertexAttributes[attrId]->addColor(color); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addColor(color);
+}
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,float val)
-{ basicDraw->vertexAttributes[attrId]->addFloat(val); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addFloat(val);
+}
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,int val)
 {
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
     basicDraw->vertexAttributes[attrId]->addInt(val);
 }
 
 void BasicDrawableBuilder::addAttributeValue(int attrId,int64_t val)
-{ basicDraw->vertexAttributes[attrId]->addFloat(val); }
+{
+    if (mixedWithInterleaved("addAttributeValue"))
+        return;
+    basicDraw->vertexAttributes[attrId]->addFloat(val);
+}
 
 int BasicDrawableBuilder::findAttribute(int nameID)
 {
@@ -83,9 +83,21 @@ BasicDrawableRef BasicDrawableBuilderGLES::getDrawable()
     auto draw = std::dynamic_pointer_cast<BasicDrawableGLES>(basicDraw);
 
     if (draw && !drawableGotten) {
-        draw->points = points;
+        draw->use32BitIndices = needs32BitIndices();
+        if (isInterleaved())
+        {
+            // Already laid out the way the buffer wants it, so just hand it over
+            draw->interleavedVerts = std::move(interleavedVerts);
+            draw->vertexSize = (int)interleavedVertexSize;
+            for (unsigned int ii=0;ii<interleavedOffsets.size();ii++)
+                ((VertexAttributeGLES *)draw->vertexAttributes[ii])->buffer = interleavedOffsets[ii];
+        }
+        else
+        {
+            draw->points = points;
+            draw->vertexSize = (int)draw->singleVertexSize();
+        }
         draw->tris = tris;
-        draw->vertexSize = (int)draw->singleVertexSize();
 
         ((BasicDrawableBuilder*)this)->setupTweaker(*draw);
 
@@ -98,9 +98,27 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scen
     //        NSLog(@"Hey why are we doing setupGL on the main thread? %s",name.c_str());
     //    }
     
+    const bool interleaved = !interleavedVerts.empty();
+
     // Offset the geometry upward by minZres units along the normals
     // Only do this once, obviously
-    if (drawOffset != 0 && (points.size() == vertexAttributes[normalEntry]->numElements()))
+    if (drawOffset != 0 && interleaved)
+    {
+        const GLuint normOffset = (normalEntry >= 0) ? ((VertexAttributeGLES *)vertexAttributes[normalEntry])->buffer : 0;
+        if (normOffset != 0)
+        {
+            float scale = setupInfo->minZres*drawOffset;
+            for (size_t ii=0;ii<interleavedVerts.size();ii+=vertexSize)
+            {
+                Vector3f pt,norm;
+                memcpy(pt.data(), &interleavedVerts[ii], sizeof(pt));
+                memcpy(norm.data(), &interleavedVerts[ii+normOffset], sizeof(norm));
+                pt = norm * scale + pt;
+                memcpy(&interleavedVerts[ii], pt.data(), sizeof(pt));
+            }
+        }
+    }
+    else if (drawOffset != 0 && ((int)points.size() == vertexAttributes[normalEntry]->numElements()))
     {
         float scale = setupInfo->minZres*drawOffset;
         Point3fVector &norms = *(Point3fVector *)vertexAttributes[normalEntry]->data;
@@ -118,10 +136,13 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scen
     // We'll set up a single buffer for everything.
     // The other buffer pointers are now strides
     // Size of a single vertex entry
-    const int numVerts = (int)points.size();
+    const int numVerts = interleaved ? (int)(interleavedVerts.size() / vertexSize) : (int)points.size();
     
+    // Indices are 16 bits unless the builder asked for more
+    const auto triSize = 3 * indexSize();
+
     // Set up the buffer
-    auto bufferSize = (int)(vertexSize*numVerts + tris.size()*sizeof(Triangle));
+    auto bufferSize = (int)(vertexSize*numVerts + tris.size()*triSize);
     sharedBuffer = setupInfo->memManager->getBufferID(bufferSize,GL_STATIC_DRAW);
     if (!sharedBuffer)
     {
@@ -135,25 +156,40 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scen
         void *glMem = glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, GL_MAP_WRITE_BIT);
         if (auto *basePtr = (unsigned char *)glMem)
         {
-            memset(glMem, 0, bufferSize);
+            if (interleaved)
+            {
+                // Already in the right layout, so it's a straight copy
+                memcpy(glMem, &interleavedVerts[0], numVerts * vertexSize);
+            }
+            else
+            {
+                memset(glMem, 0, bufferSize);
 
-            for (int ii = 0; ii < numVerts; ii++, basePtr += vertexSize)
-                addPointToBuffer(basePtr, ii, nullptr);
+                for (int ii = 0; ii < numVerts; ii++, basePtr += vertexSize)
+                    addPointToBuffer(basePtr, ii, nullptr);
+            }
 
             // And copy in the element buffer
             if (!tris.empty())
             {
                 triBuffer = vertexSize * numVerts;
-                unsigned char *triBasePtr = (unsigned char *) glMem + triBuffer;
-                for (unsigned int ii = 0; ii < tris.size(); ii++, triBasePtr += sizeof(Triangle))
-                    memcpy(triBasePtr, &tris[ii], sizeof(Triangle));
+                CopyIndices(tris, use32BitIndices, (unsigned char *) glMem + triBuffer);
             }
             glUnmapBuffer(GL_ARRAY_BUFFER);
         }
     }
+    else if (interleaved)
+    {
+        // Tack the element buffer on the end and hand over the whole thing
+        triBuffer = numVerts*vertexSize;
+        interleavedVerts.resize(bufferSize);
+        CopyIndices(tris, use32BitIndices, interleavedVerts.data() + triBuffer);
+
+        glBufferData(GL_ARRAY_BUFFER, bufferSize, interleavedVerts.data(), GL_STATIC_DRAW);
+    }
     else
     {
-        bufferSize = numVerts*vertexSize+tris.size()*sizeof(Triangle);
+        bufferSize = numVerts*vertexSize+tris.size()*triSize;
         
         // Gotta do this the hard way
         std::vector<unsigned char> glMemBuf(bufferSize);
@@ -164,8 +200,7 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scen
         
         // Now the element buffer
         triBuffer = numVerts*vertexSize;
-        for (unsigned int ii=0;ii<tris.size();ii++,basePtr+=sizeof(Triangle))
-            memcpy(basePtr, &tris[ii], sizeof(Triangle));
+        CopyIndices(tris, use32BitIndices, basePtr);
         
         glBufferData(GL_ARRAY_BUFFER, bufferSize, glMem, GL_STATIC_DRAW);
     }
@@ -173,8 +208,10 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scen
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
     // Clear out the arrays, since we won't need them again
-    numPoints = (int)points.size();
+    numPoints = numVerts;
     points.clear();
+    interleavedVerts.clear();
+    interleavedVerts.shrink_to_fit();
     numTris = (int)tris.size();
     tris.clear();
     for (auto & vertexAttribute : vertexAttributes)
@@ -575,7 +612,7 @@ void BasicDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inScene)
         switch (type)
         {
             case Triangles:
-                glDrawElements(GL_TRIANGLES, numTris*3, GL_UNSIGNED_SHORT, CALCBUFOFF(0,triBuffer));
+                glDrawElements(GL_TRIANGLES, numTris*3, glIndexType(), CALCBUFOFF(0,triBuffer));
                 CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                 break;
             case Points:
@@ -606,14 +643,15 @@ void BasicDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inScene)
                         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, triBuffer);
                     }
                     CheckGLError("BasicDrawable::drawVBO2() glBindBuffer");
-                    glDrawElements(GL_TRIANGLES, numTris*3, GL_UNSIGNED_SHORT, (void *)((uintptr_t)triBuffer));
+                    glDrawElements(GL_TRIANGLES, numTris*3, glIndexType(), (void *)((uintptr_t)triBuffer));
                     CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
                 } else {
+                    // Triangles in memory are always full size
                     if (!boundElements)
-                        glDrawElements(GL_TRIANGLES, (GLsizei)tris.size()*3, GL_UNSIGNED_SHORT, &tris[0]);
+                        glDrawElements(GL_TRIANGLES, (GLsizei)tris.size()*3, GL_UNSIGNED_INT, &tris[0]);
                     else
-                        glDrawElements(GL_TRIANGLES, numTris*3, GL_UNSIGNED_SHORT, nullptr);
+                        glDrawElements(GL_TRIANGLES, numTris*3, glIndexType(), nullptr);
                     CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                 }
             }
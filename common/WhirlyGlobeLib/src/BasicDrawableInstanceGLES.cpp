@@ -495,9 +495,9 @@ void BasicDrawableInstanceGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inS
                 case Triangles:
                     if (instBuffer)
                     {
-                        glDrawElementsInstanced(GL_TRIANGLES, basicDrawGL->numTris*3, GL_UNSIGNED_SHORT, CALCBUFOFF(0,basicDrawGL->triBuffer), numInstances);
+                        glDrawElementsInstanced(GL_TRIANGLES, basicDrawGL->numTris*3, basicDrawGL->glIndexType(), CALCBUFOFF(0,basicDrawGL->triBuffer), numInstances);
                     } else
-                        glDrawElements(GL_TRIANGLES, basicDrawGL->numTris*3, GL_UNSIGNED_SHORT, CALCBUFOFF(0,basicDrawGL->triBuffer));
+                        glDrawElements(GL_TRIANGLES, basicDrawGL->numTris*3, basicDrawGL->glIndexType(), CALCBUFOFF(0,basicDrawGL->triBuffer));
                     CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                     break;
                 case Points:
@@ -550,17 +550,17 @@ void BasicDrawableInstanceGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inS
                         CheckGLError("BasicDrawable::drawVBO2() glBindBuffer");
                         if (instBuffer)
                         {
-                            glDrawElementsInstanced(GL_TRIANGLES, basicDrawGL->numTris*3, GL_UNSIGNED_SHORT, nullptr, numInstances);
+                            glDrawElementsInstanced(GL_TRIANGLES, basicDrawGL->numTris*3, basicDrawGL->glIndexType(), nullptr, numInstances);
                         } else
-                            glDrawElements(GL_TRIANGLES, basicDrawGL->numTris*3, GL_UNSIGNED_SHORT, (void *)((uintptr_t)basicDrawGL->triBuffer));
+                            glDrawElements(GL_TRIANGLES, basicDrawGL->numTris*3, basicDrawGL->glIndexType(), (void *)((uintptr_t)basicDrawGL->triBuffer));
                         CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
                     } else {
                         if (instBuffer)
                         {
-                            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)basicDrawGL->tris.size()*3, GL_UNSIGNED_SHORT, &basicDrawGL->tris[0], numInstances);
+                            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)basicDrawGL->tris.size()*3, GL_UNSIGNED_INT, &basicDrawGL->tris[0], numInstances);
                         } else
-                            glDrawElements(GL_TRIANGLES, (GLsizei)basicDrawGL->tris.size()*3, GL_UNSIGNED_SHORT, &basicDrawGL->tris[0]);
+                            glDrawElements(GL_TRIANGLES, (GLsizei)basicDrawGL->tris.size()*3, GL_UNSIGNED_INT, &basicDrawGL->tris[0]);
                         CheckGLError("BasicDrawable::drawVBO2() glDrawElements");
                     }
                 }
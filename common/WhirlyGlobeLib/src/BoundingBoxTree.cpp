@@ -0,0 +1,273 @@
+/*  BoundingBoxTree.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "BoundingBoxTree.h"
+#import <algorithm>
+
+namespace WhirlyKit
+{
+
+BoundingBoxTree::Box BoundingBoxTree::boxUnion(const Box &a,const Box &b)
+{
+    return Box { a.ll.cwiseMin(b.ll), a.ur.cwiseMax(b.ur) };
+}
+
+double BoundingBoxTree::boxArea(const Box &box)
+{
+    // Surface area (well, half of it) is the usual cost for these trees
+    const Point3d span = box.ur - box.ll;
+    return span.x() * span.y() + span.y() * span.z() + span.z() * span.x();
+}
+
+int BoundingBoxTree::allocNode()
+{
+    if (freeList >= 0)
+    {
+        const int which = freeList;
+        freeList = nodes[which].child1;
+        nodes[which] = Node();
+        return which;
+    }
+
+    nodes.emplace_back();
+    return (int)nodes.size() - 1;
+}
+
+void BoundingBoxTree::freeNode(int which)
+{
+    Node &node = nodes[which];
+    node.parent = -1;
+    node.child0 = -1;
+    node.child1 = freeList;
+    node.boxID = EmptyIdentity;
+    freeList = which;
+}
+
+void BoundingBoxTree::addBox(SimpleIdentity boxID,const Box &box)
+{
+    removeBox(boxID);
+
+    const int leaf = allocNode();
+    nodes[leaf].box = box;
+    nodes[leaf].boxID = boxID;
+    leaves[boxID] = leaf;
+
+    insertLeaf(leaf);
+}
+
+bool BoundingBoxTree::removeBox(SimpleIdentity boxID)
+{
+    const auto it = leaves.find(boxID);
+    if (it == leaves.end())
+    {
+        return false;
+    }
+
+    const int leaf = it->second;
+    leaves.erase(it);
+
+    removeLeaf(leaf);
+    freeNode(leaf);
+
+    return true;
+}
+
+void BoundingBoxTree::clear()
+{
+    nodes.clear();
+    leaves.clear();
+    root = -1;
+    freeList = -1;
+}
+
+void BoundingBoxTree::reserve(size_t numBoxes)
+{
+    nodes.reserve(2 * numBoxes);
+    leaves.reserve(numBoxes);
+}
+
+void BoundingBoxTree::insertLeaf(int leaf)
+{
+    if (root < 0)
+    {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    // Walk down, going wherever the box grows the least
+    const Box leafBox = nodes[leaf].box;
+    int which = root;
+    while (nodes[which].child0 >= 0)
+    {
+        const Node &node = nodes[which];
+        const double area = boxArea(node.box);
+        const double combinedArea = boxArea(boxUnion(node.box, leafBox));
+
+        // Cost of making a new parent for this node and the leaf
+        const double cost = 2.0 * combinedArea;
+        // Minimum cost of pushing the leaf further down
+        const double inheritCost = 2.0 * (combinedArea - area);
+
+        double childCost[2];
+        const int children[2] = { node.child0, node.child1 };
+        for (int ii = 0; ii < 2; ii++)
+        {
+            const Node &child = nodes[children[ii]];
+            const double newArea = boxArea(boxUnion(child.box, leafBox));
+            childCost[ii] = (child.child0 < 0 ? newArea : newArea - boxArea(child.box)) + inheritCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+        {
+            break;
+        }
+        which = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    // New parent for the sibling and the leaf
+    const int sibling = which;
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocNode();
+    {
+        Node &parentNode = nodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.box = boxUnion(leafBox, nodes[sibling].box);
+        parentNode.height = nodes[sibling].height + 1;
+        parentNode.child0 = sibling;
+        parentNode.child1 = leaf;
+    }
+    if (oldParent >= 0)
+    {
+        Node &oldParentNode = nodes[oldParent];
+        (oldParentNode.child0 == sibling ? oldParentNode.child0 : oldParentNode.child1) = newParent;
+    }
+    else
+    {
+        root = newParent;
+    }
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    refit(newParent);
+}
+
+void BoundingBoxTree::removeLeaf(int leaf)
+{
+    if (leaf == root)
+    {
+        root = -1;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = (nodes[parent].child0 == leaf) ? nodes[parent].child1 : nodes[parent].child0;
+
+    if (grandParent >= 0)
+    {
+        Node &grandParentNode = nodes[grandParent];
+        (grandParentNode.child0 == parent ? grandParentNode.child0 : grandParentNode.child1) = sibling;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    }
+    else
+    {
+        root = sibling;
+        nodes[sibling].parent = -1;
+        freeNode(parent);
+    }
+}
+
+void BoundingBoxTree::refit(int which)
+{
+    while (which >= 0)
+    {
+        which = balance(which);
+
+        Node &node = nodes[which];
+        const Node &child0 = nodes[node.child0];
+        const Node &child1 = nodes[node.child1];
+        node.height = 1 + std::max(child0.height, child1.height);
+        node.box = boxUnion(child0.box, child1.box);
+
+        which = node.parent;
+    }
+}
+
+int BoundingBoxTree::balance(int iA)
+{
+    Node &nodeA = nodes[iA];
+    if (nodeA.child0 < 0 || nodeA.height < 2)
+    {
+        return iA;
+    }
+
+    const int iB = nodeA.child0;
+    const int iC = nodeA.child1;
+    const int diff = nodes[iC].height - nodes[iB].height;
+    if (diff <= 1 && diff >= -1)
+    {
+        return iA;
+    }
+
+    // Rotate the taller child up.  The shorter one stays under A.
+    const int iUp = (diff > 1) ? iC : iB;
+    const int iStay = (diff > 1) ? iB : iC;
+    Node &nodeUp = nodes[iUp];
+    const int iF = nodeUp.child0;
+    const int iG = nodeUp.child1;
+
+    // The taller child takes A's place
+    nodeUp.child0 = iA;
+    nodeUp.parent = nodeA.parent;
+    nodeA.parent = iUp;
+    if (nodeUp.parent >= 0)
+    {
+        Node &parent = nodes[nodeUp.parent];
+        (parent.child0 == iA ? parent.child0 : parent.child1) = iUp;
+    }
+    else
+    {
+        root = iUp;
+    }
+
+    // Its taller grandchild stays with it, the shorter one goes to A
+    const bool keepF = nodes[iF].height > nodes[iG].height;
+    const int iKeep = keepF ? iF : iG;
+    const int iMove = keepF ? iG : iF;
+    const Node &nodeKeep = nodes[iKeep];
+    const Node &nodeStay = nodes[iStay];
+    Node &nodeMove = nodes[iMove];
+
+    nodeUp.child1 = iKeep;
+    nodeA.child0 = iStay;
+    nodeA.child1 = iMove;
+    nodeMove.parent = iA;
+
+    nodeA.box = boxUnion(nodeStay.box, nodeMove.box);
+    nodeA.height = 1 + std::max(nodeStay.height, nodeMove.height);
+    nodeUp.box = boxUnion(nodeA.box, nodeKeep.box);
+    nodeUp.height = 1 + std::max(nodeA.height, nodeKeep.height);
+
+    return iUp;
+}
+
+}
@@ -20,10 +20,228 @@
 #import "Texture.h"
 #import "Drawable.h"
 #import "SceneRenderer.h"
+#import <algorithm>
+#import <mutex>
 
 namespace WhirlyKit
 {
 
+namespace
+{
+// Change requests are small and churn constantly as tiles load and unload.
+// Anything up to PoolMaxSize is carved from slabs and recycled through
+//  per-thread free lists, which spill over to a shared list in batches.
+constexpr size_t PoolGranularity = 16;
+constexpr size_t PoolMaxSize = 256;
+constexpr int PoolClasses = PoolMaxSize / PoolGranularity;
+constexpr size_t PoolSlabSize = 64 * 1024;
+constexpr int PoolBatch = 64;
+
+struct PoolBlock
+{
+    PoolBlock *next;
+};
+
+// Blocks shared between threads
+class ChangeRequestPool
+{
+public:
+    // Never destroyed, so thread caches can return blocks during shutdown
+    static ChangeRequestPool *shared()
+    {
+        static ChangeRequestPool *pool = new ChangeRequestPool();
+        return pool;
+    }
+
+    // Take up to a batch of blocks for the given size class
+    PoolBlock *take(int sizeClass,int &count)
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+
+        auto &list = lists[sizeClass];
+        if (!list.head)
+        {
+            addSlab(sizeClass);
+        }
+
+        PoolBlock *head = list.head;
+        PoolBlock *tail = head;
+        count = 1;
+        while (count < PoolBatch && tail->next)
+        {
+            tail = tail->next;
+            count++;
+        }
+        list.head = tail->next;
+        list.count -= count;
+        tail->next = nullptr;
+
+        return head;
+    }
+
+    // Hand back a list of blocks
+    void give(int sizeClass,PoolBlock *head,PoolBlock *tail,int count)
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+
+        auto &list = lists[sizeClass];
+        tail->next = list.head;
+        list.head = head;
+        list.count += count;
+    }
+
+protected:
+    void addSlab(int sizeClass)
+    {
+        const size_t blockSize = (sizeClass + 1) * PoolGranularity;
+        auto slab = (char *)::operator new(PoolSlabSize + PoolGranularity);
+        slabs.push_back(slab);
+
+        // Not all platforms hand back 16 byte aligned memory
+        auto start = (char *)(((uintptr_t)slab + PoolGranularity - 1) & ~(uintptr_t)(PoolGranularity - 1));
+        const int numBlocks = (int)(PoolSlabSize / blockSize);
+
+        auto &list = lists[sizeClass];
+        for (int ii = numBlocks - 1; ii >= 0; ii--)
+        {
+            auto block = (PoolBlock *)(start + ii * blockSize);
+            block->next = list.head;
+            list.head = block;
+        }
+        list.count += numBlocks;
+    }
+
+    struct FreeList
+    {
+        PoolBlock *head = nullptr;
+        int count = 0;
+    };
+
+    std::mutex lock;
+    FreeList lists[PoolClasses];
+    std::vector<char *> slabs;
+};
+
+// Blocks owned by the current thread.
+// This is trivially destructible so it stays usable during thread and process exit.
+struct ChangeRequestThreadCache
+{
+    void *alloc(int sizeClass);
+    void free(int sizeClass,void *ptr);
+    void flush();
+
+    PoolBlock *heads[PoolClasses];
+    int counts[PoolClasses];
+    bool registered;
+    bool exited;
+};
+
+thread_local ChangeRequestThreadCache changeRequestCache;
+
+// Hands the thread's blocks back to the shared pool when the thread exits
+struct ChangeRequestThreadExit
+{
+    ~ChangeRequestThreadExit()
+    {
+        changeRequestCache.flush();
+        changeRequestCache.exited = true;
+    }
+};
+
+thread_local ChangeRequestThreadExit changeRequestThreadExit;
+
+void *ChangeRequestThreadCache::alloc(int sizeClass)
+{
+    if (!registered)
+    {
+        // First use on this thread sets up the exit hook
+        registered = true;
+        (void)&changeRequestThreadExit;
+    }
+
+    if (!heads[sizeClass])
+    {
+        heads[sizeClass] = ChangeRequestPool::shared()->take(sizeClass, counts[sizeClass]);
+    }
+
+    PoolBlock *block = heads[sizeClass];
+    heads[sizeClass] = block->next;
+    counts[sizeClass]--;
+
+    if (exited)
+    {
+        // Don't hold on to anything past the end of the thread
+        flush();
+    }
+
+    return block;
+}
+
+void ChangeRequestThreadCache::free(int sizeClass,void *ptr)
+{
+    auto block = (PoolBlock *)ptr;
+    if (exited)
+    {
+        ChangeRequestPool::shared()->give(sizeClass, block, block, 1);
+        return;
+    }
+
+    block->next = heads[sizeClass];
+    heads[sizeClass] = block;
+
+    // The renderer frees most of what the layer threads allocate, so pass some back
+    if (++counts[sizeClass] >= 2 * PoolBatch)
+    {
+        PoolBlock *tail = block;
+        for (int ii = 1; ii < PoolBatch; ii++)
+            tail = tail->next;
+        heads[sizeClass] = tail->next;
+        counts[sizeClass] -= PoolBatch;
+        ChangeRequestPool::shared()->give(sizeClass, block, tail, PoolBatch);
+    }
+}
+
+void ChangeRequestThreadCache::flush()
+{
+    for (int ii = 0; ii < PoolClasses; ii++)
+    {
+        if (heads[ii])
+        {
+            PoolBlock *tail = heads[ii];
+            while (tail->next)
+                tail = tail->next;
+            ChangeRequestPool::shared()->give(ii, heads[ii], tail, counts[ii]);
+            heads[ii] = nullptr;
+            counts[ii] = 0;
+        }
+    }
+}
+
+}
+
+void *ChangeRequest::operator new(size_t size)
+{
+    if (size == 0 || size > PoolMaxSize)
+    {
+        return ::operator new(size);
+    }
+    return changeRequestCache.alloc((int)((size - 1) / PoolGranularity));
+}
+
+void ChangeRequest::operator delete(void *ptr,size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    if (size == 0 || size > PoolMaxSize)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    changeRequestCache.free((int)((size - 1) / PoolGranularity), ptr);
+}
+
 void RenderTeardownInfo::destroyTexture(SceneRenderer *renderer,const TextureBaseRef &tex)
 {
     tex->destroyInRenderer(renderer->getRenderSetupInfo(), renderer->getScene());
@@ -40,4 +258,114 @@ void ChangeRequest::setupForRenderer(const RenderSetupInfo *,Scene *scene) { }
 
 bool ChangeRequest::needPreExecute() { return false; }
 
+ChangeRequestQueue::~ChangeRequestQueue()
+{
+    ChangeSet changes;
+    drain(changes);
+    for (auto *change : changes)
+    {
+        delete change;
+    }
+}
+
+void ChangeRequestQueue::push(ChangeRequest *change)
+{
+    auto node = new Node();
+    node->single = change;
+    pushNode(node, 1);
+}
+
+void ChangeRequestQueue::push(const ChangeSet &changes)
+{
+    if (changes.empty())
+    {
+        return;
+    }
+    auto node = new Node();
+    node->changes = changes;
+    pushNode(node, (int)changes.size());
+}
+
+void ChangeRequestQueue::pushNode(Node *node,int num)
+{
+    // Count first so a concurrent drain never takes us below zero
+    count.fetch_add(num, std::memory_order_relaxed);
+
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed))
+    {
+    }
+}
+
+int ChangeRequestQueue::drain(ChangeSet &changes)
+{
+    // Take the whole stack at once.  No ABA problem since nodes are never popped individually.
+    Node *node = head.exchange(nullptr, std::memory_order_acquire);
+    if (!node)
+    {
+        return 0;
+    }
+
+    // Reverse it to get the batches in the order they were pushed
+    Node *prev = nullptr;
+    while (node)
+    {
+        Node *next = node->next;
+        node->next = prev;
+        prev = node;
+        node = next;
+    }
+
+    int num = 0;
+    for (node = prev; node; )
+    {
+        if (node->changes.empty())
+        {
+            changes.push_back(node->single);
+            num++;
+        }
+        else
+        {
+            changes.insert(changes.end(), node->changes.begin(), node->changes.end());
+            num += (int)node->changes.size();
+        }
+        Node *next = node->next;
+        delete node;
+        node = next;
+    }
+    count.fetch_sub(num, std::memory_order_relaxed);
+
+    return num;
+}
+
+void TimedChangeHeap::push(ChangeRequest *change)
+{
+    heap.push_back(change);
+    std::push_heap(heap.begin(), heap.end(), Later());
+}
+
+int TimedChangeHeap::popReady(TimeInterval now,ChangeSet &changes)
+{
+    int num = 0;
+    while (!heap.empty() && heap.front()->when <= now)
+    {
+        std::pop_heap(heap.begin(), heap.end(), Later());
+        changes.push_back(heap.back());
+        heap.pop_back();
+        num++;
+    }
+    return num;
+}
+
+void TimedChangeHeap::clear()
+{
+    for (auto *change : heap)
+    {
+        delete change;
+    }
+    heap.clear();
+}
+
 }
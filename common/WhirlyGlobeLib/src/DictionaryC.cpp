@@ -766,6 +766,22 @@ void MutableDictionaryC::addEntries(const Dictionary *inOther)
     {
         addEntries(other);
     }
+    else if (inOther)
+    {
+        // Other implementations (e.g. InternedDictionaryC) only have their simple values copied
+        for (const auto &key : inOther->getKeys())
+        {
+            switch (inOther->getType(key))
+            {
+                case DictTypeString:   setString(key, inOther->getString(key));             break;
+                case DictTypeInt:      setInt(key, inOther->getInt(key));                   break;
+                case DictTypeInt64:    setInt64(key, inOther->getInt64(key));               break;
+                case DictTypeIdentity: setIdentifiable(key, inOther->getIdentity(key));     break;
+                case DictTypeDouble:   setDouble(key, inOther->getDouble(key));             break;
+                default: break;
+            }
+        }
+    }
 }
 
 void MutableDictionaryC::addEntries(const MutableDictionaryC *other)
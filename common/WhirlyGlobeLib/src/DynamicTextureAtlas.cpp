@@ -36,13 +36,20 @@ DynamicTexture::DynamicTexture(const std::string &name)
 {
 }
 
-void DynamicTexture::setup(int inTexSize,int inCellSize,TextureType inType,bool inClearTextures)
+void DynamicTexture::setup(int inTexSize,int inCellSize,TextureType inType,bool inClearTextures,DynamicTextureLayout inLayout)
 {
     texSize = inTexSize;
     cellSize = inCellSize;
     type = inType;
     clearTextures = inClearTextures;
+    layout = inLayout;
     numCell = texSize/cellSize;
+    if (layout == DynamicTextureSkyline)
+    {
+        // No grid to keep, just the outline
+        resetSkyline();
+        return;
+    }
     layoutGrid = new bool[numCell * numCell];
     for (unsigned int ii=0;ii<numCell * numCell;ii++)
         layoutGrid[ii] = false;
@@ -64,12 +71,39 @@ void DynamicTexture::addTexture(Texture *tex,const Region &region)
     int width = tex->getWidth();
     int height = tex->getHeight();
     
-    RawDataRef data = tex->processData();
+    // The data is copied in right away, so we can reuse the conversion memory
+    static thread_local std::vector<unsigned char> convertBuffer;
+    RawDataRef data = tex->processData(convertBuffer);
     addTextureData(startX,startY,width,height,data);
+    data.reset();
+    TrimConvertBuffer(convertBuffer);
 }
 
 void DynamicTexture::setRegion(const Region &region, bool enable)
 {
+    if (layout == DynamicTextureSkyline)
+    {
+        // The space was taken when we found it, so this is just bookkeeping or a release
+        const int area = (region.ex - region.sx + 1) * (region.ey - region.sy + 1);
+        if (enable)
+        {
+            usedCells += area;
+        }
+        else
+        {
+            usedCells -= area;
+            if (usedCells <= 0)
+            {
+                resetSkyline();
+            }
+            else
+            {
+                addFreeRegion(region);
+            }
+        }
+        return;
+    }
+
     int sx = std::max(region.sx,0), sy = std::max(region.sy,0);
     int ex = std::min(region.ex,numCell-1), ey = std::min(region.ey,numCell-1);
     
@@ -110,6 +144,11 @@ bool DynamicTexture::findRegion(int sizeX,int sizeY,Region &region)
     {
         setRegion(ii, false);
     }
+
+    if (layout == DynamicTextureSkyline)
+    {
+        return findSkylineRegion(sizeX, sizeY, region);
+    }
     
     // Now look for a region that'll fit
     // Look for a spot big enough
@@ -143,6 +182,225 @@ bool DynamicTexture::findRegion(int sizeX,int sizeY,Region &region)
     return true;
 }
     
+static DynamicTexture::Region MakeRegion(int sx,int sy,int ex,int ey)
+{
+    DynamicTexture::Region region;
+    region.sx = sx;  region.sy = sy;
+    region.ex = ex;  region.ey = ey;
+    return region;
+}
+
+bool DynamicTexture::findSkylineRegion(int sizeX,int sizeY,Region &region)
+{
+    if (sizeX <= 0 || sizeY <= 0 || sizeX > numCell || sizeY > numCell)
+        return false;
+
+    // Try the free space under the skyline first, going for the tightest fit
+    int bestFree = -1;
+    int bestArea = 0;
+    for (int ii=0;ii<(int)freeRegions.size();ii++)
+    {
+        const Region &freeRegion = freeRegions[ii];
+        const int width = freeRegion.ex - freeRegion.sx + 1;
+        const int height = freeRegion.ey - freeRegion.sy + 1;
+        if (width >= sizeX && height >= sizeY && (bestFree < 0 || width * height < bestArea))
+        {
+            bestFree = ii;
+            bestArea = width * height;
+        }
+    }
+    if (bestFree >= 0)
+    {
+        const Region freeRegion = freeRegions[bestFree];
+        freeRegions.erase(freeRegions.begin() + bestFree);
+        region = MakeRegion(freeRegion.sx, freeRegion.sy, freeRegion.sx + sizeX - 1, freeRegion.sy + sizeY - 1);
+
+        // Split what's left in two, keeping the bigger piece as big as we can
+        const int leftX = freeRegion.ex - region.ex;
+        const int leftY = freeRegion.ey - region.ey;
+        const bool splitAcross = leftX < leftY;
+        if (leftX > 0)
+            freeRegions.push_back(MakeRegion(region.ex + 1, freeRegion.sy, freeRegion.ex, splitAcross ? region.ey : freeRegion.ey));
+        if (leftY > 0)
+            freeRegions.push_back(MakeRegion(freeRegion.sx, region.ey + 1, splitAcross ? freeRegion.ex : region.ex, freeRegion.ey));
+
+        return true;
+    }
+
+    // Then the spot along the skyline that leaves the lowest top, preferring narrow spans
+    int bestSpan = -1;
+    int bestY = 0, bestTop = 0, bestWidth = 0;
+    for (int ii=0;ii<(int)skyline.size();ii++)
+    {
+        const int x = skyline[ii].x;
+        if (x + sizeX > numCell)
+            break;
+
+        // Sits on the highest span it covers
+        int y = 0;
+        for (int jj=ii,widthLeft=sizeX;widthLeft > 0;jj++)
+        {
+            y = std::max(y, skyline[jj].y);
+            widthLeft -= skyline[jj].width;
+        }
+        if (y + sizeY > numCell)
+            continue;
+
+        if (bestSpan < 0 || y + sizeY < bestTop || (y + sizeY == bestTop && skyline[ii].width < bestWidth))
+        {
+            bestSpan = ii;
+            bestY = y;
+            bestTop = y + sizeY;
+            bestWidth = skyline[ii].width;
+        }
+    }
+    if (bestSpan < 0)
+        return false;
+
+    const int startX = skyline[bestSpan].x;
+    const int endX = startX + sizeX;
+    region = MakeRegion(startX, bestY, endX - 1, bestY + sizeY - 1);
+
+    // Take out the spans we covered, remembering the gaps underneath
+    std::vector<Region> gaps;
+    int which = bestSpan;
+    while (which < (int)skyline.size() && skyline[which].x < endX)
+    {
+        const SkylineSpan span = skyline[which];
+        const int spanEnd = span.x + span.width;
+        if (span.y < bestY)
+            gaps.push_back(MakeRegion(span.x, span.y, std::min(spanEnd, endX) - 1, bestY - 1));
+        if (spanEnd > endX)
+        {
+            skyline[which].x = endX;
+            skyline[which].width = spanEnd - endX;
+            break;
+        }
+        skyline.erase(skyline.begin() + which);
+    }
+    skyline.insert(skyline.begin() + bestSpan, SkylineSpan { startX, bestY + sizeY, sizeX });
+    mergeSkyline();
+
+    for (const auto &gap : gaps)
+        addFreeRegion(gap);
+
+    return true;
+}
+
+// Combine b into a if they share a whole edge
+static bool MergeRegions(DynamicTexture::Region &a,const DynamicTexture::Region &b)
+{
+    if (a.sx == b.sx && a.ex == b.ex && (a.ey + 1 == b.sy || b.ey + 1 == a.sy))
+    {
+        a.sy = std::min(a.sy, b.sy);
+        a.ey = std::max(a.ey, b.ey);
+        return true;
+    }
+    if (a.sy == b.sy && a.ey == b.ey && (a.ex + 1 == b.sx || b.ex + 1 == a.sx))
+    {
+        a.sx = std::min(a.sx, b.sx);
+        a.ex = std::max(a.ex, b.ex);
+        return true;
+    }
+    return false;
+}
+
+void DynamicTexture::addFreeRegion(Region region)
+{
+    // Glue it onto its neighbors for as long as that works
+    for (bool merged = true; merged; )
+    {
+        merged = false;
+        for (int ii=0;ii<(int)freeRegions.size();ii++)
+        {
+            if (MergeRegions(region, freeRegions[ii]))
+            {
+                freeRegions.erase(freeRegions.begin() + ii);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if (!lowerSkyline(region))
+    {
+        freeRegions.push_back(region);
+        return;
+    }
+
+    // The skyline came down, which may have uncovered more free space at the top
+    for (int ii=0;ii<(int)freeRegions.size();)
+    {
+        if (lowerSkyline(freeRegions[ii]))
+        {
+            freeRegions.erase(freeRegions.begin() + ii);
+            ii = 0;
+        }
+        else
+            ii++;
+    }
+}
+
+bool DynamicTexture::lowerSkyline(const Region &region)
+{
+    // Every column it covers has to end right on top of it
+    for (const auto &span : skyline)
+    {
+        if (span.x > region.ex)
+            break;
+        if (span.x + span.width > region.sx && span.y != region.ey + 1)
+            return false;
+    }
+
+    const int first = splitSkyline(region.sx);
+    const int last = (region.ex + 1 < numCell) ? splitSkyline(region.ex + 1) : (int)skyline.size();
+    for (int ii=first;ii<last;ii++)
+        skyline[ii].y = region.sy;
+    mergeSkyline();
+
+    return true;
+}
+
+int DynamicTexture::splitSkyline(int x)
+{
+    for (int ii=0;ii<(int)skyline.size();ii++)
+    {
+        SkylineSpan &span = skyline[ii];
+        if (span.x == x)
+            return ii;
+        if (span.x < x && x < span.x + span.width)
+        {
+            const SkylineSpan rest { x, span.y, span.x + span.width - x };
+            span.width = x - span.x;
+            skyline.insert(skyline.begin() + ii + 1, rest);
+            return ii + 1;
+        }
+    }
+    return (int)skyline.size();
+}
+
+void DynamicTexture::mergeSkyline()
+{
+    for (int ii=0;ii+1<(int)skyline.size();)
+    {
+        if (skyline[ii].y == skyline[ii+1].y)
+        {
+            skyline[ii].width += skyline[ii+1].width;
+            skyline.erase(skyline.begin() + ii + 1);
+        }
+        else
+            ii++;
+    }
+}
+
+void DynamicTexture::resetSkyline()
+{
+    skyline.clear();
+    skyline.push_back(SkylineSpan { 0, 0, numCell });
+    freeRegions.clear();
+    usedCells = 0;
+}
+
 void DynamicTexture::addRegionToClear(const Region &region)
 {
     std::lock_guard<std::mutex> guardLock(regionLock);
@@ -157,6 +415,11 @@ bool DynamicTexture::empty()
 void DynamicTexture::getUtilization(int &outNumCell,int &usedCell)
 {
     outNumCell = numCell*numCell;
+    if (layout == DynamicTextureSkyline)
+    {
+        usedCell = usedCells;
+        return;
+    }
     usedCell = 0;
     for (unsigned int ii=0;ii<numCell*numCell;ii++)
     {
@@ -212,7 +475,7 @@ DynamicTextureAtlas::TextureRegion::TextureRegion()
 
     
 DynamicTextureAtlas::DynamicTextureAtlas(const std::string &name,int texSize,int cellSize,TextureType format,int imageDepth,bool mainThreadMerge)
-    : name(name), texSize(texSize), cellSize(cellSize), format(format), imageDepth(imageDepth),  pixelFudge(0.0), mainThreadMerge(mainThreadMerge), clearTextures(false), interpType(TexInterpLinear)
+    : name(name), texSize(texSize), cellSize(cellSize), format(format), imageDepth(imageDepth),  pixelFudge(0.0), layout(DynamicTextureGrid), mainThreadMerge(mainThreadMerge), clearTextures(false), interpType(TexInterpLinear)
 {
     if (mainThreadMerge || MainThreadMerge)
     {
@@ -306,7 +569,7 @@ bool DynamicTextureAtlas::addTexture(SceneRenderer *sceneRender,const std::vecto
         for (unsigned int ii=0;ii<imageDepth;ii++)
         {
             DynamicTextureRef dynTex = sceneRender->makeDynamicTexture(name);
-            dynTex->setup(texSize,cellSize,format,clearTextures);
+            dynTex->setup(texSize,cellSize,format,clearTextures,layout);
             dynTex->setInterpType(interpType);
             dynTexVec->push_back(dynTex);
             dynTex->createInRenderer(sceneRender->getRenderSetupInfo());
@@ -514,18 +777,25 @@ void DynamicTextureAtlas::getUsage(int &numRegions,int &dynamicTextures)
     dynamicTextures = textures.size();
 }
 
-void DynamicTextureAtlas::log()
+void DynamicTextureAtlas::getUsage(int &numRegions,int &dynamicTextures,int &usedCells,int &numCells)
 {
-    int numCells=0,usedCells=0;
-    for (DynamicTextureSet::iterator it = textures.begin();
-         it != textures.end(); ++it)
+    getUsage(numRegions,dynamicTextures);
+
+    usedCells = 0;
+    numCells = 0;
+    for (const auto texVec : textures)
     {
-        DynamicTextureVec *texVec = *it;
         int thisNumCells,thisUsedCells;
         texVec->at(0)->getUtilization(thisNumCells,thisUsedCells);
         numCells += thisNumCells;
         usedCells += thisUsedCells;
     }
+}
+
+void DynamicTextureAtlas::log()
+{
+    int numRegions=0,numTextures=0,numCells=0,usedCells=0;
+    getUsage(numRegions,numTextures,usedCells,numCells);
 
     int texelSize = 4;
     switch (format)
@@ -31,9 +31,9 @@ DynamicTextureGLES::DynamicTextureGLES(const std::string &name)
 {
 }
 
-void DynamicTextureGLES::setup(int texSize,int cellSize,TextureType inType,bool clearTextures)
+void DynamicTextureGLES::setup(int texSize,int cellSize,TextureType inType,bool clearTextures,DynamicTextureLayout layout)
 {
-    DynamicTexture::setup(texSize,cellSize,inType,clearTextures);
+    DynamicTexture::setup(texSize,cellSize,inType,clearTextures,layout);
     
     // Check for the formats we'll accept
     switch (inType)
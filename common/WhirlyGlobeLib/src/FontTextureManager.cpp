@@ -17,6 +17,10 @@
  */
 
 #import "FontTextureManager.h"
+#import "LabelRenderer.h"
+#import "SharedAttributes.h"
+#import "SignedDistanceField.h"
+#import "Scene.h"
 #import "WhirlyVector.h"
 #import "WhirlyKitLog.h"
 
@@ -136,7 +140,9 @@ void FontTextureManager::init()
         // Let's do the biggest possible texture with small cells 32 bits deep
         // Note: Porting.  We've turned main thread merge on here, which shouldn't be needed.
         //       If we leave it off, we get corruption of the dynamic textures
-        texAtlas = new DynamicTextureAtlas("Font Texture Atlas",2048,16,TexTypeUnsignedByte,1,true);
+        // Glyphs are small and all different sizes, so pack them tightly with a skyline
+        texAtlas = new DynamicTextureAtlas("Font Texture Atlas",2048,4,TexTypeUnsignedByte,1,true);
+        texAtlas->setLayout(DynamicTextureSkyline);
     }
 }
             
@@ -155,6 +161,147 @@ void FontTextureManager::clear(ChangeSet &changes)
         delete drawStringRep;
     }
     fontManagers.clear();
+    cachedStrings.clear();
+    cachedStringMap.clear();
+}
+
+void FontTextureManager::setStringCacheSize(unsigned int size)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    maxCachedStrings = size;
+    while (cachedStrings.size() > maxCachedStrings)
+    {
+        cachedStringMap.erase(cachedStrings.back().first);
+        cachedStrings.pop_back();
+    }
+}
+
+std::unique_ptr<DrawableString> FontTextureManager::findCachedString(const std::string &key)
+{
+    const auto it = cachedStringMap.find(key);
+    if (it == cachedStringMap.end())
+    {
+        return nullptr;
+    }
+    const CachedString &cached = it->second->second;
+
+    // Glyphs come and go with the strings using them, so make sure every one
+    //  is still there and still in the same spot in the atlas
+    auto drawString = std::make_unique<DrawableString>();
+    auto drawStringRep = std::make_unique<DrawStringRep>(drawString->getId());
+    FontManager *fm = nullptr;
+    for (unsigned int ii=0;ii<cached.glyphs.size();ii++)
+    {
+        const CachedGlyph &glyph = cached.glyphs[ii];
+        if (!fm || fm->getId() != glyph.fontId)
+        {
+            const auto fmIt = fontManagers.find(glyph.fontId);
+            fm = (fmIt != fontManagers.end()) ? fmIt->second.get() : nullptr;
+        }
+        const FontManager::GlyphInfo *glyphInfo = fm ? fm->findGlyph(glyph.glyph) : nullptr;
+        if (!glyphInfo || glyphInfo->subTex.getId() != cached.glyphPolys[ii].subTex.getId())
+        {
+            cachedStrings.erase(it->second);
+            cachedStringMap.erase(it);
+            return nullptr;
+        }
+        drawStringRep->fontGlyphs[glyph.fontId].insert(glyph.glyph);
+    }
+
+    // Good to go, so pick up references the same way a new string would
+    for (const auto &fontGlyph : drawStringRep->fontGlyphs)
+    {
+        fontManagers[fontGlyph.first]->addGlyphRefs(fontGlyph.second);
+    }
+    drawString->glyphPolys = cached.glyphPolys;
+    drawString->mbr = cached.mbr;
+    drawString->sdf = cached.sdf;
+    drawStringReps.insert(drawStringRep.release());
+
+    // Move it to the front
+    cachedStrings.splice(cachedStrings.begin(), cachedStrings, it->second);
+
+    return drawString;
+}
+
+void FontTextureManager::addCachedString(const std::string &key,const DrawableString &drawStr,std::vector<CachedGlyph> glyphs)
+{
+    if (maxCachedStrings == 0 || glyphs.size() != drawStr.glyphPolys.size())
+    {
+        return;
+    }
+
+    const auto it = cachedStringMap.find(key);
+    if (it != cachedStringMap.end())
+    {
+        cachedStrings.erase(it->second);
+        cachedStringMap.erase(it);
+    }
+
+    cachedStrings.emplace_front(key, CachedString { drawStr.glyphPolys, std::move(glyphs), drawStr.mbr, drawStr.sdf });
+    cachedStringMap[key] = cachedStrings.begin();
+
+    while (cachedStrings.size() > maxCachedStrings)
+    {
+        cachedStringMap.erase(cachedStrings.back().first);
+        cachedStrings.pop_back();
+    }
+}
+
+void FontTextureManager::setSDFMode(bool enable,float inSdfSize,float inSdfSpread)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    sdfMode = enable;
+    sdfSize = inSdfSize;
+    sdfSpread = inSdfSpread;
+}
+
+SimpleIdentity FontTextureManager::getSDFProgramID(SimpleIdentity programID)
+{
+    const Program *defaultProg = scene->findProgramByName(MaplyScreenSpaceDefaultShader);
+    const Program *motionProg = scene->findProgramByName(MaplyScreenSpaceDefaultMotionShader);
+    const Program *sdfProg = nullptr;
+    if (programID == EmptyIdentity || (defaultProg && programID == defaultProg->getId()))
+        sdfProg = scene->findProgramByName(MaplyScreenSpaceSDFShader);
+    else if (motionProg && programID == motionProg->getId())
+        sdfProg = scene->findProgramByName(MaplyScreenSpaceSDFMotionShader);
+
+    return sdfProg ? sdfProg->getId() : EmptyIdentity;
+}
+
+bool FontTextureManager::canUseSDF(const LabelInfo &labelInfo)
+{
+    // Outlines are baked into the glyphs, so those still need their own
+    return sdfMode && labelInfo.outlineSize <= 0.0 &&
+           getSDFProgramID(labelInfo.programID) != EmptyIdentity;
+}
+
+RawData *FontTextureManager::buildSDFGlyph(const unsigned char *rgba,int width,int height,int rowBytes,int &outWidth,int &outHeight) const
+{
+    const int border = (int)std::ceil(sdfSpread);
+    outWidth = width + 2 * border;
+    outHeight = height + 2 * border;
+
+    // Copy the alpha into the middle of a bigger, empty image
+    std::vector<unsigned char> coverage(outWidth * outHeight, 0);
+    for (int y=0;y<height;y++)
+    {
+        const unsigned char *row = rgba + y * rowBytes;
+        unsigned char *outRow = &coverage[(y + border) * outWidth + border];
+        for (int x=0;x<width;x++)
+            outRow[x] = row[x * 4 + 3];
+    }
+
+    std::vector<unsigned char> distField;
+    BuildSignedDistanceField(&coverage[0], outWidth, outHeight, 1, outWidth, sdfSpread, distField);
+
+    std::vector<unsigned char> outData(outWidth * outHeight * 4, 255);
+    for (int ii=0;ii<outWidth * outHeight;ii++)
+        outData[ii * 4 + 3] = distField[ii];
+
+    return new MutableRawData(&outData[0], (unsigned int)outData.size());
 }
 
 void FontTextureManager::removeString(PlatformThreadInfo *inst, SimpleIdentity drawStringId,ChangeSet &changes,TimeInterval when)
@@ -0,0 +1,377 @@
+/*  InternedDictionaryC.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "InternedDictionaryC.h"
+#import "DictionaryC.h"
+#import "WhirlyKitLog.h"
+
+namespace WhirlyKit
+{
+
+int DictionaryValueC::getInt(int defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone:   return defVal;
+        case DictTypeInt:    return intVal;
+        case DictTypeDouble: return (int)doubleVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to int", type);
+            return defVal;
+    }
+}
+
+int64_t DictionaryValueC::getInt64(int64_t defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone:   return defVal;
+        case DictTypeInt:    return intVal;
+        case DictTypeDouble: return (int64_t)doubleVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to int64", type);
+            return defVal;
+    }
+}
+
+SimpleIdentity DictionaryValueC::getIdentity() const
+{
+    switch (type)
+    {
+        case DictTypeNone:   return EmptyIdentity;
+        case DictTypeInt:    return intVal;
+        case DictTypeDouble: return (SimpleIdentity)doubleVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to identity", type);
+            return EmptyIdentity;
+    }
+}
+
+bool DictionaryValueC::getBool(bool defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone: return defVal;
+        case DictTypeInt:  return intVal != 0;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to bool", type);
+            return defVal;
+    }
+}
+
+RGBAColor DictionaryValueC::getColor(const RGBAColor &defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone:
+            return defVal;
+        case DictTypeString:
+        {
+            // We're looking for #RRGGBBAA, #RRGGBB, #RGBA, or #RGB
+            if (stringVal.length() < 4 || stringVal[0] != '#')
+                return defVal;
+
+            const std::string str(stringVal.substr(1));
+            return parseColor(str.c_str(), defVal);
+        }
+        case DictTypeInt:
+            return ARGBtoRGBAColor(intVal);
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to color", type);
+            return defVal;
+    }
+}
+
+double DictionaryValueC::getDouble(double defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone:   return defVal;
+        case DictTypeInt:    return intVal;
+        case DictTypeDouble: return doubleVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to double", type);
+            return defVal;
+    }
+}
+
+std::string DictionaryValueC::getString(const std::string &defVal) const
+{
+    switch (type)
+    {
+        case DictTypeNone:   return defVal;
+        case DictTypeString: return std::string(stringVal);
+        case DictTypeInt:    return std::to_string(intVal);
+        case DictTypeDouble: return std::to_string(doubleVal);
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to string", type);
+            return defVal;
+    }
+}
+
+DictionaryEntryRef DictionaryValueC::getEntry() const
+{
+    switch (type)
+    {
+        case DictTypeString: return std::make_shared<DictionaryEntryCString>(std::string(stringVal));
+        case DictTypeInt:    return std::make_shared<DictionaryEntryCBasic>(intVal);
+        case DictTypeDouble: return std::make_shared<DictionaryEntryCBasic>(doubleVal);
+        default:             return DictionaryEntryRef();
+    }
+}
+
+uint32_t InternedDictionaryTable::addKey(std::string_view key)
+{
+    std::string keyStr(key);
+    const auto it = keyMap.find(keyStr);
+    if (it != keyMap.end())
+    {
+        return it->second;
+    }
+
+    const auto which = (uint32_t)keys.size();
+    keyMap.emplace(keyStr, which);
+    keys.push_back(std::move(keyStr));
+    return which;
+}
+
+uint32_t InternedDictionaryTable::addString(std::string_view val)
+{
+    values.push_back(Value { DictTypeString, 0, 0.0, std::string(val) });
+    return (uint32_t)values.size() - 1;
+}
+
+uint32_t InternedDictionaryTable::addInt(int val)
+{
+    values.push_back(Value { DictTypeInt, val, 0.0, std::string() });
+    return (uint32_t)values.size() - 1;
+}
+
+uint32_t InternedDictionaryTable::addDouble(double val)
+{
+    values.push_back(Value { DictTypeDouble, 0, val, std::string() });
+    return (uint32_t)values.size() - 1;
+}
+
+int InternedDictionaryTable::findKey(const std::string &key) const
+{
+    const auto it = keyMap.find(key);
+    return (it != keyMap.end()) ? (int)it->second : -1;
+}
+
+DictionaryValueC InternedDictionaryTable::getValue(uint32_t which) const
+{
+    const auto &val = values[which];
+
+    DictionaryValueC ret;
+    ret.type = val.type;
+    ret.intVal = val.intVal;
+    ret.doubleVal = val.doubleVal;
+    ret.stringVal = val.stringVal;
+    return ret;
+}
+
+InternedDictionaryC::InternedDictionaryC(InternedDictionaryTableRef table,std::vector<Field> fields)
+    : table(std::move(table)), fields(std::move(fields))
+{
+}
+
+MutableDictionaryRef InternedDictionaryC::copy() const
+{
+    if (dict)
+    {
+        return dict->copy();
+    }
+    return std::make_shared<InternedDictionaryC>(table, fields);
+}
+
+DictionaryValueC InternedDictionaryC::find(const std::string &name) const
+{
+    // Look the key up once, then it's just comparing indices
+    const int key = table ? table->findKey(name) : -1;
+    if (key >= 0)
+    {
+        for (const auto &field : fields)
+        {
+            if (field.key == (uint32_t)key)
+            {
+                return table->getValue(field.value);
+            }
+        }
+    }
+    return DictionaryValueC();
+}
+
+MutableDictionaryC &InternedDictionaryC::modify()
+{
+    if (!dict)
+    {
+        dict = std::make_shared<MutableDictionaryC>((int)fields.size());
+        for (const auto &field : fields)
+        {
+            const auto &key = table->getKey(field.key);
+            const auto val = table->getValue(field.value);
+            switch (val.type)
+            {
+                case DictTypeString: dict->setString(key, std::string(val.stringVal)); break;
+                case DictTypeInt:    dict->setInt(key, val.intVal);                     break;
+                case DictTypeDouble: dict->setDouble(key, val.doubleVal);               break;
+                default: break;
+            }
+        }
+
+        // Don't need these any more
+        table.reset();
+        fields.clear();
+        fields.shrink_to_fit();
+    }
+    return *dict;
+}
+
+int InternedDictionaryC::count() const
+{
+    return dict ? dict->count() : (int)fields.size();
+}
+
+bool InternedDictionaryC::empty() const
+{
+    return dict ? dict->empty() : fields.empty();
+}
+
+bool InternedDictionaryC::hasField(const std::string &name) const
+{
+    return dict ? dict->hasField(name) : (find(name).type != DictTypeNone);
+}
+
+DictionaryType InternedDictionaryC::getType(const std::string &name) const
+{
+    return dict ? dict->getType(name) : find(name).type;
+}
+
+int InternedDictionaryC::getInt(const std::string &name,int defVal) const
+{
+    return dict ? dict->getInt(name, defVal) : find(name).getInt(defVal);
+}
+
+int64_t InternedDictionaryC::getInt64(const std::string &name,int64_t defVal) const
+{
+    return dict ? dict->getInt64(name, defVal) : find(name).getInt64(defVal);
+}
+
+SimpleIdentity InternedDictionaryC::getIdentity(const std::string &name) const
+{
+    return dict ? dict->getIdentity(name) : find(name).getIdentity();
+}
+
+bool InternedDictionaryC::getBool(const std::string &name,bool defVal) const
+{
+    return dict ? dict->getBool(name, defVal) : find(name).getBool(defVal);
+}
+
+RGBAColor InternedDictionaryC::getColor(const std::string &name,const RGBAColor &defVal) const
+{
+    return dict ? dict->getColor(name, defVal) : find(name).getColor(defVal);
+}
+
+double InternedDictionaryC::getDouble(const std::string &name,double defVal) const
+{
+    return dict ? dict->getDouble(name, defVal) : find(name).getDouble(defVal);
+}
+
+std::string InternedDictionaryC::getString(const std::string &name) const
+{
+    return getString(name, std::string());
+}
+
+std::string InternedDictionaryC::getString(const std::string &name,const std::string &defVal) const
+{
+    return dict ? dict->getString(name, defVal) : find(name).getString(defVal);
+}
+
+DictionaryRef InternedDictionaryC::getDict(const std::string &name) const
+{
+    // The table only holds simple values
+    return dict ? dict->getDict(name) : DictionaryRef();
+}
+
+DictionaryEntryRef InternedDictionaryC::getEntry(const std::string &name) const
+{
+    return dict ? dict->getEntry(name) : find(name).getEntry();
+}
+
+std::vector<DictionaryEntryRef> InternedDictionaryC::getArray(const std::string &name) const
+{
+    return dict ? dict->getArray(name) : std::vector<DictionaryEntryRef>();
+}
+
+std::vector<std::string> InternedDictionaryC::getKeys() const
+{
+    if (dict)
+    {
+        return dict->getKeys();
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(fields.size());
+    for (const auto &field : fields)
+    {
+        keys.push_back(table->getKey(field.key));
+    }
+    return keys;
+}
+
+void InternedDictionaryC::clear()
+{
+    modify().clear();
+}
+
+void InternedDictionaryC::removeField(const std::string &name)
+{
+    modify().removeField(name);
+}
+
+void InternedDictionaryC::setInt(const std::string &name,int val)
+{
+    modify().setInt(name, val);
+}
+
+void InternedDictionaryC::setInt64(const std::string &name,int64_t val)
+{
+    modify().setInt64(name, val);
+}
+
+void InternedDictionaryC::setIdentifiable(const std::string &name,SimpleIdentity val)
+{
+    modify().setIdentifiable(name, val);
+}
+
+void InternedDictionaryC::setDouble(const std::string &name,double val)
+{
+    modify().setDouble(name, val);
+}
+
+void InternedDictionaryC::setString(const std::string &name,const std::string &val)
+{
+    modify().setString(name, val);
+}
+
+void InternedDictionaryC::addEntries(const Dictionary *other)
+{
+    modify().addEntries(other);
+}
+
+}
@@ -123,6 +123,10 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,
 {
     const TimeInterval curTime = scene->getCurrentTime();
 
+    // Distance field glyphs need a different shader than everything else
+    const SimpleIdentity sdfProgID = (fontTexManager && fontTexManager->getSDFMode()) ?
+                                        fontTexManager->getSDFProgramID(labelInfo->programID) : EmptyIdentity;
+
     for (const auto label : labels)
     {
         const RGBAColor &theBackColor = labelInfo->backColor;
@@ -448,27 +452,36 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,
                     default: break;
                 }
                 
+                // The glyphs are laid out relative to the string, so they just need to be moved into place.
+                // Strings the font manager has seen before come back without being laid out again.
+                const Point2d lineOrg = label->screenOffset + Point2d(0,offsetY) + iconOff + justifyOff + lineOff;
+
                 // Turn the glyph polys into simple geometry
                 // We do this in a weird order to stick the shadow underneath
                 for (int ss=((theShadowSize > 0.0) ? 0 : 1);ss<2;ss++)
                 {
-                    const Point2d soff = (ss == 1) ? Point2d(0,0) : Point2d(theShadowSize,theShadowSize);
+                    const Point2d org = (ss == 1) ? lineOrg : Point2d(lineOrg + Point2d(theShadowSize,theShadowSize));
                     const RGBAColor color = (ss == 1) ? (embeddedColor ? RGBAColor::white() : theTextColor) : theShadowColor;
                     for (const auto &poly : drawStr->glyphPolys)
                     {
+                        const Point2d ll = poly.pts[0].cast<double>() + org;
+                        const Point2d ur = poly.pts[1].cast<double>() + org;
+
                         // Note: Ignoring the desired size in favor of the font size
                         ScreenSpaceConvexGeometry smGeom;
-                        smGeom.progID = labelInfo->programID;
-                        smGeom.coords.push_back(Point2d(poly.pts[1].x()+label->screenOffset.x(),poly.pts[0].y()+label->screenOffset.y() + offsetY) + soff + iconOff + justifyOff + lineOff);
+                        smGeom.progID = (drawStr->sdf && sdfProgID != EmptyIdentity) ? sdfProgID : labelInfo->programID;
+                        smGeom.coords.reserve(4);
+                        smGeom.texCoords.reserve(4);
+                        smGeom.coords.emplace_back(ur.x(),ll.y());
                         smGeom.texCoords.emplace_back(poly.texCoords[1].u(),poly.texCoords[0].v());
                         
-                        smGeom.coords.push_back(Point2d(poly.pts[1].x()+label->screenOffset.x(),poly.pts[1].y()+label->screenOffset.y() + offsetY) + soff + iconOff + justifyOff + lineOff);
+                        smGeom.coords.emplace_back(ur.x(),ur.y());
                         smGeom.texCoords.emplace_back(poly.texCoords[1].u(),poly.texCoords[1].v());
                         
-                        smGeom.coords.push_back(Point2d(poly.pts[0].x()+label->screenOffset.x(),poly.pts[1].y()+label->screenOffset.y() + offsetY) + soff + iconOff + justifyOff + lineOff);
+                        smGeom.coords.emplace_back(ll.x(),ur.y());
                         smGeom.texCoords.emplace_back(poly.texCoords[0].u(),poly.texCoords[1].y());
                         
-                        smGeom.coords.push_back(Point2d(poly.pts[0].x()+label->screenOffset.x(),poly.pts[0].y()+label->screenOffset.y() + offsetY) + soff + iconOff + justifyOff + lineOff);
+                        smGeom.coords.emplace_back(ll.x(),ll.y());
                         smGeom.texCoords.emplace_back(poly.texCoords[0].u(),poly.texCoords[0].v());
                         
                         smGeom.texIDs.push_back(poly.subTex.texId);
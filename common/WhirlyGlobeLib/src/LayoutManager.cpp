@@ -23,6 +23,7 @@
 #import "LinearTextBuilder.h"
 #import "WhirlyKitLog.h"
 #import "Expect.h"
+#import "Platform.h"
 
 using namespace Eigen;
 
@@ -170,6 +171,7 @@ void LayoutManager::setOverrideUUIDs(const std::set<std::string> &uuids)
     overrideUUIDs.clear();
     overrideUUIDs.reserve(uuids.size());
     overrideUUIDs.insert(uuids.begin(), uuids.end());
+    layoutGeneration++;
 }
 
 void LayoutManager::addLayoutObjects(const std::vector<LayoutObject> &newObjects)
@@ -239,6 +241,7 @@ void LayoutManager::addLayoutObjects(std::vector<LayoutObjectEntryRef> &&toAdd)
     std::lock_guard<std::mutex> guardLock(lock);
     layoutObjects.insert(std::make_move_iterator(toAdd.begin()),
                          std::make_move_iterator(toAdd.end()));
+    layoutGeneration++;
     hasUpdates = true;
 }
 
@@ -269,6 +272,8 @@ void LayoutManager::enableLayoutObjects(const SimpleIDSet &theObjectIds,bool ena
             entry->obj.enable = enable;
         }
     }
+    layoutGeneration++;
+    screenSpaceGeneration++;
     hasUpdates = true;
 }
 
@@ -288,6 +293,8 @@ void LayoutManager::removeLayoutObjects(const SimpleIDSet &oldObjectIds)
         key->setId(oldObjectId);
         if (layoutObjects.erase(key))
         {
+            layoutGeneration++;
+            screenSpaceGeneration++;
             hasUpdates = true;
             hasRemoves = true;
         }
@@ -311,6 +318,53 @@ void LayoutManager::setFadeEnabled(bool enable)
     hasUpdates = true;
 }
 
+void LayoutManager::setOverlapIndex(OverlapHelper::IndexType indexType)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    overlapIndex = indexType;
+    hasUpdates = true;
+}
+
+void LayoutManager::setLayoutPool(ThreadPoolRef pool)
+{
+    // Layout reads this without the lock
+    std::atomic_store(&layoutPool, std::move(pool));
+}
+
+void LayoutManager::setClusterIndex(bool enable)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    clusterIndexEnabled = enable;
+    hasUpdates = true;
+}
+
+PerformanceTimer LayoutManager::getLayoutStats() const
+{
+    std::lock_guard<std::mutex> statsGuard(statsLock);
+    return layoutStats;
+}
+
+void LayoutManager::clearLayoutStats()
+{
+    std::lock_guard<std::mutex> statsGuard(statsLock);
+    layoutStats.clear();
+}
+
+void LayoutManager::setIncrementalLayout(bool enable)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    incrementalLayout = enable;
+    layoutGeneration++;
+    hasUpdates = true;
+}
+
+void LayoutManager::setIncrementalThreshold(float pixels)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    incrementalThreshold = pixels;
+    hasUpdates = true;
+}
+
 void LayoutManager::setFadeInTime(TimeInterval time)
 {
     std::lock_guard<std::mutex> guardLock(lock);
@@ -475,6 +529,14 @@ static const int OverlapSampleY = 60;
 // Now much around the screen we'll take into account
 static const float ScreenBuffer = 0.1;
 
+// Below this many objects it's not worth handing the projection to the layout pool
+static const size_t LayoutPoolMinObjects = 1024;
+
+// Cluster groups smaller than this are clustered one object at a time, even with the index turned on
+static const size_t ClusterIndexMinObjects = 4096;
+// Pre-clustered points end up at most this fraction of the cluster size apart on the screen
+static const double ClusterIndexSizeFraction = 0.5;
+
 bool LayoutManager::calcScreenPt(Point2f &objPt,const LayoutObject *layoutObj,
                                  const ViewStateRef &viewState,
                                  const Mbr &screenMbr,const Point2f &frameBufferSize)
@@ -625,6 +687,8 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
     if (localLayoutObjects.empty())
         return false;
 
+    const TimeInterval rulesStartTime = TimeGetCurrent();
+
     bool hadChanges = false;
 
     ClusteredObjectsSet clusterGroups;
@@ -644,142 +708,232 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
     const Matrix4d fullNormalMatrix = viewState->fullNormalMatrices[0];
     const Matrix4d normalMat = viewState->fullMatrices[0].inverse().transpose();
 
-    // Turn everything off and sort by importance
+    // Extents for the layout helpers
+    const Point2f frameBufferSize = renderer->getFramebufferSize();
+    const Mbr screenMbr(frameBufferSize * -ScreenBuffer,
+                        frameBufferSize * (1.0 + ScreenBuffer));
+
+    // Need to scale for retina displays
+    const float resScale = renderer->getScale();
+
+    // Visibility and screen projection for everything that's enabled
+    std::vector<const LayoutObjectEntryRef *> enabledObjs;
+    enabledObjs.reserve(localLayoutObjects.size());
     for (const auto &layoutObjRef : localLayoutObjects)
     {
-        auto * const obj = layoutObjRef.get();
-        if (obj->obj.enable)
+        if (layoutObjRef->obj.enable)
         {
-            if (UNLIKELY(cancelLayout))
+            enabledObjs.push_back(&layoutObjRef);
+        }
+    }
+    std::vector<char> enabledUse(enabledObjs.size(), false);
+
+    // Each object only looks at itself here, so this can be spread across threads
+    const auto projectObj = [&](int which)
+    {
+        if (UNLIKELY(cancelLayout))
+        {
+            return;
+        }
+
+        auto * const obj = enabledObjs[which]->get();
+        bool use = obj->obj.state.minVis == DrawVisibleInvalid ||
+                   obj->obj.state.maxVis == DrawVisibleInvalid;
+        if (!use)
+        {
+            if (globeViewState)
             {
-                break;
+                use = obj->obj.state.minVis < globeViewState->heightAboveGlobe &&
+                      globeViewState->heightAboveGlobe < obj->obj.state.maxVis;
             }
+            else
+            {
+                use = obj->obj.state.minVis < mapViewState->heightAboveSurface &&
+                      mapViewState->heightAboveSurface < obj->obj.state.maxVis;
+            }
+        }
 
-            bool use = obj->obj.state.minVis == DrawVisibleInvalid ||
-                       obj->obj.state.maxVis == DrawVisibleInvalid;
-            if (!use)
+        // Make sure this one isn't behind the globe
+        if (use && globeViewState)
+        {
+            // Layout shape following doesn't work with this check
+            if (obj->obj.layoutShape.empty())
             {
-                if (globeViewState)
-                {
-                    use = obj->obj.state.minVis < globeViewState->heightAboveGlobe &&
-                          globeViewState->heightAboveGlobe < obj->obj.state.maxVis;
-                }
-                else
-                {
-                    use = obj->obj.state.minVis < mapViewState->heightAboveSurface &&
-                          mapViewState->heightAboveSurface < obj->obj.state.maxVis;
-                }
+                // Make sure this one is facing toward the viewer
+                use = CheckPointAndNormFacing(obj->obj.worldLoc,obj->obj.worldLoc.normalized(),
+                                              fullMatrix,fullNormalMatrix) > 0.0;
             }
+        }
+        enabledUse[which] = use;
+
+        // Where it lands on the screen, for point placement.  Clusters and shapes do their own.
+        obj->projInside = false;
+        if (use && obj->obj.clusterGroup < 0 && obj->obj.layoutShape.empty())
+        {
+            obj->projPt = Point2f(0.0, 0.0);
+            obj->projInside = calcScreenPt(obj->projPt,&obj->obj,viewState,screenMbr,frameBufferSize);
 
-            // Make sure this one isn't behind the globe
-            if (use && globeViewState)
+            // Deal with the rotation
+            obj->projRot = Matrix2d::Identity();
+            if (obj->projInside && obj->obj.rotation != 0.0)
             {
-                // Layout shape following doesn't work with this check
-                if (obj->obj.layoutShape.empty())
-                {
-                    // Make sure this one is facing toward the viewer
-                    use = CheckPointAndNormFacing(obj->obj.worldLoc,obj->obj.worldLoc.normalized(),
-                                                  fullMatrix,fullNormalMatrix) > 0.0;
-                }
+                float screenRot = 0.0;
+                obj->projRot = calcScreenRot(screenRot, viewState, globeViewState, &obj->obj,
+                                             obj->projPt, modelTrans, normalMat, frameBufferSize);
             }
+        }
+    };
+
+    const TimeInterval projectStartTime = TimeGetCurrent();
+    const auto pool = std::atomic_load(&layoutPool);
+    if (pool && enabledObjs.size() >= LayoutPoolMinObjects)
+    {
+        // The view state works out its frustum the first time it's needed, do that before going wide
+        if (viewState->ll.x() == viewState->ur.x())
+        {
+            viewState->calcFrustumWidth((unsigned int)frameBufferSize.x(),(unsigned int)frameBufferSize.y());
+        }
+        pool->parallelFor(0, (int)enabledObjs.size(), (int)LayoutPoolMinObjects / 4, projectObj);
+    }
+    else
+    {
+        for (int ii = 0; ii < (int)enabledObjs.size(); ii++)
+        {
+            projectObj(ii);
+        }
+    }
+    const TimeInterval projectTime = TimeGetCurrent() - projectStartTime;
+
+    // In incremental mode the sorted order from last time is good unless something changed visibility
+    bool reuseOrder = incrementalLayout && sortedLayoutValid;
 
-            if (use)
+    // Turn everything off and sort by importance
+    for (size_t ii = 0; ii < enabledObjs.size(); ii++)
+    {
+        const auto &layoutObjRef = *enabledObjs[ii];
+        auto * const obj = layoutObjRef.get();
+
+        if (UNLIKELY(cancelLayout))
+        {
+            break;
+        }
+
+        const bool use = enabledUse[ii];
+        if (use != obj->used)
+        {
+            obj->used = use;
+            reuseOrder = false;
+            sortedLayoutValid = false;
+        }
+
+        if (use)
+        {
+            obj->newCluster = -1;
+            if (obj->obj.clusterGroup > -1)
             {
-                obj->newCluster = -1;
-                if (obj->obj.clusterGroup > -1)
+                // Put the entry in the right cluster
+                ClusteredObjects findClusterObj(obj->obj.clusterGroup);
+                const auto cit = clusterGroups.find(&findClusterObj);
+                if (cit == clusterGroups.end())
                 {
-                    // Put the entry in the right cluster
-                    ClusteredObjects findClusterObj(obj->obj.clusterGroup);
-                    const auto cit = clusterGroups.find(&findClusterObj);
-                    if (cit == clusterGroups.end())
-                    {
-                        // Create a new cluster object
-                        auto newClusterObj = new ClusteredObjects(obj->obj.clusterGroup);
-                        newClusterObj->addObject(layoutObjRef);
+                    // Create a new cluster object
+                    auto newClusterObj = new ClusteredObjects(obj->obj.clusterGroup);
+                    newClusterObj->addObject(layoutObjRef);
 
-                        clusterGroups.insert(newClusterObj);
+                    clusterGroups.insert(newClusterObj);
 
-                        hadChanges = true;
-                    }
-                    else
-                    {
-                        const auto result = (*cit)->addObject(layoutObjRef);
+                    hadChanges = true;
+                }
+                else
+                {
+                    const auto result = (*cit)->addObject(layoutObjRef);
 
-                        // Was there already a matching item present?
-                        if (result.first && result.first.get() != layoutObjRef.get())
+                    // Was there already a matching item present?
+                    if (result.first && result.first.get() != layoutObjRef.get())
+                    {
+                        // If the new object replaced an existing one, and that replaced
+                        // object has a current cluster, copy it to the new one.
+                        if (result.second && layoutObjRef->currentCluster == -1 &&
+                                             result.first->currentCluster != -1)
                         {
-                            // If the new object replaced an existing one, and that replaced
-                            // object has a current cluster, copy it to the new one.
-                            if (result.second && layoutObjRef->currentCluster == -1 &&
-                                                 result.first->currentCluster != -1)
-                            {
-                                // The new object replaced an older one
-                                layoutObjRef->currentCluster = result.first->currentCluster;
-                            }
-                            // If the new object was not added, and it has a current cluster,
-                            // copy it to the object that's already present.
-                            else if (!result.second && layoutObjRef->currentCluster != -1 &&
-                                                       result.first->currentCluster == -1)
-                            {
-                                result.first->currentCluster = layoutObjRef->currentCluster;
-                            }
+                            // The new object replaced an older one
+                            layoutObjRef->currentCluster = result.first->currentCluster;
+                        }
+                        // If the new object was not added, and it has a current cluster,
+                        // copy it to the object that's already present.
+                        else if (!result.second && layoutObjRef->currentCluster != -1 &&
+                                                   result.first->currentCluster == -1)
+                        {
+                            result.first->currentCluster = layoutObjRef->currentCluster;
                         }
                     }
-
-                    obj->newEnable = false;
                 }
-                else    // Not a cluster
-                {
-                    if (layoutObjs.empty())
-                    {
-                        layoutObjs.reserve(localLayoutObjects.size());
-                    }
 
-                    if (obj->obj.uniqueID.empty())
-                    {
-                        layoutObjs.emplace_back(layoutObjRef);
-                    }
-                    else
-                    {
-                        // Add it to a container for its unique name
-                        LayoutObjectContainer &dest = uniqueLayoutObjs[obj->obj.uniqueID];
+                obj->newEnable = false;
+            }
+        }
+        else
+        {
+            obj->newEnable = false;
+            obj->newCluster = -1;
+        }
 
-                        // See if we're overriding this importance
-                        dest.importance = obj->obj.importance;
-                        if (!obj->obj.uniqueID.empty() && localOverrideUUIDs.find(obj->obj.uniqueID) != localOverrideUUIDs.end())
-                            dest.importance = MAXFLOAT;
+        // Note: Update this for clusters
+        if ((use && !obj->currentEnable) || (!use && obj->currentEnable))
+        {
+            hadChanges = true;
+        }
+    }
 
-                        dest.objs.push_back(layoutObjRef);
-                    }
-                }
+    // Clusters are worked out fresh every time
+    if (!clusterGroups.empty())
+    {
+        reuseOrder = false;
+    }
+
+    // Collect the active objects that aren't clustered, unless we can use last time's order
+    if (!reuseOrder && !cancelLayout)
+    {
+        for (const auto &layoutObjRef : localLayoutObjects)
+        {
+            const auto * const obj = layoutObjRef.get();
+            if (!obj->obj.enable || !obj->used || obj->obj.clusterGroup > -1)
+            {
+                continue;
             }
-            else
+
+            if (layoutObjs.empty())
             {
-                obj->newEnable = false;
-                obj->newCluster = -1;
+                layoutObjs.reserve(localLayoutObjects.size());
             }
 
-            // Note: Update this for clusters
-            if ((use && !obj->currentEnable) || (!use && obj->currentEnable))
+            if (obj->obj.uniqueID.empty())
             {
-                hadChanges = true;
+                layoutObjs.emplace_back(layoutObjRef);
             }
-        }
-    }
+            else
+            {
+                // Add it to a container for its unique name
+                LayoutObjectContainer &dest = uniqueLayoutObjs[obj->obj.uniqueID];
 
-    // Extents for the layout helpers
-    const Point2f frameBufferSize = renderer->getFramebufferSize();
-    const Mbr screenMbr(frameBufferSize * -ScreenBuffer,
-                        frameBufferSize * (1.0 + ScreenBuffer));
+                // See if we're overriding this importance
+                dest.importance = obj->obj.importance;
+                if (localOverrideUUIDs.find(obj->obj.uniqueID) != localOverrideUUIDs.end())
+                    dest.importance = MAXFLOAT;
 
-    // Need to scale for retina displays
-    const float resScale = renderer->getScale();
+                dest.objs.push_back(layoutObjRef);
+            }
+        }
+    }
 
+    TimeInterval clusterTime = -1.0;
     if (clusterGen)
     {
+        const TimeInterval clusterStartTime = TimeGetCurrent();
         runLayoutClustering(threadInfo, layoutObjs, clusterGroups, clusterEntries,
                             outClusterParams, viewState, mapViewState, globeViewState,
                             frameBufferSize, screenMbr, modelTrans, normalMat);
+        clusterTime = TimeGetCurrent() - clusterStartTime;
     }
 
     if (UNLIKELY(cancelLayout))
@@ -790,14 +944,31 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 //    NSLog(@"----Starting Layout----");
 
     // Set up the overlap sampler
-    OverlapHelper overlapMan(screenMbr,OverlapSampleX,OverlapSampleY,localLayoutObjects.size());
+    OverlapHelper overlapMan(screenMbr,OverlapSampleX,OverlapSampleY,localLayoutObjects.size(),overlapIndex);
 
-    // Add in the unique objects, cluster entries and then sort them all
-    for (auto &it : uniqueLayoutObjs)
+    if (!reuseOrder)
     {
-        layoutObjs.push_back(it.second);
+        // Add in the unique objects, cluster entries and then sort them all
+        for (auto &it : uniqueLayoutObjs)
+        {
+            layoutObjs.push_back(it.second);
+        }
+        std::sort(layoutObjs.begin(),layoutObjs.end());
+
+        // Hang on to the order for next time
+        if (incrementalLayout && clusterGroups.empty() && !cancelLayout)
+        {
+            sortedLayoutObjs = std::move(layoutObjs);
+            sortedLayoutValid = true;
+            reuseOrder = true;
+        }
+        else
+        {
+            sortedLayoutObjs.clear();
+            sortedLayoutValid = false;
+        }
     }
-    std::sort(layoutObjs.begin(),layoutObjs.end());
+    LayoutContainerVec &sortedObjs = reuseOrder ? sortedLayoutObjs : layoutObjs;
 
     // Clusters have priority in the overlap.
     for (const auto &it : clusterEntries)
@@ -814,9 +985,14 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 
     std::unordered_multimap<std::string, LayoutObjectEntryRef> mergeMap(localLayoutObjects.size());
 
+    // Objects that moved less than this are stable, for incremental layout
+    const float stableDist2 = incrementalThreshold * incrementalThreshold;
+
     // Lay out the various objects that are active
     int numSoFar = 0;
-    for (auto &container : layoutObjs)
+    int numConsidered = 0, numOverlapped = 0, numOverLimit = 0, numShapes = 0;
+    TimeInterval shapeTime = 0.0;
+    for (auto &container : sortedObjs)
     {
         if (UNLIKELY(cancelLayout))
         {
@@ -828,6 +1004,10 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 
         // Start with a max objects check
         bool isActive = (maxDisplayObjects == 0 || (numSoFar < maxDisplayObjects));
+        if (!isActive)
+        {
+            numOverLimit += (int)container.objs.size();
+        }
 
         // Sort the objects by importance within their container, large to small
         std::sort(container.objs.begin(),container.objs.end(),
@@ -845,6 +1025,7 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
                 break;
             }
 
+            numConsidered++;
             layoutObj->newEnable = false;
             layoutObj->obj.layoutModelPlaces.clear();
             layoutObj->obj.layoutPlaces.clear();
@@ -852,7 +1033,10 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
             // Layout along a shape
             if (!layoutObj->obj.layoutShape.empty())
             {
+                const TimeInterval shapeStartTime = TimeGetCurrent();
                 layoutAlongShape(layoutObj, viewState, frameBufferSize, overlapMan, changes, isActive, hadChanges);
+                shapeTime += TimeGetCurrent() - shapeStartTime;
+                numShapes++;
             }
             else
             {
@@ -864,19 +1048,21 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 
                 if (isActive)
                 {
-                    Point2f objPt;
-                    bool isInside = calcScreenPt(objPt,&layoutObj->obj,viewState,screenMbr,frameBufferSize);
+                    // Screen position and rotation were worked out up front
+                    const Point2f &objPt = layoutObj->projPt;
+                    const Matrix2d &screenRotMat = layoutObj->projRot;
 
-                    isActive &= isInside;
+                    isActive &= layoutObj->projInside;
 
-                    // Deal with the rotation
-                    float screenRot = 0.0;
-                    Matrix2d screenRotMat = Matrix2d::Identity();
-                    if (layoutObj->obj.rotation != 0.0)
+                    // Objects that were on last time and haven't moved much try their old spot first
+                    int prevOrient = -1;
+                    if (incrementalLayout && layoutObj->currentEnable && layoutObj->orient >= 0 &&
+                        (objPt - layoutObj->screenPt).squaredNorm() <= stableDist2)
                     {
-                        screenRotMat = calcScreenRot(screenRot, viewState, globeViewState, &layoutObj->obj,
-                                                     objPt, modelTrans, normalMat, frameBufferSize);
+                        prevOrient = layoutObj->orient;
                     }
+                    layoutObj->screenPt = objPt;
+                    layoutObj->orient = -1;
 
                     // Now for the overlap checks
                     if (isActive)
@@ -885,8 +1071,12 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
                         if (!layoutObj->obj.layoutPts.empty())
                         {
                             bool validOrient = false;
-                            for (unsigned int orient=0;orient<6;orient++)
+                            for (int which=(prevOrient >= 0 ? -1 : 0);which<6;which++)
                             {
+                                const unsigned int orient = (which < 0) ? prevOrient : which;
+                                if (which >= 0 && which == prevOrient)
+                                    continue;
+
                                 // May only want to be placed certain ways.  Fair enough.
                                 if (!(layoutObj->obj.acceptablePlacement & (1U<<orient)))
                                     continue;
@@ -928,6 +1118,7 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 
                                     validOrient = true;
                                     pickedOne = true;
+                                    layoutObj->orient = (int)orient;
                                     break;
                                 }
 
@@ -940,6 +1131,10 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
                             }
 
                             isActive = validOrient;
+                            if (!validOrient)
+                            {
+                                numOverlapped++;
+                            }
                         }
                     }
 
@@ -1004,6 +1199,45 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
 
     //wkLogLevel(Debug, "----Finished layout---- changes=%d", hadChanges);
 
+    if (UNLIKELY(cancelLayout))
+    {
+        return hadChanges;
+    }
+
+    int numPlaced = 0;
+    for (const auto &container : sortedObjs)
+    {
+        for (const auto &layoutObj : container.objs)
+        {
+            numPlaced += layoutObj->newEnable ? 1 : 0;
+        }
+    }
+    int numClustered = 0;
+    for (const auto &clusterEntry : clusterEntries)
+    {
+        numClustered += (int)clusterEntry.objectIDs.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> statsGuard(statsLock);
+        layoutStats.addTime("Layout rules", TimeGetCurrent() - rulesStartTime);
+        layoutStats.addTime("Layout projection", projectTime);
+        if (clusterTime >= 0.0)
+        {
+            layoutStats.addTime("Layout clustering", clusterTime);
+        }
+        if (numShapes > 0)
+        {
+            layoutStats.addTime("Layout along shape", shapeTime);
+        }
+        layoutStats.addCount("Layout objects considered", numConsidered);
+        layoutStats.addCount("Layout objects placed", numPlaced);
+        layoutStats.addCount("Layout objects overlapped", numOverlapped);
+        layoutStats.addCount("Layout objects over limit", numOverLimit);
+        layoutStats.addCount("Layout objects clustered", numClustered);
+        layoutStats.addCount("Layout clusters", (int)clusterEntries.size());
+    }
+
     return hadChanges;
 }
 
@@ -1021,69 +1255,239 @@ void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
                                         const Matrix4d &normalMat)
 {
     const float resScale = renderer->getScale();
+    const auto pool = std::atomic_load(&layoutPool);
+    const bool useIndex = clusterIndexEnabled && mapViewState && !globeViewState;
 
     clusterGen->startLayoutObjects(threadInfo);
 
-    // Lay out the cluster groups in order
-    for (const auto &cluster : clusterGroups)
+    // Everything we need to cluster one group on its own
+    struct ClusterWork
     {
-        outClusterParams.resize(outClusterParams.size() + 1);
-        ClusterGenerator::ClusterClassParams &params = outClusterParams.back();
-        clusterGen->paramsForClusterClass(threadInfo,cluster->clusterID,params);
+        const ClusteredObjects *group = nullptr;
+        std::vector<LayoutObjectEntryRef> entries;
+        int paramID = -1;
+        ClusterIndexEntry *indexEntry = nullptr;
+        std::unique_ptr<ClusterHelper> clusterHelper;
+    };
+    std::vector<ClusterWork> clusterWork(clusterGroups.size());
+
+    // The generator may call out to the platform, so the parameters are fetched here
+    size_t totalObjs = 0;
+    std::unordered_set<int> indexedClusters;
+    {
+        int which = 0;
+        for (const auto &cluster : clusterGroups)
+        {
+            ClusterWork &work = clusterWork[which++];
+            work.group = cluster;
+            work.entries.assign(cluster->getLayoutObjects().begin(),cluster->getLayoutObjects().end());
+            totalObjs += work.entries.size();
 
-        ClusterHelper clusterHelper(screenMbr,OverlapSampleX,OverlapSampleY,resScale,params.clusterSize);
+            outClusterParams.resize(outClusterParams.size() + 1);
+            work.paramID = (int)(outClusterParams.size() - 1);
+            clusterGen->paramsForClusterClass(threadInfo,cluster->clusterID,outClusterParams.back());
 
-        // Add all the various objects to the cluster and figure out overlaps
-        for (const auto &entry : cluster->getLayoutObjects())
+            if (useIndex && work.entries.size() >= ClusterIndexMinObjects)
+            {
+                work.indexEntry = &clusterIndexes[cluster->clusterID];
+                indexedClusters.insert(cluster->clusterID);
+            }
+        }
+    }
+
+    // Toss the indices for groups that have gone away
+    for (auto it = clusterIndexes.begin(); it != clusterIndexes.end(); )
+    {
+        it = (indexedClusters.find(it->first) == indexedClusters.end()) ? clusterIndexes.erase(it) : std::next(it);
+    }
+
+    // How many pixels a unit of distance on the map works out to, near the middle of the screen
+    double pixelsPerUnit = 0.0;
+    if (!indexedClusters.empty())
+    {
+        const float pixelOffset = 100.0;
+        const Point2f center = frameBufferSize / 2.0;
+        Point3d dispPt0,dispPt1;
+        if (mapViewState->pointOnPlaneFromScreen(center,modelTrans,frameBufferSize,dispPt0,false) &&
+            mapViewState->pointOnPlaneFromScreen(center + Point2f(pixelOffset,0.0),modelTrans,frameBufferSize,dispPt1,false))
         {
+            const double dist = (dispPt1 - dispPt0).norm();
+            if (dist > 0.0)
+            {
+                pixelsPerUnit = pixelOffset / dist;
+            }
+        }
+    }
+
+    // Project the objects and sort out the overlaps for one group.
+    // This only touches the group's own work, so groups can run at the same time.
+    const auto clusterGroup = [&](ClusterWork &work)
+    {
+        const ClusterGenerator::ClusterClassParams &params = outClusterParams[work.paramID];
+        work.clusterHelper = std::make_unique<ClusterHelper>(screenMbr,OverlapSampleX,OverlapSampleY,resScale,params.clusterSize);
+        ClusterHelper &clusterHelper = *work.clusterHelper;
+
+        const int numObjs = (int)work.entries.size();
+        std::vector<Point2dVector> objPts(numObjs);
+        std::vector<uint8_t> objActive(numObjs,0);
+        const auto projectObj = [&](int which)
+        {
+            const auto &entry = work.entries[which];
+
             // Project the point and figure out the rotation
-            bool isActive = true;
             Point2f objPt;
-            bool isInside = calcScreenPt(objPt,&entry->obj,viewState,screenMbr,frameBufferSize);
+            if (!calcScreenPt(objPt,&entry->obj,viewState,screenMbr,frameBufferSize))
+            {
+                return;
+            }
+            objActive[which] = 1;
 
-            isActive &= isInside;
+            // Deal with the rotation
+            float screenRot = 0.0;
+            Matrix2d screenRotMat;
+            if (entry->obj.rotation != 0.0)
+            {
+                screenRotMat = calcScreenRot(screenRot,viewState,globeViewState,&entry->obj,
+                                             objPt,modelTrans,normalMat,frameBufferSize);
+            }
 
-            if (isActive)
+            // Rotate the rectangle
+            Point2dVector &thesePts = objPts[which];
+            thesePts.resize(4);
+            if (screenRot == 0.0)
             {
-                // Deal with the rotation
-                float screenRot = 0.0;
-                Matrix2d screenRotMat;
-                if (entry->obj.rotation != 0.0)
+                for (unsigned int ii=0;ii<4;ii++)
+                    thesePts[ii] = Point2d(objPt.x(),objPt.y()) + entry->obj.layoutPts[ii] * resScale;
+            }
+            else
+            {
+                Point2d center = objPt.cast<double>();
+                for (unsigned int ii=0;ii<4;ii++)
                 {
-                    screenRotMat = calcScreenRot(screenRot,viewState,globeViewState,&entry->obj,
-                                                 objPt,modelTrans,normalMat,frameBufferSize);
+                    const Point2d &thisObjPt = entry->obj.layoutPts[ii];
+                    const Point2d offPt = screenRotMat * (thisObjPt * resScale);
+                    thesePts[ii] = Point2d(offPt.x(),-offPt.y()) + center;
                 }
+            }
+        };
+        if (pool && numObjs >= (int)LayoutPoolMinObjects)
+        {
+            pool->parallelFor(0, numObjs, (int)LayoutPoolMinObjects / 4, projectObj);
+        }
+        else
+        {
+            for (int ii = 0; ii < numObjs; ii++)
+            {
+                projectObj(ii);
+            }
+        }
 
-                // Rotate the rectangle
-                Point2dVector objPts(4);
-                if (screenRot == 0.0)
+        if (UNLIKELY(cancelLayout))
+        {
+            return;
+        }
+
+        // Pick the coarsest level of the index that still clusters things that would have overlapped anyway
+        int indexLevel = -1;
+        if (work.indexEntry && pixelsPerUnit > 0.0)
+        {
+            // The index is good as long as the objects (and where they are) don't change
+            size_t signature = work.entries.size();
+            for (const auto &entry : work.entries)
+            {
+                const size_t hash = std::hash<SimpleIdentity>()(entry->obj.getId()) ^
+                                    (std::hash<double>()(entry->obj.worldLoc.x()) << 1) ^
+                                    (std::hash<double>()(entry->obj.worldLoc.y()) << 2);
+                signature ^= hash + 0x9e3779b9 + (signature << 6) + (signature >> 2);
+            }
+
+            ClusterIndexEntry &indexEntry = *work.indexEntry;
+            if (!indexEntry.index || indexEntry.signature != signature)
+            {
+                Point2dVector worldPts(numObjs);
+                for (int ii = 0; ii < numObjs; ii++)
                 {
-                    for (unsigned int ii=0;ii<4;ii++)
-                        objPts[ii] = Point2d(objPt.x(),objPt.y()) + entry->obj.layoutPts[ii] * resScale;
+                    worldPts[ii] = work.entries[ii]->obj.worldLoc.head<2>();
                 }
-                else
+                indexEntry.index = std::make_shared<ClusterIndex>(std::move(worldPts));
+                indexEntry.signature = signature;
+            }
+
+            const double minSize = std::min(params.clusterSize.x(),params.clusterSize.y()) * resScale;
+            indexLevel = indexEntry.index->levelForRadius(ClusterIndexSizeFraction * minSize / (2.0 * pixelsPerUnit));
+        }
+
+        // Add all the various objects to the cluster and figure out overlaps
+        if (indexLevel >= 0)
+        {
+            std::vector<LayoutObjectEntryRef> nodeEntries;
+            std::vector<Point2dVector> nodePts;
+            for (const auto &node : work.indexEntry->index->getLevel(indexLevel))
+            {
+                nodeEntries.clear();
+                nodePts.clear();
+                for (int which : node.points)
                 {
-                    Point2d center = objPt.cast<double>();
-                    for (unsigned int ii=0;ii<4;ii++)
+                    if (objActive[which])
                     {
-                        const Point2d &thisObjPt = entry->obj.layoutPts[ii];
-                        const Point2d offPt = screenRotMat * (thisObjPt * resScale);
-                        objPts[ii] = Point2d(offPt.x(),-offPt.y()) + center;
+                        nodeEntries.push_back(work.entries[which]);
+                        nodePts.push_back(std::move(objPts[which]));
                     }
                 }
-
-                clusterHelper.addObject(entry,objPts);
+                clusterHelper.addCluster(nodeEntries,nodePts);
+            }
+        }
+        else
+        {
+            for (int ii = 0; ii < numObjs; ii++)
+            {
+                if (objActive[ii])
+                {
+                    clusterHelper.addObject(work.entries[ii],objPts[ii]);
+                }
             }
         }
 
         // Deal with the clusters and their own overlaps
         clusterHelper.resolveClusters(cancelLayout);
+    };
 
-        if (UNLIKELY(cancelLayout))
+    // Groups don't affect one another until they're turned into layout objects
+    const bool goWide = pool && totalObjs >= LayoutPoolMinObjects;
+    if (goWide && viewState->ll.x() == viewState->ur.x())
+    {
+        // The view state works out its frustum the first time it's needed, do that before going wide
+        viewState->calcFrustumWidth((unsigned int)frameBufferSize.x(),(unsigned int)frameBufferSize.y());
+    }
+    if (goWide && clusterWork.size() > 1)
+    {
+        ThreadPool::Group group;
+        for (auto &work : clusterWork)
+        {
+            pool->run(group, [&clusterGroup,&work]{ clusterGroup(work); });
+        }
+        pool->wait(group);
+    }
+    else
+    {
+        for (auto &work : clusterWork)
+        {
+            clusterGroup(work);
+        }
+    }
+
+    // Lay out the cluster groups in order
+    for (auto &work : clusterWork)
+    {
+        if (UNLIKELY(cancelLayout) || !work.clusterHelper)
         {
             break;
         }
 
+        const ClusteredObjects *cluster = work.group;
+        const ClusterGenerator::ClusterClassParams &params = outClusterParams[work.paramID];
+        ClusterHelper &clusterHelper = *work.clusterHelper;
+
         // Toss the unaffected layout objects into the mix
         layoutObjs.reserve(layoutObjs.size() + clusterHelper.simpleObjects.size());
         for (const auto &obj : clusterHelper.simpleObjects)
@@ -1136,7 +1540,7 @@ void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
                         clusterEntry.layoutObj.selectPts.clear();
                     }
                 }
-                clusterEntry.clusterParamID = (int)(outClusterParams.size() - 1);
+                clusterEntry.clusterParamID = work.paramID;
 
                 // Figure out if all the objects in this new cluster come from the same old cluster
                 //  and assign the new cluster ID
@@ -1789,9 +2193,18 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
         return;
     }
 
-    // Make local copies of the layout objects
-    LayoutEntrySet localLayoutObjects(layoutObjects.begin(), layoutObjects.end());
-    const std::unordered_set<std::string> localOverrideUUIDs(overrideUUIDs.begin(), overrideUUIDs.end(), overrideUUIDs.size());
+    // Make local copies of the layout objects.
+    // In incremental mode we can use the copies from last time if nothing has been added or removed.
+    const int generation = layoutGeneration;
+    const bool reuseObjects = incrementalLayout && generation == prevLayoutGeneration;
+    LayoutEntrySet copiedLayoutObjects;
+    std::unordered_set<std::string> copiedOverrideUUIDs;
+    if (!reuseObjects)
+    {
+        copiedLayoutObjects.insert(layoutObjects.begin(), layoutObjects.end());
+        copiedOverrideUUIDs.reserve(overrideUUIDs.size());
+        copiedOverrideUUIDs.insert(overrideUUIDs.begin(), overrideUUIDs.end());
+    }
 
     // Any changes made after this will require another round of layout
     hasUpdates = false;
@@ -1813,6 +2226,11 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
         return;
     }
 
+    const TimeInterval passStartTime = TimeGetCurrent();
+
+    // Placements are about to change
+    screenSpaceGeneration++;
+
     // Locking may have taken some time, check for cancellation again
     if (cancelLayout)
     {
@@ -1820,6 +2238,15 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
         return;
     }
 
+    const LayoutEntrySet &localLayoutObjects = reuseObjects ? prevLayoutObjects : copiedLayoutObjects;
+    const std::unordered_set<std::string> &localOverrideUUIDs = reuseObjects ? prevOverrideUUIDs : copiedOverrideUUIDs;
+    if (!reuseObjects)
+    {
+        // The sorted order from last time doesn't match the new objects
+        sortedLayoutValid = false;
+        sortedLayoutObjs.clear();
+    }
+
     // Clear out any debug outlines we accumulated on the previous update
     if (!debugVecIDs.empty())
     {
@@ -1877,9 +2304,11 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
 
     //wkLog("Starting Layout t=%f", curTime);
 
+    const TimeInterval drawStartTime = TimeGetCurrent();
     buildDrawables(ssBuild, fadeEnabled, /*doClusters=*/true, curTime, &maxAnimTime,
                    localLayoutObjects, oldClusters, oldClusterParams,
                    &uniqueDrawableIDs, &oldUniqueDrawableMap);
+    const TimeInterval drawTime = TimeGetCurrent() - drawStartTime;
 
     if (cancelLayout)
     {
@@ -1905,7 +2334,12 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
     drawIDs.clear();
     drawIDs.swap(newDrawIDs);
 
-    prevLayoutObjects.swap(localLayoutObjects);
+    if (!reuseObjects)
+    {
+        prevLayoutObjects.swap(copiedLayoutObjects);
+        prevOverrideUUIDs.swap(copiedOverrideUUIDs);
+        prevLayoutGeneration = generation;
+    }
 
     // That all may have taken a while, so update some the times for animation.
     // Also add a jiffy for finishing up here and actually processing the change
@@ -1940,6 +2374,14 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
         deferUntil(maxAnimTime + deltaT);
     }
 
+    screenSpaceGeneration++;
+
+    {
+        std::lock_guard<std::mutex> statsGuard(statsLock);
+        layoutStats.addTime("Layout drawables", drawTime);
+        layoutStats.addTime("Layout pass", TimeGetCurrent() - passStartTime);
+    }
+
     wkLogLevel(Verbose, "Layout of %d objects, %d clusters took %.4f s",
                localLayoutObjects.size(), clusters.size(), scene->getCurrentTime() - curTime);
 }
@@ -20,6 +20,7 @@
 
 #import "MapboxVectorFilter.h"
 #import "MapboxVectorStyleSetC.h"
+#import "DictionaryC.h"
 #import "WhirlyKitLog.h"
 
 namespace WhirlyKit
@@ -33,6 +34,16 @@ static const char * const filterTypes[] = {"==","!=",">",">=","<","<=","in","!in
 static const char * const geomTypes[] = {"Point","LineString","Polygon"};
 
 bool MapboxVectorFilter::parse(const std::vector<DictionaryEntryRef> &filterArray,MapboxVectorStyleSetImpl *styleSet)
+{
+    if (!parseFilter(filterArray, styleSet))
+    {
+        return false;
+    }
+    compile();
+    return true;
+}
+
+bool MapboxVectorFilter::parseFilter(const std::vector<DictionaryEntryRef> &filterArray,MapboxVectorStyleSetImpl *styleSet)
 {
     if (filterArray.empty()) {
         wkLogLevel(Warn, "Expecting array for filter");
@@ -102,7 +113,7 @@ bool MapboxVectorFilter::parse(const std::vector<DictionaryEntryRef> &filterArra
         for (unsigned int ii=1;ii<filterArray.size();ii++)
         {
             const auto subFilter = std::make_shared<MapboxVectorFilter>();
-            if (!subFilter->parse(filterArray[ii]->getArray(), styleSet))
+            if (!subFilter->parseFilter(filterArray[ii]->getArray(), styleSet))
                 return false;
             subFilters.push_back(subFilter);
         }
@@ -115,7 +126,272 @@ namespace {
     const static std::string geometryType("geometry_type");
 }
 
+void MapboxVectorFilter::compile()
+{
+    ops.clear();
+    valueSets.clear();
+    compileFilter(this);
+}
+
+void MapboxVectorFilter::compileFilter(const MapboxVectorFilter *filter)
+{
+    // Children get added after this, so refer to it by index
+    const unsigned int which = ops.size();
+    ops.push_back(Op { MBOpTree, 0, filter, 0.0, std::string(), -1 });
+
+    const auto filterType = filter->filterType;
+    if (filter->geomType != MBGeomNone && (filterType == MBFilterEqual || filterType == MBFilterNotEqual))
+    {
+        ops[which].type = (filterType == MBFilterEqual) ? MBOpGeomEqual : MBOpGeomNotEqual;
+        ops[which].num = filter->geomType;
+    }
+    else
+    {
+        switch (filterType)
+        {
+        case MBFilterAll:
+        case MBFilterAny:
+            ops[which].type = (filterType == MBFilterAll) ? MBOpAll : MBOpAny;
+            for (const auto &subFilter : filter->subFilters)
+            {
+                compileFilter(subFilter.get());
+            }
+            break;
+        case MBFilterHas:
+            ops[which].type = MBOpHas;
+            break;
+        case MBFilterNotHas:
+            ops[which].type = MBOpNotHas;
+            break;
+        case MBFilterIn:
+        case MBFilterNotIn:
+            {
+                // Sort the values out by type so we can look them up directly.
+                // Anything that isn't one of ours compares in its own way, so leave it to the tree.
+                ValueSet valueSet;
+                bool valid = true;
+                for (const auto &val : filter->attrVals)
+                {
+                    if (const auto strVal = dynamic_cast<DictionaryEntryCString *>(val.get()))
+                    {
+                        valueSet.strings.insert(strVal->getStringRef());
+                    }
+                    else if (const auto basicVal = dynamic_cast<DictionaryEntryCBasic *>(val.get()))
+                    {
+                        switch (basicVal->getType())
+                        {
+                            case DictTypeInt:    valueSet.ints.insert(basicVal->val.iVal);          break;
+                            case DictTypeDouble: valueSet.doubles.push_back(basicVal->val.dVal);    break;
+                            case DictTypeInt64:  valueSet.int64s.push_back(basicVal->val.i64Val);   break;
+                            default:             valid = false;                                     break;
+                        }
+                    }
+                    else
+                    {
+                        valid = false;
+                    }
+                }
+                if (valid)
+                {
+                    ops[which].type = (filterType == MBFilterIn) ? MBOpIn : MBOpNotIn;
+                    ops[which].valueSet = (int)valueSets.size();
+                    valueSets.push_back(std::move(valueSet));
+                }
+            }
+            break;
+        case MBFilterEqual:
+        case MBFilterNotEqual:
+        case MBFilterGreaterThan:
+        case MBFilterGreaterThanEqual:
+        case MBFilterLessThan:
+        case MBFilterLessThanEqual:
+            if (filter->attrVal)
+            {
+                // Convert the value once rather than for every feature
+                ops[which].type = MBOpCompare;
+                ops[which].str = filter->attrVal->getString();
+                ops[which].num = (filter->attrVal->getType() == DictTypeString) ?
+                                    strtod(ops[which].str.c_str(), nullptr) : filter->attrVal->getDouble();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    ops[which].end = ops.size();
+}
+
+bool MapboxVectorFilter::ValueSet::matchNumber(const DictionaryEntry &featAttrVal) const
+{
+    // Same conversions the entries would do comparing themselves
+    if (!ints.empty() && ints.count(featAttrVal.getInt()))
+    {
+        return true;
+    }
+    if (!doubles.empty())
+    {
+        const double featVal = featAttrVal.getDouble();
+        for (const double val : doubles)
+        {
+            if (val == featVal)
+            {
+                return true;
+            }
+        }
+    }
+    if (!int64s.empty())
+    {
+        const SimpleIdentity featVal = featAttrVal.getIdentity();
+        for (const int64_t val : int64s)
+        {
+            // Compared as identities, same as the dictionary entry comparison
+            if ((SimpleIdentity)val == featVal)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool MapboxVectorFilter::testFeature(const Dictionary &attrs,const QuadTreeIdentifier &tileID)
+{
+    // Filters that didn't parse cleanly don't get compiled
+    if (ops.empty())
+    {
+        return testTree(attrs, tileID);
+    }
+
+    EvalContext context;
+    return testOp(0, attrs, tileID, context);
+}
+
+bool MapboxVectorFilter::testOp(unsigned int which,const Dictionary &attrs,const QuadTreeIdentifier &tileID,EvalContext &context) const
+{
+    const Op &op = ops[which];
+    switch (op.type)
+    {
+    case MBOpAll:
+        for (unsigned int child = which + 1; child < op.end; child = ops[child].end)
+        {
+            if (!testOp(child, attrs, tileID, context))
+            {
+                return false;
+            }
+        }
+        return true;
+    case MBOpAny:
+        for (unsigned int child = which + 1; child < op.end; child = ops[child].end)
+        {
+            if (testOp(child, attrs, tileID, context))
+            {
+                return true;
+            }
+        }
+        return false;
+    case MBOpGeomEqual:
+    case MBOpGeomNotEqual:
+        if (!context.haveGeomType)
+        {
+            context.geomType = attrs.getInt(geometryType) - 1;
+            context.haveGeomType = true;
+        }
+        return (context.geomType == (int)op.num) == (op.type == MBOpGeomEqual);
+    case MBOpHas:
+        return attrs.hasField(op.filter->attrName);
+    case MBOpNotHas:
+        return !attrs.hasField(op.filter->attrName);
+    case MBOpCompare:
+        return testCompare(op, attrs, tileID);
+    case MBOpIn:
+    case MBOpNotIn:
+        return testIn(op, attrs, tileID);
+    case MBOpTree:
+    default:
+        return op.filter->testTree(attrs, tileID);
+    }
+}
+
+bool MapboxVectorFilter::testCompare(const Op &op,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const
+{
+    const auto &name = op.filter->attrName;
+    const auto filterType = op.filter->filterType;
+    switch (attrs.getType(name))
+    {
+    case DictTypeNone:
+        // No attribute means no pass
+        // A missing value and != is valid
+        return (filterType == MBFilterNotEqual);
+    case DictTypeString:
+        switch (filterType)
+        {
+            case MBFilterEqual:    return attrs.getString(name) == op.str;
+            case MBFilterNotEqual: return attrs.getString(name) != op.str;
+            default: return true;  // Note: Not expecting other comparisons to strings
+        }
+    case DictTypeInt:
+    case DictTypeDouble:
+        {
+        const double val1 = attrs.getDouble(name);
+        const double val2 = op.num;
+        switch (filterType)
+        {
+            case MBFilterEqual:            return val1 == val2;
+            case MBFilterNotEqual:         return val1 != val2;
+            case MBFilterGreaterThan:      return val1 > val2;
+            case MBFilterGreaterThanEqual: return val1 >= val2;
+            case MBFilterLessThan:         return val1 < val2;
+            case MBFilterLessThanEqual:    return val1 <= val2;
+            default: return true;
+        }
+        }
+    default:
+        // Let the tree sort out (and complain about) anything else
+        return op.filter->testTree(attrs, tileID);
+    }
+}
+
+bool MapboxVectorFilter::testIn(const Op &op,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const
+{
+    const auto &name = op.filter->attrName;
+    const auto &valueSet = valueSets[op.valueSet];
+    bool found = false;
+    switch (attrs.getType(name))
+    {
+    case DictTypeNone:
+        break;
+    case DictTypeString:
+        {
+            std::string str = attrs.getString(name);
+            found = valueSet.strings.count(str) > 0;
+            if (!found && valueSet.hasNumbers())
+            {
+                found = valueSet.matchNumber(DictionaryEntryCString(std::move(str)));
+            }
+        }
+        break;
+    // Numeric entries look like empty strings to string values
+    case DictTypeInt:
+        found = valueSet.strings.count(std::string()) > 0 ||
+                valueSet.matchNumber(DictionaryEntryCBasic(attrs.getInt(name)));
+        break;
+    case DictTypeDouble:
+        found = valueSet.strings.count(std::string()) > 0 ||
+                valueSet.matchNumber(DictionaryEntryCBasic(attrs.getDouble(name)));
+        break;
+    case DictTypeInt64:
+    case DictTypeIdentity:
+        found = valueSet.strings.count(std::string()) > 0 ||
+                valueSet.matchNumber(DictionaryEntryCBasic(attrs.getInt64(name)));
+        break;
+    default:
+        return op.filter->testTree(attrs, tileID);
+    }
+    return found == (op.type == MBOpIn);
+}
+
+bool MapboxVectorFilter::testTree(const Dictionary &attrs,const QuadTreeIdentifier &tileID) const
 {
     // Compare geometry type
     if (geomType != MBGeomNone)
@@ -133,14 +409,14 @@ bool MapboxVectorFilter::testFeature(const Dictionary &attrs,const QuadTreeIdent
     // Run each of the rules as either AND or OR
     case MBFilterAll:
         for (const auto &filter : subFilters) {
-            if (!filter->testFeature(attrs, tileID)) {
+            if (!filter->testTree(attrs, tileID)) {
                 return false;
             }
         }
         return true;
     case MBFilterAny:
         for (const auto &filter : subFilters) {
-            if (filter->testFeature(attrs, tileID)) {
+            if (filter->testTree(attrs, tileID)) {
                 return true;
             }
         }
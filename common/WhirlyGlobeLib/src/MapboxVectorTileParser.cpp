@@ -23,6 +23,7 @@
 #import "DictionaryC.h"
 #import "VectorTilePBFParser.h"
 
+#include <exception>
 #include <utility>
 #import <vector>
 
@@ -118,6 +119,13 @@ void MapboxVectorTileParser::setAttributeFilter(const std::string &name,std::set
     filterValues = std::move(values);
 }
 
+void MapboxVectorTileParser::setBuildPool(ThreadPoolRef pool,ThreadInfoFunction threadInfoFn,TaskWrapperFunction wrapFn)
+{
+    buildPool = std::move(pool);
+    buildThreadInfoFn = std::move(threadInfoFn);
+    buildWrapFn = std::move(wrapFn);
+}
+
 void MapboxVectorTileParser::addCategory(const std::string &category,long long styleID)
 {
     styleCategories[styleID] = category;
@@ -204,39 +212,11 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,
 //    }
     
     // Run the styles over their assembled data
-    for (const auto &it : tileData->vecObjsByStyle)
+    const bool parallel = buildPool && buildPool->getNumThreads() > 1 && tileData->vecObjsByStyle.size() > 1;
+    if (!(parallel ? buildStylesParallel(styleInst, tileData, cancelFn) :
+                     buildStyles(styleInst, tileData, cancelFn)))
     {
-        std::vector<VectorObjectRef> &vecs = *it.second;
-
-        auto styleData = std::make_shared<VectorTileData>(*tileData);
-
-        // Ask the subclass to run the style and fill in the VectorTileData
-        buildForStyle(styleInst,it.first,vecs,styleData,cancelFn);
-
-        // Sort the results into categories if needed
-        auto catIt = styleCategories.find(it.first);
-        if (catIt != styleCategories.end() && !styleData->compObjs.empty())
-        {
-            const std::string &category = catIt->second;
-            auto &compObjs = styleData->compObjs;
-            auto categoryIt = tileData->categories.find(category);
-            if (categoryIt != tileData->categories.end())
-            {
-                compObjs.insert(compObjs.end(), categoryIt->second.begin(), categoryIt->second.end());
-            }
-            tileData->categories[category] = compObjs;
-        }
-        
-        // Merge this into the general return data
-        tileData->mergeFrom(styleData.get());
-
-        // The changes in `tileData` represent objects already tracked
-        // in the managers they must be merged or we'll have leaks, so
-        // we can't return between the build and the merge above.
-        if (cancelFn(styleInst))
-        {
-            return false;
-        }
+        return false;
     }
     
     // These are layered on top for debugging
@@ -286,6 +266,145 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,
     return true;
 }
 
+bool MapboxVectorTileParser::buildStyles(PlatformThreadInfo *styleInst,
+                                         VectorTileData *tileData,
+                                         const CancelFunction &cancelFn)
+{
+    for (const auto &it : tileData->vecObjsByStyle)
+    {
+        std::vector<VectorObjectRef> &vecs = *it.second;
+
+        auto styleData = std::make_shared<VectorTileData>(*tileData);
+
+        // Ask the subclass to run the style and fill in the VectorTileData
+        buildForStyle(styleInst,it.first,vecs,styleData,cancelFn);
+
+        // Merge this into the general return data
+        mergeStyleData(it.first, tileData, styleData.get());
+
+        // The changes in `tileData` represent objects already tracked
+        // in the managers they must be merged or we'll have leaks, so
+        // we can't return between the build and the merge above.
+        if (cancelFn(styleInst))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MapboxVectorTileParser::buildStylesParallel(PlatformThreadInfo *styleInst,
+                                                 VectorTileData *tileData,
+                                                 const CancelFunction &cancelFn)
+{
+    struct StyleBuild
+    {
+        SimpleIdentity styleID;
+        const std::vector<VectorObjectRef> *vecs;
+        VectorTileDataRef styleData;
+        std::exception_ptr error;
+    };
+
+    // Copy these out, merging results will modify the map
+    std::vector<StyleBuild> builds;
+    builds.reserve(tileData->vecObjsByStyle.size());
+    for (const auto &it : tileData->vecObjsByStyle)
+    {
+        builds.push_back(StyleBuild { it.first, it.second, VectorTileDataRef(), std::exception_ptr() });
+    }
+
+    const auto callerThread = std::this_thread::get_id();
+    std::atomic<bool> cancelled(false);
+
+    const auto buildOne = [&](StyleBuild &build)
+    {
+        // The calling thread may pick up tasks while it waits.  It's the only one
+        // outside the pool that can, since waiting only runs tasks from its own group.
+        PlatformThreadInfo *inst = styleInst;
+        if (std::this_thread::get_id() != callerThread && buildThreadInfoFn)
+        {
+            inst = buildThreadInfoFn(styleInst);
+        }
+
+        // Don't start anything new once we've been cancelled
+        if (cancelled || cancelFn(inst))
+        {
+            cancelled = true;
+            return;
+        }
+
+        try
+        {
+            auto styleData = std::make_shared<VectorTileData>(*tileData);
+            buildForStyle(inst,build.styleID,*build.vecs,styleData,cancelFn);
+            build.styleData = std::move(styleData);
+        }
+        catch (...)
+        {
+            build.error = std::current_exception();
+        }
+    };
+
+    ThreadPool::Group group;
+    for (auto &build : builds)
+    {
+        buildPool->run(group, [&]{
+            if (buildWrapFn)
+            {
+                buildWrapFn([&]{ buildOne(build); });
+            }
+            else
+            {
+                buildOne(build);
+            }
+        });
+    }
+    buildPool->wait(group);
+
+    // Merge in style order, same as doing them one at a time.
+    // Anything that was built has to be merged, even if we were cancelled,
+    // since its changes represent objects already tracked in the managers.
+    std::exception_ptr error;
+    for (auto &build : builds)
+    {
+        if (build.styleData)
+        {
+            mergeStyleData(build.styleID, tileData, build.styleData.get());
+        }
+        if (build.error && !error)
+        {
+            error = build.error;
+        }
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    return !cancelled && !cancelFn(styleInst);
+}
+
+void MapboxVectorTileParser::mergeStyleData(long long styleID,VectorTileData *tileData,VectorTileData *styleData)
+{
+    // Sort the results into categories if needed
+    auto catIt = styleCategories.find(styleID);
+    if (catIt != styleCategories.end() && !styleData->compObjs.empty())
+    {
+        const std::string &category = catIt->second;
+        auto &compObjs = styleData->compObjs;
+        auto categoryIt = tileData->categories.find(category);
+        if (categoryIt != tileData->categories.end())
+        {
+            compObjs.insert(compObjs.end(), categoryIt->second.begin(), categoryIt->second.end());
+        }
+        tileData->categories[category] = compObjs;
+    }
+
+    // Merge this into the general return data
+    tileData->mergeFrom(styleData);
+}
+
 void MapboxVectorTileParser::buildForStyle(PlatformThreadInfo *styleInst,
                                            long long styleID,
                                            const std::vector<VectorObjectRef> &vecObjs,
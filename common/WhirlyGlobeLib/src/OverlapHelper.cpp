@@ -28,13 +28,25 @@ using namespace WhirlyKit;
 namespace WhirlyKit
 {
 
-OverlapHelper::OverlapHelper(const Mbr &mbr, int sizeX, int sizeY, size_t count) :
+OverlapHelper::OverlapHelper(const Mbr &mbr, int sizeX, int sizeY, size_t count, IndexType indexType) :
     mbr(mbr),
     sizeX(sizeX),
     sizeY(sizeY),
     totalObjs(count),
-    cellSize(mbr.span().cwiseQuotient(Point2f(sizeX, sizeY)))
+    cellSize(mbr.span().cwiseQuotient(Point2f(sizeX, sizeY))),
+    indexType(indexType)
 {
+    if (indexType == OverlapTreeIndex)
+    {
+        if (count > 0)
+        {
+            boxes.reserve(count);
+            boxMergeIDs.reserve(count);
+            tree.reserve(count);
+        }
+        return;
+    }
+
     grid.resize(sizeX * sizeY);
 
     if (count > 0)
@@ -55,6 +67,18 @@ bool OverlapHelper::checkObject(const Point2dVector &pts, const std::string &mer
 // Try to add an object.  Might fail (kind of the whole point).
 bool OverlapHelper::addCheckObject(const Point2dVector &pts, const char* mergeID)
 {
+    if (indexType == OverlapTreeIndex)
+    {
+        const OrientedBox box = calcOrientedBox(pts);
+        const BoundingBoxTree::Box bounds = calcTreeBounds(pts);
+        if (!treeCheckObject(box, bounds, findMergeID(mergeID)))
+        {
+            return false;
+        }
+        treeAddObject(box, bounds, addMergeID(mergeID ? mergeID : std::string()));
+        return true;
+    }
+
     const Mbr objMbr(pts);
 
     int sx,sy,ex,ey;
@@ -110,6 +134,11 @@ bool OverlapHelper::checkObject(const Point2dVector &pts, const Mbr &objMbr,
 
 bool OverlapHelper::checkObject(const Point2dVector &pts, const char* mergeID)
 {
+    if (indexType == OverlapTreeIndex)
+    {
+        return treeCheckObject(calcOrientedBox(pts), calcTreeBounds(pts), findMergeID(mergeID));
+    }
+
     const Mbr objMbr(pts);
     int sx,sy,ex,ey;
     calcCells(objMbr, sx,sy,ex,ey);
@@ -118,6 +147,12 @@ bool OverlapHelper::checkObject(const Point2dVector &pts, const char* mergeID)
 
 void OverlapHelper::addObject(Point2dVector pts, std::string mergeID)
 {
+    if (indexType == OverlapTreeIndex)
+    {
+        treeAddObject(calcOrientedBox(pts), calcTreeBounds(pts), addMergeID(mergeID));
+        return;
+    }
+
     const Mbr objMbr(pts);
 
     int sx,sy,ex,ey;
@@ -148,6 +183,120 @@ void OverlapHelper::addObject(Point2dVector pts, std::string mergeID,
     }
 }
 
+OverlapHelper::OrientedBox OverlapHelper::calcOrientedBox(const Point2dVector &pts)
+{
+    OrientedBox box;
+    box.axis0 = Point2d(1.0, 0.0);
+    if (pts.size() > 1)
+    {
+        // Layout objects are rotated rectangles, so the first edge lines up with the rest
+        const Point2d edge = pts[1] - pts[0];
+        const double len = edge.norm();
+        if (len > 0.0)
+        {
+            box.axis0 = edge / len;
+        }
+    }
+    box.axis1 = Point2d(-box.axis0.y(), box.axis0.x());
+
+    // Anything else still ends up inside the box
+    double min0 = MAXFLOAT, max0 = -MAXFLOAT;
+    double min1 = MAXFLOAT, max1 = -MAXFLOAT;
+    for (const auto &pt : pts)
+    {
+        const double d0 = pt.dot(box.axis0);
+        const double d1 = pt.dot(box.axis1);
+        min0 = std::min(min0, d0);  max0 = std::max(max0, d0);
+        min1 = std::min(min1, d1);  max1 = std::max(max1, d1);
+    }
+    if (pts.empty())
+    {
+        min0 = max0 = min1 = max1 = 0.0;
+    }
+
+    box.center = box.axis0 * ((min0 + max0) / 2.0) + box.axis1 * ((min1 + max1) / 2.0);
+    box.extent0 = (max0 - min0) / 2.0;
+    box.extent1 = (max1 - min1) / 2.0;
+    return box;
+}
+
+BoundingBoxTree::Box OverlapHelper::calcTreeBounds(const Point2dVector &pts)
+{
+    BoundingBoxTree::Box bounds { Point3d(MAXFLOAT, MAXFLOAT, 0.0), Point3d(-MAXFLOAT, -MAXFLOAT, 0.0) };
+    for (const auto &pt : pts)
+    {
+        bounds.ll.x() = std::min(bounds.ll.x(), pt.x());
+        bounds.ll.y() = std::min(bounds.ll.y(), pt.y());
+        bounds.ur.x() = std::max(bounds.ur.x(), pt.x());
+        bounds.ur.y() = std::max(bounds.ur.y(), pt.y());
+    }
+    return bounds;
+}
+
+bool OverlapHelper::boundsOverlap(const BoundingBoxTree::Box &a, const BoundingBoxTree::Box &b)
+{
+    return a.ll.x() <= b.ur.x() && b.ll.x() <= a.ur.x() &&
+           a.ll.y() <= b.ur.y() && b.ll.y() <= a.ur.y();
+}
+
+// Separating axis test.  Boxes that just touch count as overlapping.
+bool OverlapHelper::boxesOverlap(const OrientedBox &a, const OrientedBox &b)
+{
+    const Point2d diff = b.center - a.center;
+    const Point2d *axes[4] = { &a.axis0, &a.axis1, &b.axis0, &b.axis1 };
+    for (const Point2d *axis : axes)
+    {
+        const double ra = a.extent0 * std::abs(a.axis0.dot(*axis)) + a.extent1 * std::abs(a.axis1.dot(*axis));
+        const double rb = b.extent0 * std::abs(b.axis0.dot(*axis)) + b.extent1 * std::abs(b.axis1.dot(*axis));
+        if (std::abs(diff.dot(*axis)) > ra + rb)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int OverlapHelper::findMergeID(const char *mergeID) const
+{
+    if (!mergeID)
+    {
+        return -1;
+    }
+    const auto it = mergeIDs.find(mergeID);
+    return (it != mergeIDs.end()) ? it->second : -1;
+}
+
+int OverlapHelper::addMergeID(const std::string &mergeID)
+{
+    // Objects without a merge ID share the empty one, same as the grid
+    return mergeIDs.emplace(mergeID, (int)mergeIDs.size()).first->second;
+}
+
+bool OverlapHelper::treeCheckObject(const OrientedBox &box, const BoundingBoxTree::Box &bounds, int mergeIdx)
+{
+    bool clear = true;
+    tree.query([&](const BoundingBoxTree::Box &nodeBounds) {
+            // Once something's in the way there's no need to look further
+            return clear && boundsOverlap(nodeBounds, bounds);
+        },
+        [&](SimpleIdentity which) {
+            // Objects sharing the same merge ID don't get in each other's way
+            if ((mergeIdx < 0 || boxMergeIDs[which] != mergeIdx) &&
+                boxesOverlap(boxes[which], box))
+            {
+                clear = false;
+            }
+        });
+    return clear;
+}
+
+void OverlapHelper::treeAddObject(const OrientedBox &box, const BoundingBoxTree::Box &bounds, int mergeIdx)
+{
+    boxes.push_back(box);
+    boxMergeIDs.push_back(mergeIdx);
+    tree.addBox(boxes.size() - 1, bounds);
+}
+
 ClusterHelper::SimpleObject::SimpleObject()
     : objEntry(nullptr), parentObject(-1)
 {
@@ -184,12 +333,11 @@ void ClusterHelper::addToCells(const Mbr &objMbr, int index)
     calcCells(objMbr, sx, sy, ex, ey);
 
     // Add the new object to the grid
-    for (int ix=sx;ix<=ex;ix++)
+    for (int iy=sy;iy<=ey;iy++)
     {
-        for (int iy=sy;iy<=ey;iy++)
+        for (int ix=sx;ix<=ex;ix++)
         {
-            std::set<int> &objSet = grid[iy*sizeX + ix];
-            objSet.insert(index);
+            grid[iy*sizeX + ix].push_back(index);
         }
     }
 }
@@ -199,30 +347,41 @@ void ClusterHelper::removeFromCells(const Mbr &objMbr, int index)
     int sx,sy,ex,ey;
     calcCells(objMbr, sx, sy, ex, ey);
     
-    // Add the new object to the grid
-    for (int ix=sx;ix<=ex;ix++)
+    // Take it out of the grid, order within a cell doesn't matter
+    for (int iy=sy;iy<=ey;iy++)
     {
-        for (int iy=sy;iy<=ey;iy++)
+        for (int ix=sx;ix<=ex;ix++)
         {
-            std::set<int> &objSet = grid[iy*sizeX + ix];
-            objSet.erase(index);
+            std::vector<int> &cell = grid[iy*sizeX + ix];
+            const auto it = std::find(cell.begin(), cell.end(), index);
+            if (it != cell.end())
+            {
+                *it = cell.back();
+                cell.pop_back();
+            }
         }
     }
 }
     
-void ClusterHelper::findObjectsWithin(const Mbr &objMbr,std::set<int> &objSet)
+void ClusterHelper::findObjectsWithin(const Mbr &objMbr,std::vector<int> &objs)
 {
+    objs.clear();
+
     int sx,sy,ex,ey;
     calcCells(objMbr,sx,sy,ex,ey);
 
-    for (int ix=sx;ix<=ex;ix++)
+    for (int iy=sy;iy<=ey;iy++)
     {
-        for (int iy=sy;iy<=ey;iy++)
+        for (int ix=sx;ix<=ex;ix++)
         {
-            std::set<int> &thisGridSet = grid[iy*sizeX + ix];
-            objSet.insert(thisGridSet.begin(),thisGridSet.end());
+            const std::vector<int> &cell = grid[iy*sizeX + ix];
+            objs.insert(objs.end(),cell.begin(),cell.end());
         }
     }
+
+    // Objects can be in more than one cell.  Callers also go through these in order, clusters first.
+    std::sort(objs.begin(), objs.end());
+    objs.erase(std::unique(objs.begin(), objs.end()), objs.end());
 }
 
 // Try to add an object.  Might fail (kind of the whole point).
@@ -240,12 +399,11 @@ void ClusterHelper::addObject(LayoutObjectEntryRef objEntry,const Point2dVector
     const Mbr ptsMbr(pts);
     
     // All the things we might overlap
-    std::set<int> objSet;
-    findObjectsWithin(ptsMbr, objSet);
+    findObjectsWithin(ptsMbr, foundObjs);
     
     // Look for overlaps
     bool found = false;
-    for (auto which : objSet)
+    for (auto which : foundObjs)
     {
         ObjectWithBounds *testObj;
         SimpleObject *simpleObj = nullptr;
@@ -290,15 +448,7 @@ void ClusterHelper::addObject(LayoutObjectEntryRef objEntry,const Point2dVector
             }
 
             newObj.parentObject = clusterID;
-            clusterObj->pts.clear();
-            clusterObj->pts.reserve(4);
-            clusterObj->pts.push_back(clusterObj->center + Point2d(-clusterMarkerSize.x()*resScale/2.0,-clusterMarkerSize.y()*resScale/2.0));
-            clusterObj->pts.push_back(clusterObj->center + Point2d(clusterMarkerSize.x()*resScale/2.0,-clusterMarkerSize.y()*resScale/2.0));
-            clusterObj->pts.push_back(clusterObj->center + Point2d(clusterMarkerSize.x()*resScale/2.0,clusterMarkerSize.y()*resScale/2.0));
-            clusterObj->pts.push_back(clusterObj->center + Point2d(-clusterMarkerSize.x()*resScale/2.0,clusterMarkerSize.y()*resScale/2.0));
-
-            const Mbr clusterMbr(clusterObj->pts);
-            addToCells(clusterMbr,-(clusterID+1));
+            placeCluster(clusterID);
             
             found = true;
             break;
@@ -310,8 +460,64 @@ void ClusterHelper::addObject(LayoutObjectEntryRef objEntry,const Point2dVector
         addToCells(ptsMbr, newID);
 }
 
+void ClusterHelper::placeCluster(int clusterID)
+{
+    ClusterObject *clusterObj = &clusterObjects[clusterID];
+    const Point2d halfSize = clusterMarkerSize * resScale / 2.0;
+
+    clusterObj->pts.clear();
+    clusterObj->pts.reserve(4);
+    clusterObj->pts.push_back(clusterObj->center + Point2d(-halfSize.x(),-halfSize.y()));
+    clusterObj->pts.push_back(clusterObj->center + Point2d(halfSize.x(),-halfSize.y()));
+    clusterObj->pts.push_back(clusterObj->center + Point2d(halfSize.x(),halfSize.y()));
+    clusterObj->pts.push_back(clusterObj->center + Point2d(-halfSize.x(),halfSize.y()));
+
+    const Mbr clusterMbr(clusterObj->pts);
+    addToCells(clusterMbr,-(clusterID+1));
+}
+
+void ClusterHelper::addCluster(const std::vector<LayoutObjectEntryRef> &objEntries,const std::vector<Point2dVector> &pts)
+{
+    if (objEntries.empty())
+    {
+        return;
+    }
+    if (objEntries.size() == 1)
+    {
+        addObject(objEntries[0], pts[0]);
+        return;
+    }
+
+    const int clusterID = (int)clusterObjects.size();
+    clusterObjects.emplace_back();
+    ClusterObject &clusterObj = clusterObjects.back();
+    clusterObj.children.reserve(objEntries.size());
+    clusterObj.center = Point2d(0.0,0.0);
+
+    simpleObjects.reserve(simpleObjects.size() + objEntries.size());
+    for (unsigned int ii=0;ii<objEntries.size();ii++)
+    {
+        const int newID = (int)simpleObjects.size();
+        simpleObjects.emplace_back();
+
+        SimpleObject &newObj = simpleObjects.back();
+        newObj.objEntry = objEntries[ii];
+        newObj.center = CalcCenterOfMass(pts[ii]);
+        newObj.pts = pts[ii];
+        newObj.parentObject = clusterID;
+
+        clusterObj.children.push_back(newID);
+        clusterObj.center += newObj.center;
+    }
+    clusterObj.center /= (double)objEntries.size();
+
+    placeCluster(clusterID);
+}
+
 void ClusterHelper::resolveClusters(volatile bool &cancel)
 {
+    std::vector<int> testObjs;
+
     // Find single objects that overlap existing clusters.
     // We won't move the clusters here to keep it simpler
     for (int so=0;so<simpleObjects.size();so++)
@@ -326,7 +532,6 @@ void ClusterHelper::resolveClusters(volatile bool &cancel)
         {
             const Mbr simpleMbr(simpleObj->pts);
 
-            std::set<int> testObjs;
             findObjectsWithin(simpleMbr, testObjs);
 
             for (int which : testObjs)
@@ -360,7 +565,6 @@ void ClusterHelper::resolveClusters(volatile bool &cancel)
         {
             const Mbr thisMbr(clusterObj->pts);
 
-            std::set<int> testObjs;
             findObjectsWithin(thisMbr, testObjs);
 
             for (auto which : testObjs)
@@ -390,4 +594,132 @@ void ClusterHelper::objectsForCluster(const ClusterObject &cluster,
     }
 }
 
+ClusterIndex::ClusterIndex(Point2dVector inPts) :
+    pts(std::move(inPts)), baseRadius(0.0)
+{
+    levels.resize(MaxLevels);
+    levelValid.resize(MaxLevels,false);
+
+    // The finest level is a tiny fraction of the whole extent, the coarsest is most of it
+    if (!pts.empty())
+    {
+        Point2d ll = pts[0], ur = pts[0];
+        for (const auto &pt : pts)
+        {
+            ll = ll.cwiseMin(pt);
+            ur = ur.cwiseMax(pt);
+        }
+        const Point2d span = ur - ll;
+        baseRadius = std::max(span.x(), span.y()) / (double)(1 << MaxLevels);
+    }
+}
+
+int ClusterIndex::levelForRadius(double radius) const
+{
+    if (baseRadius <= 0.0 || radius < baseRadius)
+    {
+        return -1;
+    }
+    return std::min(MaxLevels - 1, (int)floor(log2(radius / baseRadius)));
+}
+
+const std::vector<ClusterIndex::Node> &ClusterIndex::getLevel(int level)
+{
+    level = std::max(0, std::min(MaxLevels - 1, level));
+    for (int which = 0; which <= level; which++)
+    {
+        if (!levelValid[which])
+        {
+            buildLevel(which);
+        }
+    }
+    return levels[level];
+}
+
+void ClusterIndex::buildLevel(int level)
+{
+    // Start from the level below, or the points themselves
+    std::vector<Node> singles;
+    if (level == 0)
+    {
+        singles.resize(pts.size());
+        for (unsigned int ii = 0; ii < pts.size(); ii++)
+        {
+            singles[ii].center = pts[ii];
+            singles[ii].points.push_back((int)ii);
+        }
+    }
+    const std::vector<Node> &below = (level == 0) ? singles : levels[level - 1];
+    std::vector<Node> &nodes = levels[level];
+    nodes.clear();
+    levelValid[level] = true;
+    if (below.empty() || baseRadius <= 0.0)
+    {
+        return;
+    }
+
+    // Bucket the nodes into cells the size of the radius, so neighbors are at most a cell away
+    const double radius = levelRadius(level);
+    const double radius2 = radius * radius;
+    const Point2d org = below[0].center;
+    std::unordered_map<int64_t,std::vector<int>> cells;
+    cells.reserve(below.size());
+    const auto cellFor = [&](const Point2d &pt,int &cx,int &cy)
+    {
+        cx = (int)floor((pt.x() - org.x()) / radius);
+        cy = (int)floor((pt.y() - org.y()) / radius);
+    };
+    const auto cellKey = [](int cx,int cy) { return ((int64_t)cx << 32) ^ (int64_t)(uint32_t)cy; };
+    for (unsigned int ii = 0; ii < below.size(); ii++)
+    {
+        int cx,cy;
+        cellFor(below[ii].center,cx,cy);
+        cells[cellKey(cx,cy)].push_back((int)ii);
+    }
+
+    // Each node that hasn't been taken yet gathers up its untaken neighbors
+    std::vector<bool> taken(below.size(),false);
+    for (unsigned int ii = 0; ii < below.size(); ii++)
+    {
+        if (taken[ii])
+        {
+            continue;
+        }
+        taken[ii] = true;
+
+        const Node &seed = below[ii];
+        nodes.emplace_back();
+        Node &node = nodes.back();
+        node.points = seed.points;
+        Point2d weightedCenter = seed.center * (double)seed.points.size();
+
+        int cx,cy;
+        cellFor(seed.center,cx,cy);
+        for (int iy = cy - 1; iy <= cy + 1; iy++)
+        {
+            for (int ix = cx - 1; ix <= cx + 1; ix++)
+            {
+                const auto it = cells.find(cellKey(ix,iy));
+                if (it == cells.end())
+                {
+                    continue;
+                }
+                for (int which : it->second)
+                {
+                    if (taken[which] || (below[which].center - seed.center).squaredNorm() > radius2)
+                    {
+                        continue;
+                    }
+                    taken[which] = true;
+
+                    const Node &other = below[which];
+                    node.points.insert(node.points.end(),other.points.begin(),other.points.end());
+                    weightedCenter += other.center * (double)other.points.size();
+                }
+            }
+        }
+        node.center = weightedCenter / (double)node.points.size();
+    }
+}
+
 }
@@ -44,7 +44,7 @@ bool PerformanceTimer::CountEntry::operator<(const WhirlyKit::PerformanceTimer::
     return name < that.name;
 }
 
-void PerformanceTimer::CountEntry::addCount(int count)
+void PerformanceTimer::CountEntry::addCount(int64_t count)
 {
     minCount = (numRuns == 0) ? count : std::min(minCount,count);
     maxCount = (numRuns == 0) ? count : std::max(maxCount,count);
@@ -78,12 +78,17 @@ void PerformanceTimer::stopTiming(const std::string &what)
     const TimeInterval start = it->second;
     actives.erase(it);
 
+    addTime(what, now - start);
+}
+
+void PerformanceTimer::addTime(const std::string &what,TimeInterval dur)
+{
     const auto res = timeEntries.insert(std::make_pair(what, TimeEntry()));
     if (res.second)
     {
         res.first->second.name = what;
     }
-    res.first->second.addTime(now - start);
+    res.first->second.addTime(dur);
 }
 
 PerformanceTimer::TimeEntry PerformanceTimer::getTiming(const std::string &what) const
@@ -92,7 +97,18 @@ PerformanceTimer::TimeEntry PerformanceTimer::getTiming(const std::string &what)
     return (it != timeEntries.end()) ? it->second : TimeEntry();
 }
 
-void PerformanceTimer::addCount(const std::string &what,int count)
+std::vector<PerformanceTimer::TimeEntry> PerformanceTimer::getTimings() const
+{
+    std::vector<TimeEntry> entries;
+    entries.reserve(timeEntries.size());
+    for (const auto &timeEntry : timeEntries)
+    {
+        entries.push_back(timeEntry.second);
+    }
+    return entries;
+}
+
+void PerformanceTimer::addCount(const std::string &what,int64_t count)
 {
     const auto result = countEntries.insert(std::make_pair(what, CountEntry()));
     if (result.second)
@@ -102,6 +118,23 @@ void PerformanceTimer::addCount(const std::string &what,int count)
     result.first->second.addCount(count);
 }
 
+PerformanceTimer::CountEntry PerformanceTimer::getCount(const std::string &what) const
+{
+    const auto it = countEntries.find(what);
+    return (it != countEntries.end()) ? it->second : CountEntry();
+}
+
+std::vector<PerformanceTimer::CountEntry> PerformanceTimer::getCounts() const
+{
+    std::vector<CountEntry> entries;
+    entries.reserve(countEntries.size());
+    for (const auto &countEntry : countEntries)
+    {
+        entries.push_back(countEntry.second);
+    }
+    return entries;
+}
+
 void PerformanceTimer::clear()
 {
     actives.clear();
@@ -145,9 +178,9 @@ void PerformanceTimer::log(double min)
         const CountEntry &entry = countEntry.second;
         if (entry.numRuns > 0 && entry.maxCount > 0)
         {
-            sprintf(line,"%s: min, max, mean (%d, %d, %.3f), %d reports",
-                    entry.name.c_str(),entry.minCount,entry.maxCount,
-                    (float)entry.avgCount / (float)entry.numRuns,entry.numRuns);
+            sprintf(line,"%s: min, max, mean (%lld, %lld, %.3f), %d reports",
+                    entry.name.c_str(),(long long)entry.minCount,(long long)entry.maxCount,
+                    (double)entry.avgCount / (double)entry.numRuns,entry.numRuns);
             report(line);
         }
     }
@@ -21,6 +21,19 @@
 namespace WhirlyKit
 {
     
+void QuadDataStructure::importanceForTiles(int numTiles,
+                                           const QuadTreeIdentifier *idents,
+                                           const Mbr *mbrs,
+                                           const ViewStateRef &viewState,
+                                           const Point2f &frameSize,
+                                           double *importances)
+{
+    for (int ii=0;ii<numTiles;ii++)
+    {
+        importances[ii] = importanceForTile(idents[ii], mbrs[ii], viewState, frameSize);
+    }
+}
+
 QuadDisplayControllerNew::QuadDisplayControllerNew(QuadDataStructure *dataStructure,QuadLoaderNew *loader,SceneRenderer *renderer) :
     dataStructure(dataStructure),
     loader(loader),
@@ -201,7 +214,7 @@ bool QuadDisplayControllerNew::viewUpdate(PlatformThreadInfo *threadInfo,const V
     }
     else
     {
-        newNodes = calcCoverageImportance(minImportancePerLevel,maxTiles,true, maxRejectedImport);
+        newNodes = calcCoverageImportanceFlat(minImportancePerLevel,maxTiles,true, maxRejectedImport);
 
         // Just take the highest level as target
         for (const auto &node : newNodes)
@@ -335,6 +348,46 @@ double QuadDisplayControllerNew::importance(const Node &node)
     return dataStructure->importanceForTile(ident, nodeMbr, viewState, renderer->getFramebufferSize());
 }
 
+// Calculate importance for a group of nodes at once
+void QuadDisplayControllerNew::batchImportance(int numNodes,const ImportantNode *nodes,double *importances)
+{
+    std::vector<int> which;
+    std::vector<QuadTreeIdentifier> idents;
+    std::vector<Mbr> mbrs;
+    which.reserve(numNodes);
+    idents.reserve(numNodes);
+    mbrs.reserve(numNodes);
+
+    for (int ii=0;ii<numNodes;ii++)
+    {
+        const Node &node = nodes[ii];
+        MbrD nodeMbrD = generateMbrForNode(node);
+
+        // Scale the bounding box, possibly
+        if (mbrScaling != 1.0)
+            nodeMbrD.expandByFraction(mbrScaling-1.0);
+
+        const Mbr nodeMbr(nodeMbrD);
+        // Is this a valid tile?
+        if (!nodeMbr.inside(nodeMbr.mid())) {
+            importances[ii] = -1.0;
+            continue;
+        }
+
+        which.push_back(ii);
+        idents.emplace_back(node.x, node.y, node.level);
+        mbrs.push_back(nodeMbr);
+    }
+
+    if (which.empty())
+        return;
+
+    std::vector<double> validImports(which.size());
+    dataStructure->importanceForTiles((int)which.size(), &idents[0], &mbrs[0], viewState, renderer->getFramebufferSize(), &validImports[0]);
+    for (unsigned int ii=0;ii<which.size();ii++)
+        importances[which[ii]] = validImports[ii];
+}
+
 // Pure visibility check
 bool QuadDisplayControllerNew::visible(const Node &node) {
     MbrD nodeMbrD = generateMbrForNode(node);
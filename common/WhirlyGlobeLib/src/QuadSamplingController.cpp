@@ -18,16 +18,48 @@
 
 #import "QuadSamplingController.h"
 #import "WhirlyKitLog.h"
+#import <algorithm>
 
 namespace WhirlyKit
 {
 
+// Samplers with the same parameters evaluate the same tiles, so they share display solids
+static DisplaySolidCacheRef SharedSolidCache(const SamplingParams &params)
+{
+    static std::mutex cachesLock;
+    static std::vector<std::pair<SamplingParams,std::weak_ptr<DisplaySolidCache>>> caches;
+
+    std::lock_guard<std::mutex> guardLock(cachesLock);
+
+    // Clean out the ones nobody is using
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                [](const auto &entry) { return entry.second.expired(); }),
+                 caches.end());
+
+    for (const auto &entry : caches)
+    {
+        if (entry.first == params)
+        {
+            if (auto cache = entry.second.lock())
+            {
+                return cache;
+            }
+        }
+    }
+
+    auto cache = std::make_shared<DisplaySolidCache>(params.coordSys);
+    caches.emplace_back(params, cache);
+    return cache;
+}
+
 void QuadSamplingController::start(const SamplingParams &inParams,Scene *inScene,SceneRenderer *inRenderer)
 {
     params = inParams;
     scene = inScene;
     renderer = inRenderer;
     
+    solidCache = SharedSolidCache(params);
+
     builder = std::make_shared<QuadTileBuilder>(params.coordSys,this);
     builder->setBuildGeom(params.generateGeom);
     builder->setCoverPoles(params.coverPoles);
@@ -56,6 +88,14 @@ void QuadSamplingController::start(const SamplingParams &inParams,Scene *inScene
     displayControl->setMBRScaling(params.boundsScale);
     displayControl->setMaxTiles(params.maxTiles);
 
+    // Samplers asking for the same number of threads share a pool
+    const auto coordAdapter = scene->getCoordAdapter();
+    if (params.importanceThreads > 0 && params.coordSys && params.coordSys->isThreadSafe() &&
+        coordAdapter && coordAdapter->getCoordSystem()->isThreadSafe())
+    {
+        displayControl->setImportancePool(ThreadPool::sharedPool(params.importanceThreads));
+    }
+
     valid = true;
 }
 
@@ -70,6 +110,7 @@ void QuadSamplingController::stop()
     builderStarted = false;
     builder = nullptr;
     displayControl = nullptr;
+    solidCache = nullptr;
     builderDelegates.clear();
 }
 
@@ -159,8 +200,42 @@ double QuadSamplingController::importanceForTile(const QuadTreeIdentifier &ident
         return MAXFLOAT;
     }
     
+    DisplaySolidRef dispSolid = solidCache->getSolid(ident, mbr, coordAdapter);
     return ScreenImportance(viewState.get(), frameSize, viewState->eyeVec, 1,
-                 params.coordSys.get(), coordAdapter, mbr, ident);
+                 params.coordSys.get(), coordAdapter, mbr, ident, dispSolid);
+}
+
+void QuadSamplingController::importanceForTiles(int numTiles,
+                                                const QuadTreeIdentifier *idents,
+                                                const Mbr *mbrs,
+                                                const ViewStateRef &viewState,
+                                                const Point2f &frameSize,
+                                                double *importances)
+{
+    const auto coordAdapter = scene->getCoordAdapter();
+    if (!coordAdapter)
+    {
+        std::fill(importances, importances + numTiles, MAXFLOAT);
+        return;
+    }
+
+    // World spanning level 0 nodes sometimes have problems evaluating.
+    // They only show up at the top of the tree, so do those one at a time.
+    if (params.minImportanceTop == 0.0 &&
+        std::any_of(idents, idents + numTiles, [](const QuadTreeIdentifier &ident) { return ident.level == 0; }))
+    {
+        for (int ii=0;ii<numTiles;ii++)
+        {
+            importances[ii] = QuadSamplingController::importanceForTile(idents[ii], mbrs[ii], viewState, frameSize);
+        }
+        return;
+    }
+
+    std::vector<DisplaySolidRef> dispSolids(numTiles);
+    solidCache->getSolids(numTiles, idents, mbrs, coordAdapter, &dispSolids[0]);
+
+    ScreenImportanceBatch(viewState.get(), frameSize, 1, params.coordSys.get(), coordAdapter,
+                          numTiles, mbrs, idents, &dispSolids[0], importances);
 }
 
 void QuadSamplingController::newViewState(ViewStateRef viewState)
@@ -175,9 +250,10 @@ bool QuadSamplingController::visibilityForTile(const QuadTreeIdentifier &ident,
     if (ident.level == 0)
         return true;
     
-    DisplaySolidRef dispSolid;
+    const auto coordAdapter = scene->getCoordAdapter();
+    DisplaySolidRef dispSolid = solidCache->getSolid(ident, mbr, coordAdapter);
     return TileIsOnScreen(viewState.get(), frameSize,  params.coordSys.get(),
-                          scene->getCoordAdapter(), mbr, ident, dispSolid);
+                          coordAdapter, mbr, ident, dispSolid);
 }
     
 /// **** QuadTileBuilderDelegate methods ****
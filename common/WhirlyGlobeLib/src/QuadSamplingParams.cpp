@@ -32,7 +32,8 @@ SamplingParams::SamplingParams()
     singleLevel(false),
     forceMinLevel(true),
     forceMinLevelHeight(0.0),
-    generateGeom(true)
+    generateGeom(true),
+    importanceThreads(0)
 {
 }
 
@@ -58,6 +59,7 @@ bool SamplingParams::operator == (const SamplingParams &that) const
         forceMinLevelHeight == that.forceMinLevelHeight &&
         clipBounds == that.clipBounds &&
         generateGeom == that.generateGeom &&
+        importanceThreads == that.importanceThreads &&
         levelLoads == that.levelLoads &&
         importancePerLevel == that.importancePerLevel;
 }
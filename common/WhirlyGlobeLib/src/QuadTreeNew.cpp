@@ -19,9 +19,13 @@
 #import "QuadTreeNew.h"
 #import <WhirlyKitLog.h>
 #include <Expect.h>
+#import <unordered_set>
 
 static constexpr int maxMaxLevel = 24;
 
+// Number of nodes handed to batchImportance at once
+static constexpr int importanceBatchSize = 32;
+
 namespace WhirlyKit
 {
     
@@ -100,6 +104,14 @@ QuadTreeNew::QuadTreeNew(const MbrD &mbr,int minLevel,int maxLevel)
 {
 }
 
+void QuadTreeNew::batchImportance(int numNodes,const ImportantNode *nodes,double *importances)
+{
+    for (int ii=0;ii<numNodes;ii++)
+    {
+        importances[ii] = importance(nodes[ii]);
+    }
+}
+
 QuadTreeNew::ImportantNodeSet QuadTreeNew::calcCoverageImportance(const std::vector<double> &minImportance,int maxNodes,bool siblingNodes,std::vector<double> &maxRejectedImport)
 {
     ImportantNodeSet sortedNodes;
@@ -151,6 +163,202 @@ QuadTreeNew::ImportantNodeSet QuadTreeNew::calcCoverageImportance(const std::vec
     return retNodes;
 }
 
+QuadTreeNew::ImportantNodeSet QuadTreeNew::calcCoverageImportanceFlat(const std::vector<double> &minImportance,int maxNodes,bool siblingNodes,std::vector<double> &maxRejectedImport)
+{
+    std::vector<ImportantNode> importNodes;
+    evalImportance(minImportance,importNodes,maxRejectedImport);
+
+    // Most important first, same tie-breaking as walking an ImportantNodeSet backwards
+    const auto moreImportant = [](const ImportantNode &a,const ImportantNode &b) { return b < a; };
+
+    // Each node we visit either adds itself or was already added as a sibling,
+    //  so we rarely need more than twice the limit in order.
+    const size_t numNodes = importNodes.size();
+    size_t numSorted = std::min(numNodes, (size_t)std::max(maxNodes, 0) * 2 + 8);
+    std::partial_sort(importNodes.begin(), importNodes.begin() + numSorted, importNodes.end(), moreImportant);
+
+    std::vector<ImportantNode> retNodes;
+    retNodes.reserve(std::max(maxNodes, 0) + 4);
+    std::unordered_set<int64_t> testRetNodes(retNodes.capacity() * 2);
+    const auto addNode = [&](const ImportantNode &node)
+    {
+        if (testRetNodes.insert(node.NodeNumber()).second)
+        {
+            retNodes.push_back(node);
+        }
+    };
+
+    for (size_t ii = 0; ii < numNodes; ii++)
+    {
+        if (ii == numSorted)
+        {
+            // Ran past the sorted part, sort the rest
+            std::sort(importNodes.begin() + numSorted, importNodes.end(), moreImportant);
+            numSorted = numNodes;
+        }
+
+        const ImportantNode &ident = importNodes[ii];
+        addNode(ident);
+
+        // Make sure all the siblings are in there for some modes
+        if (siblingNodes && ident.level > minLevel && ident.level < maxLevel)
+        {
+            const Node parentIdent(ident.x/2,ident.y/2,ident.level-1);
+            for (int iy=0;iy<2;iy++)
+                for (int ix=0;ix<2;ix++)
+                    addNode(ImportantNode(Node(parentIdent.x*2+ix,parentIdent.y*2+iy,ident.level),ident.importance));
+        }
+
+        if ((int)retNodes.size() >= maxNodes || ident.importance < minImportance[ident.level])
+        {
+            break;
+        }
+    }
+
+    // Sorted input lets the set append at the end rather than search
+    std::sort(retNodes.begin(), retNodes.end());
+    ImportantNodeSet retSet;
+    for (const auto &node : retNodes)
+    {
+        retSet.insert(retSet.end(), node);
+    }
+
+    return retSet;
+}
+
+void QuadTreeNew::evalImportance(const std::vector<double> &minImportance,
+                                 std::vector<ImportantNode> &importNodes,std::vector<double> &maxRejectedImport)
+{
+    // Start at the lowest level and work our way to higher resolution
+    std::vector<ImportantNode> frontier;
+    const int numX = 1<<minLevel;
+    const int numY = 1<<minLevel;
+    frontier.reserve(numX * numY);
+    for (int iy=0;iy<numY;iy++)
+    {
+        for (int ix=0;ix<numX;ix++)
+        {
+            frontier.emplace_back(ix,iy,minLevel);
+        }
+    }
+
+    const auto pool = importancePool;
+    if (!pool)
+    {
+        evalImportanceFrontier(frontier,minImportance,importNodes,maxRejectedImport);
+        return;
+    }
+
+    // Go wide enough to keep all the threads busy, then hand out the subtrees
+    const int numThreads = pool->getNumThreads();
+    evalImportanceFrontier(frontier,minImportance,importNodes,maxRejectedImport,numThreads * 8);
+    if (frontier.empty() || UNLIKELY(shutdown))
+    {
+        return;
+    }
+
+    // Each task gets a run of siblings and everything under them
+    const int numTasks = std::min((int)frontier.size(), numThreads * 4);
+    std::vector<std::vector<ImportantNode>> taskNodes(numTasks);
+    std::vector<std::vector<double>> taskRejected(numTasks);
+    ThreadPool::Group group;
+    for (int ti = 0; ti < numTasks; ti++)
+    {
+        pool->run(group, [&,ti]{
+            const size_t begin = frontier.size() * ti / numTasks;
+            const size_t end = frontier.size() * (ti + 1) / numTasks;
+            std::vector<ImportantNode> taskFrontier(frontier.begin() + begin, frontier.begin() + end);
+            taskRejected[ti].resize(maxRejectedImport.size(), 0.0);
+            evalImportanceFrontier(taskFrontier,minImportance,taskNodes[ti],taskRejected[ti]);
+        });
+    }
+    pool->wait(group);
+
+    // Merge in task order, so we get the same answer every time
+    for (int ti = 0; ti < numTasks; ti++)
+    {
+        importNodes.insert(importNodes.end(), taskNodes[ti].begin(), taskNodes[ti].end());
+        for (size_t li = 0; li < taskRejected[ti].size(); li++)
+        {
+            maxRejectedImport[li] = std::max(maxRejectedImport[li], taskRejected[ti][li]);
+        }
+    }
+}
+
+void QuadTreeNew::evalImportanceFrontier(std::vector<ImportantNode> &frontier,const std::vector<double> &minImportance,
+                                         std::vector<ImportantNode> &importNodes,std::vector<double> &maxRejectedImport,
+                                         size_t splitSize)
+{
+    std::vector<ImportantNode> nextFrontier;
+    std::vector<double> imports;
+    while (!frontier.empty())
+    {
+        const int level = frontier.front().level;
+        if (level > maxLevel)
+        {
+            frontier.clear();
+            break;
+        }
+        if (splitSize > 0 && frontier.size() >= splitSize)
+        {
+            // Leave the rest to the caller
+            break;
+        }
+
+        assert(level >= 0 && (size_t)level < minImportance.size() && (size_t)level < maxRejectedImport.size());
+        const auto levelMinImport = minImportance[level];
+        nextFrontier.clear();
+        nextFrontier.reserve(frontier.size() * 4);
+
+        imports.resize(frontier.size());
+        for (size_t start = 0; start < frontier.size(); start += importanceBatchSize)
+        {
+            // Stop if we get a shutdown signal
+            if (UNLIKELY(shutdown))
+            {
+                frontier.clear();
+                return;
+            }
+
+            const int num = (int)std::min(frontier.size() - start, (size_t)importanceBatchSize);
+            batchImportance(num, &frontier[start], &imports[start]);
+        }
+
+        for (size_t ni = 0; ni < frontier.size(); ni++)
+        {
+            auto &node = frontier[ni];
+            node.importance = imports[ni];
+
+            if (node.importance < levelMinImport && levelMinImport != MAXFLOAT)
+            {
+                const double ratio = (levelMinImport > 0.0) ? (node.importance / levelMinImport) : 1.0;
+                if (ratio > 0)
+                {
+                    maxRejectedImport[level] = std::max(ratio, maxRejectedImport[level]);
+                }
+                continue;
+            }
+
+            importNodes.push_back(node);
+
+            if (level < maxLevel)
+            {
+                // Add the children
+                for (int iy=0;iy<2;iy++)
+                {
+                    const int indY = 2*node.y + iy;
+                    for (int ix=0;ix<2;ix++)
+                    {
+                        nextFrontier.emplace_back(2*node.x + ix, indY, level + 1);
+                    }
+                }
+            }
+        }
+
+        frontier.swap(nextFrontier);
+    }
+}
+
 void QuadTreeNew::evalNodeImportance(ImportantNode &node,const std::vector<double> &minImportance,
                                      ImportantNodeSet &importSet,std::vector<double> &maxRejectedImport)
 {
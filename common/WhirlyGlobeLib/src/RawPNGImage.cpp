@@ -19,14 +19,526 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <memory>
+#include <algorithm>
+#include <zlib.h>
 #import "WhirlyKitLog.h"
 #import "RawPNGImage.h"
 #import "lodepng.h"
+#if defined(__SSE2__)
+#import <emmintrin.h>
+#elif defined(__ARM_NEON)
+#import <arm_neon.h>
+#endif
 
 namespace WhirlyKit
 {
 
+// Turn the value map into a straight lookup.  Negative entries leave the value alone.
+static void BuildValueLookup(const std::vector<int> &valueMap,unsigned char lookup[256])
+{
+    for (int ii=0;ii<256;ii++)
+    {
+        const int newVal = (ii < (int)valueMap.size()) ? valueMap[ii] : -1;
+        lookup[ii] = (newVal >= 0) ? (unsigned char)newVal : (unsigned char)ii;
+    }
+}
+
+unsigned int LodePNGDecoder::inspect(const unsigned char *data,size_t length,
+                                     unsigned int &width,unsigned int &height,int &byteWidth)
+{
+    LodePNGState pngState;
+    lodepng_state_init(&pngState);
+    const unsigned int err = lodepng_inspect(&width, &height, &pngState, data, length);
+    byteWidth = (pngState.info_png.color.colortype == LCT_GREY) ? 1 : 4;
+    lodepng_state_cleanup(&pngState);
+    return err;
+}
+
+unsigned int LodePNGDecoder::decode(const unsigned char *data,size_t length,
+                                    const std::vector<int> &valueMap,
+                                    unsigned char *dest)
+{
+    unsigned int width = 0,height = 0;
+    int byteWidth = 0;
+    unsigned int err = inspect(data, length, width, height, byteWidth);
+    if (err)
+        return err;
+
+    unsigned char *outData = NULL;
+    err = lodepng_decode_memory(&outData, &width, &height, data, length, (byteWidth == 1) ? LCT_GREY : LCT_RGBA, 8);
+    if (!err)
+    {
+        const size_t len = (size_t)width * height * byteWidth;
+        if (byteWidth == 1 && !valueMap.empty())
+        {
+            unsigned char lookup[256];
+            BuildValueLookup(valueMap, lookup);
+            for (size_t ii=0;ii<len;ii++)
+                dest[ii] = lookup[outData[ii]];
+        } else
+            memcpy(dest, outData, len);
+    }
+    free(outData);
+
+    return err;
+}
+
+namespace
+{
+
+static const unsigned char PNGSignature[8] = {137,80,78,71,13,10,26,10};
+
+// Rows are inflated a bunch at a time, this is about how much.
+// zlib only takes its fast path with a decent amount of room to write to.
+static const size_t WindowSize = 32768;
+// Room after the rows for the 4 byte loads on 3 byte pixels
+static const size_t RowTail = 16;
+
+// Don't bother with anything bigger than this, lodepng can sort it out
+static const size_t MaxStreamingPixels = 1<<28;
+
+typedef enum {PNGGrey=0,PNGRGB=2,PNGGreyAlpha=4,PNGRGBA=6} PNGColorType;
+
+struct PNGHeader
+{
+    uint32_t width,height;
+    int bitDepth;
+    int colorType;
+    int interlace;
+};
+
+static inline uint32_t ReadUInt32BE(const unsigned char *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+// Pull the header out of the IHDR chunk, which has to come first
+static bool ReadPNGHeader(const unsigned char *data,size_t length,PNGHeader &header)
+{
+    if (length < 33 || memcmp(data, PNGSignature, 8) != 0)
+        return false;
+    if (ReadUInt32BE(data + 8) != 13 || memcmp(data + 12, "IHDR", 4) != 0)
+        return false;
+
+    const unsigned char *ihdr = data + 16;
+    header.width = ReadUInt32BE(ihdr);
+    header.height = ReadUInt32BE(ihdr + 4);
+    header.bitDepth = ihdr[8];
+    header.colorType = ihdr[9];
+    header.interlace = ihdr[12];
+    // Compression and filter methods only have the one value
+    return header.width > 0 && header.height > 0 && ihdr[10] == 0 && ihdr[11] == 0;
+}
+
+static int ChannelCount(int colorType)
+{
+    switch (colorType)
+    {
+        case PNGGrey:      return 1;
+        case PNGGreyAlpha: return 2;
+        case PNGRGB:       return 3;
+        case PNGRGBA:      return 4;
+        default:           return 0;
+    }
+}
+
+// Same answer as the usual version from the spec, but without the branches
+static inline int PaethPredictor(int a,int b,int c)
+{
+    const int thresh = 3*c - (a + b);
+    const int lo = (a < b) ? a : b;
+    const int hi = (a < b) ? b : a;
+    const int t0 = (hi <= thresh) ? lo : c;
+    return (thresh <= lo) ? hi : t0;
+}
+
+// Undo a row filter in place.  There's nothing to the left of the first pixel, which counts as zero.
+static void UnfilterRowScalar(int filter,unsigned char *cur,const unsigned char *prev,size_t stride,int bpp)
+{
+    switch (filter)
+    {
+        case 1:
+            for (size_t ii=bpp;ii<stride;ii++)
+                cur[ii] += cur[ii-bpp];
+            break;
+        case 2:
+            for (size_t ii=0;ii<stride;ii++)
+                cur[ii] += prev[ii];
+            break;
+        case 3:
+            for (size_t ii=0;ii<(size_t)bpp;ii++)
+                cur[ii] += prev[ii] >> 1;
+            for (size_t ii=bpp;ii<stride;ii++)
+                cur[ii] += (unsigned char)(((int)cur[ii-bpp] + (int)prev[ii]) >> 1);
+            break;
+        case 4:
+            for (size_t ii=0;ii<(size_t)bpp;ii++)
+                cur[ii] += prev[ii];
+            for (size_t ii=bpp;ii<stride;ii++)
+                cur[ii] += (unsigned char)PaethPredictor(cur[ii-bpp], prev[ii], prev[ii-bpp]);
+            break;
+        default:
+            break;
+    }
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+
+static inline uint32_t LoadPixel(const unsigned char *data)
+{
+    uint32_t val;
+    memcpy(&val, data, 4);
+    return val;
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+// Sub, average, and Paeth for 3 and 4 byte pixels, one pixel per vector.
+// The left pixel depends on the one before, so this is about as wide as it gets.
+static void UnfilterRowVector(int filter,unsigned char *cur,const unsigned char *prev,size_t stride,int bpp)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero,c = zero;
+    for (size_t ii=0;ii<stride;ii+=bpp)
+    {
+        const __m128i raw = _mm_cvtsi32_si128(LoadPixel(cur + ii));
+        const __m128i b = _mm_cvtsi32_si128(LoadPixel(prev + ii));
+        __m128i x;
+        switch (filter)
+        {
+            case 1:
+                x = _mm_add_epi8(raw, a);
+                break;
+            case 3:
+            {
+                // avg_epu8 rounds up, so knock off the odd bit
+                const __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+                x = _mm_add_epi8(raw, avg);
+                break;
+            }
+            case 4:
+            default:
+            {
+                const __m128i a16 = _mm_unpacklo_epi8(a, zero);
+                const __m128i b16 = _mm_unpacklo_epi8(b, zero);
+                const __m128i c16 = _mm_unpacklo_epi8(c, zero);
+                const __m128i bc = _mm_sub_epi16(b16, c16);
+                const __m128i ac = _mm_sub_epi16(a16, c16);
+                const __m128i abc = _mm_add_epi16(bc, ac);
+                const __m128i pa = _mm_max_epi16(bc, _mm_sub_epi16(zero, bc));
+                const __m128i pb = _mm_max_epi16(ac, _mm_sub_epi16(zero, ac));
+                const __m128i pc = _mm_max_epi16(abc, _mm_sub_epi16(zero, abc));
+                const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+                // Ties go to a, then b, then c
+                const __m128i isA = _mm_cmpeq_epi16(smallest, pa);
+                const __m128i isB = _mm_cmpeq_epi16(smallest, pb);
+                __m128i pred = _mm_or_si128(_mm_and_si128(isB, b16), _mm_andnot_si128(isB, c16));
+                pred = _mm_or_si128(_mm_and_si128(isA, a16), _mm_andnot_si128(isA, pred));
+                x = _mm_add_epi8(raw, _mm_packus_epi16(pred, pred));
+                break;
+            }
+        }
+
+        const uint32_t out = (uint32_t)_mm_cvtsi128_si32(x);
+        memcpy(cur + ii, &out, bpp);
+        // Only the low bpp bytes matter from here on
+        a = (bpp == 4) ? x : _mm_and_si128(x, _mm_cvtsi32_si128(0x00FFFFFF));
+        c = b;
+    }
+}
+
+#elif defined(__ARM_NEON)
+
+// Sub, average, and Paeth for 3 and 4 byte pixels, one pixel per vector.
+// The left pixel depends on the one before, so this is about as wide as it gets.
+static void UnfilterRowVector(int filter,unsigned char *cur,const unsigned char *prev,size_t stride,int bpp)
+{
+    const uint32x2_t pixelMask = vdup_n_u32((bpp == 4) ? 0xFFFFFFFF : 0x00FFFFFF);
+    uint8x8_t a = vdup_n_u8(0),c = vdup_n_u8(0);
+    for (size_t ii=0;ii<stride;ii+=bpp)
+    {
+        const uint8x8_t raw = vreinterpret_u8_u32(vdup_n_u32(LoadPixel(cur + ii)));
+        const uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(LoadPixel(prev + ii)));
+        uint8x8_t x;
+        switch (filter)
+        {
+            case 1:
+                x = vadd_u8(raw, a);
+                break;
+            case 3:
+                x = vadd_u8(raw, vhadd_u8(a, b));
+                break;
+            case 4:
+            default:
+            {
+                const int16x8_t a16 = vreinterpretq_s16_u16(vmovl_u8(a));
+                const int16x8_t b16 = vreinterpretq_s16_u16(vmovl_u8(b));
+                const int16x8_t c16 = vreinterpretq_s16_u16(vmovl_u8(c));
+                const int16x8_t bc = vsubq_s16(b16, c16);
+                const int16x8_t ac = vsubq_s16(a16, c16);
+                const int16x8_t pa = vabsq_s16(bc);
+                const int16x8_t pb = vabsq_s16(ac);
+                const int16x8_t pc = vabsq_s16(vaddq_s16(bc, ac));
+                const int16x8_t smallest = vminq_s16(pc, vminq_s16(pa, pb));
+                // Ties go to a, then b, then c
+                int16x8_t pred = vbslq_s16(vceqq_s16(smallest, pb), b16, c16);
+                pred = vbslq_s16(vceqq_s16(smallest, pa), a16, pred);
+                x = vadd_u8(raw, vmovn_u16(vreinterpretq_u16_s16(pred)));
+                break;
+            }
+        }
+
+        const uint32_t out = vget_lane_u32(vreinterpret_u32_u8(x), 0);
+        memcpy(cur + ii, &out, bpp);
+        // Only the low bpp bytes matter from here on
+        a = vreinterpret_u8_u32(vand_u32(vreinterpret_u32_u8(x), pixelMask));
+        c = b;
+    }
+}
+
+#endif
+
+static void UnfilterRow(int filter,unsigned char *cur,const unsigned char *prev,size_t stride,int bpp)
+{
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    if ((bpp == 3 || bpp == 4) && (filter == 1 || filter == 3 || filter == 4))
+    {
+        UnfilterRowVector(filter, cur, prev, stride, bpp);
+        return;
+    }
+#endif
+    UnfilterRowScalar(filter, cur, prev, stride, bpp);
+}
+
+// Write an unfiltered row out as 1 byte gray or 4 byte RGBA.  16 bit values keep their high byte.
+static void EmitRow(const PNGHeader &header,const unsigned char *row,const unsigned char *lookup,unsigned char *dest)
+{
+    const uint32_t width = header.width;
+    const int step = header.bitDepth / 8;
+    switch (header.colorType)
+    {
+        case PNGGrey:
+            if (lookup)
+            {
+                for (uint32_t ii=0;ii<width;ii++)
+                    dest[ii] = lookup[row[ii*step]];
+            } else if (step == 1)
+                memcpy(dest, row, width);
+            else {
+                for (uint32_t ii=0;ii<width;ii++)
+                    dest[ii] = row[ii*step];
+            }
+            break;
+        case PNGGreyAlpha:
+            for (uint32_t ii=0;ii<width;ii++,row+=2*step,dest+=4)
+            {
+                dest[0] = dest[1] = dest[2] = row[0];
+                dest[3] = row[step];
+            }
+            break;
+        case PNGRGB:
+            for (uint32_t ii=0;ii<width;ii++,row+=3*step,dest+=4)
+            {
+                dest[0] = row[0];
+                dest[1] = row[step];
+                dest[2] = row[2*step];
+                dest[3] = 255;
+            }
+            break;
+        case PNGRGBA:
+            if (step == 1)
+                memcpy(dest, row, 4*(size_t)width);
+            else {
+                for (uint32_t ii=0;ii<width;ii++,row+=8,dest+=4)
+                {
+                    dest[0] = row[0];
+                    dest[1] = row[2];
+                    dest[2] = row[4];
+                    dest[3] = row[6];
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Inflate state and row buffers, kept around between decodes on the same thread
+struct PNGScratch
+{
+    PNGScratch()
+    {
+        memset(&stream, 0, sizeof(stream));
+        valid = (inflateInit(&stream) == Z_OK);
+    }
+    ~PNGScratch()
+    {
+        if (valid)
+            inflateEnd(&stream);
+    }
+
+    z_stream stream;
+    bool valid;
+    // Rows as they come out of inflate, each with a filter byte in front
+    std::vector<unsigned char> window;
+    // Last row of the previous window
+    std::vector<unsigned char> prevRow;
+};
+
+static thread_local PNGScratch pngScratch;
+
+}
+
+StreamingPNGDecoder::StreamingPNGDecoder()
+: fallback(std::make_shared<LodePNGDecoder>())
+{
+}
+
+unsigned int StreamingPNGDecoder::inspect(const unsigned char *data,size_t length,
+                                          unsigned int &width,unsigned int &height,int &byteWidth)
+{
+    PNGHeader header;
+    if (!ReadPNGHeader(data, length, header))
+        return fallback->inspect(data, length, width, height, byteWidth);
+
+    width = header.width;
+    height = header.height;
+    byteWidth = (header.colorType == PNGGrey) ? 1 : 4;
+    return 0;
+}
+
+unsigned int StreamingPNGDecoder::decode(const unsigned char *data,size_t length,
+                                         const std::vector<int> &valueMap,
+                                         unsigned char *dest)
+{
+    if (decodeStreaming(data, length, valueMap, dest))
+        return 0;
+    return fallback->decode(data, length, valueMap, dest);
+}
+
+bool StreamingPNGDecoder::decodeStreaming(const unsigned char *data,size_t length,
+                                          const std::vector<int> &valueMap,
+                                          unsigned char *dest)
+{
+    PNGHeader header;
+    if (!ReadPNGHeader(data, length, header))
+        return false;
+    const int channels = ChannelCount(header.colorType);
+    if (channels == 0 || (header.bitDepth != 8 && header.bitDepth != 16) || header.interlace != 0)
+        return false;
+    if ((size_t)header.width * header.height > MaxStreamingPixels)
+        return false;
+
+    PNGScratch &scratch = pngScratch;
+    if (!scratch.valid || inflateReset(&scratch.stream) != Z_OK)
+        return false;
+    z_stream &stream = scratch.stream;
+
+    const int bpp = channels * header.bitDepth / 8;
+    const size_t stride = (size_t)header.width * bpp;
+    const size_t rowBytes = stride + 1;
+    const size_t windowRows = std::max((size_t)1,WindowSize / rowBytes);
+    scratch.window.resize(windowRows * rowBytes + RowTail);
+    // Nothing above the first row
+    scratch.prevRow.assign(stride + RowTail, 0);
+    unsigned char *window = scratch.window.data();
+
+    unsigned char lookup[256];
+    const bool useLookup = header.colorType == PNGGrey && !valueMap.empty();
+    if (useLookup)
+        BuildValueLookup(valueMap, lookup);
+
+    const size_t destStride = (size_t)header.width * ((header.colorType == PNGGrey) ? 1 : 4);
+    uint32_t row = 0;
+    // Rows in the window we've already dealt with
+    size_t windowRow = 0;
+    stream.next_out = window;
+    stream.avail_out = (uInt)(windowRows * rowBytes);
+
+    size_t pos = 8;
+    bool streamDone = false;
+    while (pos + 12 <= length && row < header.height && !streamDone)
+    {
+        const uint32_t chunkLen = ReadUInt32BE(data + pos);
+        const unsigned char *chunkType = data + pos + 4;
+        const unsigned char *chunkData = data + pos + 8;
+        if (chunkLen > length - pos - 12)
+            return false;
+        if (crc32(0, chunkType, chunkLen + 4) != ReadUInt32BE(chunkData + chunkLen))
+            return false;
+        pos += 12 + (size_t)chunkLen;
+
+        if (!memcmp(chunkType, "IEND", 4))
+            break;
+        // Transparent color key, which lodepng turns into alpha
+        if (!memcmp(chunkType, "tRNS", 4) && header.colorType == PNGRGB)
+            return false;
+        if (memcmp(chunkType, "IDAT", 4) != 0)
+            continue;
+
+        stream.next_in = (Bytef *)chunkData;
+        stream.avail_in = chunkLen;
+        while (stream.avail_in > 0 && row < header.height)
+        {
+            const int ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END)
+                return false;
+
+            // Unfilter and copy out whatever rows are complete
+            const size_t fullRows = (stream.next_out - window) / rowBytes;
+            for (;windowRow < fullRows && row < header.height;windowRow++,row++)
+            {
+                unsigned char *cur = window + windowRow * rowBytes + 1;
+                const unsigned char *prev = windowRow ? cur - rowBytes : scratch.prevRow.data();
+                const int filter = cur[-1];
+                if (filter > 4)
+                    return false;
+                UnfilterRow(filter, cur, prev, stride, bpp);
+                EmitRow(header, cur, useLookup ? lookup : NULL, dest + row * destStride);
+            }
+
+            // Start over at the top of the window once it's full
+            if (stream.avail_out == 0)
+            {
+                memcpy(scratch.prevRow.data(), window + (windowRows - 1) * rowBytes + 1, stride);
+                windowRow = 0;
+                stream.next_out = window;
+                stream.avail_out = (uInt)(windowRows * rowBytes);
+            }
+
+            if (ret == Z_STREAM_END)
+            {
+                streamDone = true;
+                break;
+            }
+        }
+    }
+
+    return row == header.height;
+}
+
+// Set by the app, if it wants.  Every tile reads it, so it's swapped atomically rather than locked.
+static RawPNGDecoderRef rawPNGDecoder;
+
+void SetRawPNGDecoder(RawPNGDecoderRef decoder)
+{
+    std::atomic_store(&rawPNGDecoder, std::move(decoder));
+}
+
+RawPNGDecoderRef GetRawPNGDecoder()
+{
+    if (RawPNGDecoderRef decoder = std::atomic_load(&rawPNGDecoder))
+        return decoder;
+
+    static const RawPNGDecoderRef defaultDecoder = std::make_shared<StreamingPNGDecoder>();
+    return defaultDecoder;
+}
+
 unsigned char *RawPNGImageLoaderInterpreter(unsigned int &width,unsigned int &height,
                                           const unsigned char *data,size_t length,
                                           const std::vector<int> &valueMap,
@@ -36,15 +548,12 @@ unsigned char *RawPNGImageLoaderInterpreter(unsigned int &width,unsigned int &he
     unsigned char *outData = NULL;
 
     try {
-        LodePNGState pngState;
-        lodepng_state_init(&pngState);
-        err = lodepng_inspect(&width, &height, &pngState, data, length);
-        if (pngState.info_png.color.colortype == LCT_GREY) {
-            byteWidth = 1;
-            err = lodepng_decode_memory(&outData, &width, &height, data, length, LCT_GREY, 8);
-        } else {
-            byteWidth = 4;
-            err = lodepng_decode_memory(&outData, &width, &height, data, length, LCT_RGBA, 8);
+        const RawPNGDecoderRef decoder = GetRawPNGDecoder();
+        err = decoder->inspect(data, length, width, height, byteWidth);
+        if (!err)
+        {
+            outData = (unsigned char *)malloc((size_t)width * height * byteWidth);
+            err = outData ? decoder->decode(data, length, valueMap, outData) : -1;
         }
     }
     catch (const std::exception &ex) {
@@ -55,20 +564,14 @@ unsigned char *RawPNGImageLoaderInterpreter(unsigned int &width,unsigned int &he
         wkLogLevel(Error, "Exception in MaplyQuadImageLoader::dataForTile");
         err = -1;
     }
-    
-    // Remap data values
-    if (byteWidth == 1 && !valueMap.empty()) {
-        unsigned char *data = outData;
-        for (unsigned int ii=0;ii<width*height;ii++) {
-            int newVal = valueMap[*data];
-            if (newVal >= 0)
-                *data = newVal;
-            data++;
-        }
+
+    if (err && outData)
+    {
+        free(outData);
+        outData = NULL;
     }
-    
+
     return outData;
 }
 
 }
-
@@ -128,7 +128,6 @@ Scene::~Scene()
             std::unique_lock<std::mutex>(coordAdapterLock, std::try_to_lock),
             std::unique_lock<std::mutex>(drawablesLock, std::try_to_lock),
             std::unique_lock<std::mutex>(textureLock, std::try_to_lock),
-            std::unique_lock<std::mutex>(changeRequestLock, std::try_to_lock),
             std::unique_lock<std::mutex>(subTexLock, std::try_to_lock),
             std::unique_lock<std::mutex>(managerLock, std::try_to_lock),
             std::unique_lock<std::mutex>(programLock, std::try_to_lock),
@@ -173,6 +172,7 @@ Scene::~Scene()
     }
 #endif
 
+    drainChangeRequests();
     auto theChangeRequests = std::move(changeRequests);
     for (auto *theChangeRequest : theChangeRequests)
     {
@@ -180,12 +180,7 @@ Scene::~Scene()
     }
     theChangeRequests.clear();
 
-    auto timedChanges = std::move(timedChangeRequests);
-    for (auto *theChangeRequest : timedChanges)
-    {
-        delete theChangeRequest;
-    }
-    timedChanges.clear();
+    timedChangeRequests.clear();
 
     activeModels.clear();
     
@@ -222,33 +217,42 @@ void Scene::setDisplayAdapter(CoordSystemDisplayAdapter *newCoordAdapter)
 // Add change requests to our list
 void Scene::addChangeRequests(const ChangeSet &newChanges)
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
-    
-    for (ChangeRequest *change : newChanges)
-    {
-        if (change && change->when > 0.0)
-            timedChangeRequests.insert(change);
-        else
-            changeRequests.push_back(change);
-    }
+    pendingChangeRequests.push(newChanges);
 }
 
 // Add a single change request
 void Scene::addChangeRequest(ChangeRequest *newChange)
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
-
-    if (newChange && newChange->when > 0.0)
-        timedChangeRequests.insert(newChange);
-    else
-        changeRequests.push_back(newChange);
+    pendingChangeRequests.push(newChange);
 }
 
 int Scene::getNumChangeRequests() const
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
+    return pendingChangeRequests.size() + numChangeRequests;
+}
+
+void Scene::drainChangeRequests()
+{
+    if (pendingChangeRequests.empty())
+    {
+        return;
+    }
+
+    ChangeSet newChanges;
+    newChanges.reserve(pendingChangeRequests.size());
+    pendingChangeRequests.drain(newChanges);
+
+    // Timed changes wait in the heap, the rest run in order
+    for (ChangeRequest *change : newChanges)
+    {
+        if (change && change->when > 0.0)
+            timedChangeRequests.push(change);
+        else
+            changeRequests.push_back(change);
+    }
 
-    return changeRequests.size();
+    numChangeRequests = (int)changeRequests.size();
+    nextTimedChange = timedChangeRequests.nextTime();
 }
 
 DrawableRef Scene::getDrawable(SimpleIdentity drawId) const
@@ -390,22 +394,20 @@ TimeInterval Scene::getBaseTime() const
     
 int Scene::preProcessChanges(WhirlyKit::View *view,SceneRenderer *renderer,__unused TimeInterval now)
 {
-    ChangeSet preRequests;
+    drainChangeRequests();
 
+    // Just doing the ones that require a pre-process
+    ChangeSet preRequests;
+    for (auto &req : changeRequests)
     {
-        std::lock_guard<std::mutex> guardLock(changeRequestLock);
-        // Just doing the ones that require a pre-process
-        for (auto &req : changeRequests)
+        if (req && req->needPreExecute())
         {
-            if (req && req->needPreExecute())
-            {
-                preRequests.push_back(req);
-                req = nullptr;
-            }
+            preRequests.push_back(req);
+            req = nullptr;
         }
     }
 
-    // Run these outside of the lock, since they might use the lock
+    // These may add more change requests, which will be picked up in processChanges
     for (auto req : preRequests)
     {
         req->execute(this,renderer,view);
@@ -416,39 +418,24 @@ int Scene::preProcessChanges(WhirlyKit::View *view,SceneRenderer *renderer,__unu
 }
 
 // Process outstanding changes.
-// We'll grab the lock and we're only expecting to be called in the rendering thread
+// We're only expecting to be called in the rendering thread
 int Scene::processChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeInterval now)
 {
-    // Set up a local collection of approximately the same capacity before locking
-    decltype(changeRequests) localChanges;
-    localChanges.reserve(changeRequests.capacity());
+    drainChangeRequests();
 
+    // See if any of the timed changes are ready
+    if (!timedChangeRequests.empty())
     {
-        std::lock_guard<std::mutex> guardLock(changeRequestLock);
-
-        // See if any of the timed changes are ready
-        if (!timedChangeRequests.empty())
-        {
-            // Establish the range of changes to be moved
-            const auto beg = timedChangeRequests.begin();
-            auto end = beg;
-            while (end != timedChangeRequests.end() && (*end)->when <= now)
-            {
-                ++end;
-            }
-
-            // Move them
-            if (end != beg)
-            {
-                std::copy(beg, end, std::back_inserter(changeRequests));
-                timedChangeRequests.erase(beg, end);
-            }
-        }
-
-        // Move the outstanding changes to the local collection and release the lock
-        localChanges.swap(changeRequests);
+        timedChangeRequests.popReady(now, changeRequests);
+        nextTimedChange = timedChangeRequests.nextTime();
     }
 
+    // Take the outstanding changes, leaving a collection of approximately the same capacity
+    decltype(changeRequests) localChanges;
+    localChanges.reserve(changeRequests.capacity());
+    localChanges.swap(changeRequests);
+    numChangeRequests = 0;
+
     for (auto req : localChanges)
     {
         if (req)
@@ -463,18 +450,13 @@ int Scene::processChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeInte
     
 bool Scene::hasChanges(TimeInterval now) const
 {
-    bool changes = false;
-    std::unique_lock<std::mutex> lock(changeRequestLock,std::try_to_lock);
-    if (lock.owns_lock())
+    bool changes = !pendingChangeRequests.empty() || numChangeRequests > 0;
+    if (!changes)
     {
-        changes = !changeRequests.empty();
-        
-        if (!changes && !timedChangeRequests.empty())
-            changes = now >= (*timedChangeRequests.begin())->when;
-
-        lock.unlock();
+        const TimeInterval nextTime = nextTimedChange;
+        changes = nextTime > 0.0 && now >= nextTime;
     }
-    
+
     // How about the active models?
     for (const auto& model : activeModels)
         if (model->hasUpdate()) {
@@ -22,6 +22,7 @@
 #import "VectorData.h"
 #import "SceneRenderer.h"
 #import <array>
+#import <algorithm>
 
 using namespace Eigen;
 using namespace WhirlyKit;
@@ -148,67 +149,91 @@ DisplaySolid::DisplaySolid(const QuadTreeIdentifier &nodeIdent,
     valid = true;
 }
 
-double PolyImportance(const Point3dVector &poly,const Point3d &norm,ViewState *viewState,const WhirlyKit::Point2f &frameSize)
+// Importance of a single polygon for one of the view offsets
+static double ClippedPolyImportance(const Vector4dVector &clipSpacePts,const Point3d &norm,double origArea,
+                                    ViewState *viewState,const WhirlyKit::Point2f &frameSize,unsigned int offi);
+
+static double PolyImportanceForOffset(const Point3dVector &poly,const Point3d &norm,double origArea,
+                                      ViewState *viewState,const WhirlyKit::Point2f &frameSize,unsigned int offi)
 {
-    double import = 0.0;
-    const double origArea = std::abs(PolygonArea(poly,norm));
+    Vector4dVector pts;
+    pts.reserve(poly.size());
+    for (const auto &pt : poly)
+    {
+        // Run through the model transform
+        const Vector4d modPt = viewState->fullMatrices[offi] * Vector4d(pt.x(),pt.y(),pt.z(),1.0);
+        // And then the projection matrix.  Now we're in clip space
+        pts.emplace_back(viewState->projMatrix * modPt);
+    }
+    
+    // The points are in clip space, so clip!
+    Vector4dVector clipSpacePts;
+    clipSpacePts.reserve(2*pts.size());
+    ClipHomogeneousPolygon(std::move(pts),clipSpacePts);
 
-    for (unsigned int offi=0;offi<viewState->viewMatrices.size();offi++)
+    return ClippedPolyImportance(clipSpacePts,norm,origArea,viewState,frameSize,offi);
+}
+
+// Importance of a polygon that's already been clipped, scaled by how much of it made it to the screen
+static double ClippedPolyImportance(const Vector4dVector &clipSpacePts,const Point3d &norm,double origArea,
+                                    ViewState *viewState,const WhirlyKit::Point2f &frameSize,unsigned int offi)
+{
+    // Outside the viewing frustum, so ignore it
+    if (clipSpacePts.empty())
+        return 0.0;
+    
+    // Project to the screen
+    Point2dVector screenPts;
+    screenPts.reserve(clipSpacePts.size());
+
+    const Point2d halfFrameSize(frameSize.x()/2.0,frameSize.y()/2.0);
+    for (auto &outPt : clipSpacePts)
     {
-        Vector4dVector pts;
-        pts.reserve(poly.size());
-        for (const auto &pt : poly)
-        {
-            // Run through the model transform
-            const Vector4d modPt = viewState->fullMatrices[offi] * Vector4d(pt.x(),pt.y(),pt.z(),1.0);
-            // And then the projection matrix.  Now we're in clip space
-            pts.emplace_back(viewState->projMatrix * modPt);
-        }
-        
-        // The points are in clip space, so clip!
-        Vector4dVector clipSpacePts;
-        clipSpacePts.reserve(2*pts.size());
-        ClipHomogeneousPolygon(std::move(pts),clipSpacePts);
-        
-        // Outside the viewing frustum, so ignore it
-        if (clipSpacePts.empty())
-            continue;
-        
-        // Project to the screen
-        Point2dVector screenPts;
-        screenPts.reserve(clipSpacePts.size());
+        screenPts.emplace_back(outPt.x()/outPt.w() * halfFrameSize.x() + halfFrameSize.x(),
+                               outPt.y()/outPt.w() * halfFrameSize.y() + halfFrameSize.y());
+    }
 
-        const Point2d halfFrameSize(frameSize.x()/2.0,frameSize.y()/2.0);
-        for (auto &outPt : clipSpacePts)
-        {
-            screenPts.emplace_back(outPt.x()/outPt.w() * halfFrameSize.x() + halfFrameSize.x(),
-                                   outPt.y()/outPt.w() * halfFrameSize.y() + halfFrameSize.y());
-        }
-        
-        const double screenArea = CalcLoopArea(screenPts);
-        // The polygon came out backwards, so toss it
-        if (!std::isfinite(screenArea) || screenArea <= 0.0)
-            continue;
-        
-        // Now project the screen points back into model space
-        Point3dVector backPts;
-        backPts.reserve(screenPts.size());
-        for (unsigned int ii=0;ii<screenPts.size();ii++)
-        {
-            const Vector4d modelPt = viewState->invProjMatrix * clipSpacePts[ii];
-            const Vector4d backPt = viewState->invFullMatrices[offi] * modelPt;
-            backPts.emplace_back(backPt.x(),backPt.y(),backPt.z());
-        }
+    // Start the loop from the same corner no matter where the input started,
+    //  so the rounding in the areas doesn't depend on the order of the corners
+    const auto start = std::min_element(screenPts.begin(),screenPts.end(),[](const Point2d &a,const Point2d &b)
+                                         { return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y()); });
+    const unsigned int startIdx = (unsigned int)(start - screenPts.begin());
+    std::rotate(screenPts.begin(),start,screenPts.end());
+
+    const double screenArea = CalcLoopArea(screenPts);
+    // The polygon came out backwards, so toss it
+    if (!std::isfinite(screenArea) || screenArea <= 0.0)
+        return 0.0;
+    
+    // Now project the screen points back into model space
+    Point3dVector backPts;
+    backPts.reserve(screenPts.size());
+    for (unsigned int ii=0;ii<screenPts.size();ii++)
+    {
+        const Vector4d modelPt = viewState->invProjMatrix * clipSpacePts[(ii+startIdx)%clipSpacePts.size()];
+        const Vector4d backPt = viewState->invFullMatrices[offi] * modelPt;
+        backPts.emplace_back(backPt.x(),backPt.y(),backPt.z());
+    }
+
+    // Then calculate the area
+    const double backArea = std::abs(PolygonArea(backPts,norm));
 
-        // Then calculate the area
-        const double backArea = std::abs(PolygonArea(backPts,norm));
+    // Now we know how much of the original polygon made it out to the screen
+    // We can scale its importance accordingly.
+    // This gets rid of small slices of big tiles not getting loaded
+    const double scale = (backArea == 0.0) ? 1.0 : origArea / backArea;
+
+    return std::abs(screenArea) * scale;
+}
 
-        // Now we know how much of the original polygon made it out to the screen
-        // We can scale its importance accordingly.
-        // This gets rid of small slices of big tiles not getting loaded
-        const double scale = (backArea == 0.0) ? 1.0 : origArea / backArea;
+double PolyImportance(const Point3dVector &poly,const Point3d &norm,ViewState *viewState,const WhirlyKit::Point2f &frameSize)
+{
+    double import = 0.0;
+    const double origArea = std::abs(PolygonArea(poly,norm));
 
-        const double newImport =  std::abs(screenArea) * scale;
+    for (unsigned int offi=0;offi<viewState->viewMatrices.size();offi++)
+    {
+        const double newImport = PolyImportanceForOffset(poly,norm,origArea,viewState,frameSize,offi);
         if (newImport > import)
         {
             import = newImport;
@@ -300,6 +325,134 @@ bool DisplaySolid::isOnScreenForViewState(ViewState *viewState,const Point2f &fr
     return false;
 }
 
+DisplaySolidCache::DisplaySolidCache(CoordSystemRef coordSys,size_t maxEntries) :
+    coordSys(std::move(coordSys)),
+    maxEntries(std::max(maxEntries,(size_t)1))
+{
+}
+
+DisplaySolidRef DisplaySolidCache::findLocked(const Key &key,const Mbr &mbr)
+{
+    const auto it = entryMap.find(key);
+    if (it == entryMap.end() || !(it->second->mbr == mbr))
+    {
+        numMisses++;
+        return DisplaySolidRef();
+    }
+
+    numHits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->solid;
+}
+
+void DisplaySolidCache::addLocked(const Key &key,const Mbr &mbr,const DisplaySolidRef &solid)
+{
+    const auto it = entryMap.find(key);
+    if (it != entryMap.end())
+    {
+        // Somebody else got here first or the bounds changed
+        it->second->mbr = mbr;
+        it->second->solid = solid;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.push_front(Entry { key, mbr, solid });
+    entryMap[key] = entries.begin();
+
+    while (entries.size() > maxEntries)
+    {
+        entryMap.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+DisplaySolidRef DisplaySolidCache::getSolid(const QuadTreeIdentifier &ident,const Mbr &mbr,CoordSystemDisplayAdapter *coordAdapter)
+{
+    const Key key { ident.x, ident.y, ident.level, coordAdapter->getGeneration() };
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+        if (auto solid = findLocked(key, mbr))
+        {
+            return solid;
+        }
+    }
+
+    // Build it outside the lock, it's the expensive part
+    auto solid = std::make_shared<DisplaySolid>(ident,mbr,0.0,0.0,coordSys.get(),coordAdapter);
+
+    std::lock_guard<std::mutex> guardLock(lock);
+    addLocked(key, mbr, solid);
+    return solid;
+}
+
+void DisplaySolidCache::getSolids(int numTiles,const QuadTreeIdentifier *idents,const Mbr *mbrs,
+                                  CoordSystemDisplayAdapter *coordAdapter,DisplaySolidRef *solids)
+{
+    int numMissing = 0;
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+        for (int ii = 0; ii < numTiles; ii++)
+        {
+            const Key key { idents[ii].x, idents[ii].y, idents[ii].level, coordAdapter->getGeneration() };
+            solids[ii] = findLocked(key, mbrs[ii]);
+            if (!solids[ii])
+            {
+                numMissing++;
+            }
+        }
+    }
+    if (numMissing == 0)
+    {
+        return;
+    }
+
+    for (int ii = 0; ii < numTiles; ii++)
+    {
+        if (!solids[ii])
+        {
+            solids[ii] = std::make_shared<DisplaySolid>(idents[ii],mbrs[ii],0.0,0.0,coordSys.get(),coordAdapter);
+        }
+    }
+
+    std::lock_guard<std::mutex> guardLock(lock);
+    for (int ii = 0; ii < numTiles; ii++)
+    {
+        // Only the misses need to go back in, the hits are already at the front
+        const Key key { idents[ii].x, idents[ii].y, idents[ii].level, coordAdapter->getGeneration() };
+        const auto it = entryMap.find(key);
+        if (it == entryMap.end() || it->second->solid != solids[ii])
+        {
+            addLocked(key, mbrs[ii], solids[ii]);
+        }
+    }
+}
+
+size_t DisplaySolidCache::size() const
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    return entries.size();
+}
+
+size_t DisplaySolidCache::getNumHits() const
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    return numHits;
+}
+
+size_t DisplaySolidCache::getNumMisses() const
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    return numMisses;
+}
+
+void DisplaySolidCache::clear()
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    entries.clear();
+    entryMap.clear();
+}
+
 bool TileIsOnScreen(ViewState *viewState,const WhirlyKit::Point2f &frameSize,WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,const WhirlyKit::Mbr &nodeMbr,const WhirlyKit::QuadTreeIdentifier &nodeIdent,DisplaySolidRef &dispSolid)
 {
     if (!dispSolid)
@@ -362,4 +515,170 @@ double ScreenImportance(ViewState *viewState,const WhirlyKit::Point2f &frameSize
     return import;
 }
     
+namespace
+{
+// Clip space outcodes, matching the planes ClipHomogeneousPolygon uses
+inline int ClipOutcode(double x,double y,double z,double w)
+{
+    return (x < -w ? 1 : 0) | (x > w ? 2 : 0) |
+           (y < -w ? 4 : 0) | (y > w ? 8 : 0) |
+           (z < -w ? 16 : 0) | (z > w ? 32 : 0);
+}
+
+// A four sided polygon from one of the display solids in the batch
+struct BatchPoly
+{
+    int tile;
+    const Point3dVector *poly;
+    const Point3d *norm;
+    double origArea;
+    double import;
+};
+}
+
+void ScreenImportanceBatch(ViewState *viewState,const WhirlyKit::Point2f &frameSize,int pixelsSquare,
+                           WhirlyKit::CoordSystem *srcSystem,WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,
+                           int numTiles,const WhirlyKit::Mbr *nodeMbrs,const QuadTreeIdentifier *nodeIdents,
+                           DisplaySolidRef *dispSolids,double *importances)
+{
+    const Point3d &eyePos = viewState->eyePos;
+    const bool isFlat = viewState->coordAdapter->isFlat();
+    const double pixelScale = 1.0 / (pixelsSquare * pixelsSquare);
+
+    // Gather up the polygons facing the viewer
+    std::vector<DisplaySolidRef> localSolids(dispSolids ? 0 : numTiles);
+    std::vector<BatchPoly> polys;
+    polys.reserve(numTiles * 4);
+    std::vector<double> scaleFactors(numTiles, 0.0);
+    for (int ti = 0; ti < numTiles; ti++)
+    {
+        importances[ti] = 0.0;
+
+        DisplaySolidRef &dispSolid = dispSolids ? dispSolids[ti] : localSolids[ti];
+        if (!dispSolid)
+        {
+            dispSolid = std::make_shared<DisplaySolid>(nodeIdents[ti],nodeMbrs[ti],0.0,0.0,srcSystem,coordAdapter);
+        }
+
+        // This means the tile is degenerate (as far as we're concerned)
+        if (!dispSolid->valid)
+        {
+            continue;
+        }
+
+        // If the viewer is inside the bounds, the node is maximally important (duh)
+        if (!isFlat && dispSolid->isInside(eyePos))
+        {
+            importances[ti] = MAXFLOAT * pixelScale;
+            continue;
+        }
+
+        // The flat map case is optimized to only evaluate one poly, since there's no curvature
+        scaleFactors[ti] = (dispSolid->polys.size() > 1 ? 0.5 : 1.0) * pixelScale;
+
+        for (unsigned int ii = 0; ii < dispSolid->polys.size(); ii++)
+        {
+            if (dispSolid->normals[ii].dot(eyePos) >= 0.0)
+            {
+                const auto &poly = dispSolid->polys[ii];
+                if (poly.size() == 4)
+                {
+                    polys.push_back(BatchPoly { ti, &poly, &dispSolid->normals[ii],
+                                                std::abs(PolygonArea(poly,dispSolid->normals[ii])), 0.0 });
+                }
+                else
+                {
+                    importances[ti] += PolyImportance(poly, dispSolid->normals[ii], viewState, frameSize) * scaleFactors[ti];
+                }
+            }
+        }
+    }
+
+    const size_t numPolys = polys.size();
+    if (numPolys > 0)
+    {
+        // Corners relative to the first one in each polygon, structure of arrays
+        const size_t numPts = numPolys * 4;
+        std::vector<float> dx(numPts),dy(numPts),dz(numPts);
+        for (size_t pi = 0; pi < numPolys; pi++)
+        {
+            const Point3dVector &poly = *polys[pi].poly;
+            for (int ci = 0; ci < 4; ci++)
+            {
+                dx[pi*4+ci] = (float)(poly[ci].x() - poly[0].x());
+                dy[pi*4+ci] = (float)(poly[ci].y() - poly[0].y());
+                dz[pi*4+ci] = (float)(poly[ci].z() - poly[0].z());
+            }
+        }
+
+        std::vector<float> cx(numPts),cy(numPts),cz(numPts),cw(numPts);
+        const double halfFrameX = frameSize.x()/2.0, halfFrameY = frameSize.y()/2.0;
+
+        for (unsigned int offi = 0; offi < viewState->viewMatrices.size(); offi++)
+        {
+            // Model and projection in one go
+            const Matrix4d projFull = viewState->projMatrix * viewState->fullMatrices[offi];
+            const Matrix4f projFullf = projFull.cast<float>();
+            const float m00 = projFullf(0,0), m01 = projFullf(0,1), m02 = projFullf(0,2);
+            const float m10 = projFullf(1,0), m11 = projFullf(1,1), m12 = projFullf(1,2);
+            const float m20 = projFullf(2,0), m21 = projFullf(2,1), m22 = projFullf(2,2);
+            const float m30 = projFullf(3,0), m31 = projFullf(3,1), m32 = projFullf(3,2);
+
+            // Offsets only need the linear part.  Simple enough to vectorize.
+            for (size_t ii = 0; ii < numPts; ii++)
+            {
+                cx[ii] = m00 * dx[ii] + m01 * dy[ii] + m02 * dz[ii];
+                cy[ii] = m10 * dx[ii] + m11 * dy[ii] + m12 * dz[ii];
+                cz[ii] = m20 * dx[ii] + m21 * dy[ii] + m22 * dz[ii];
+                cw[ii] = m30 * dx[ii] + m31 * dy[ii] + m32 * dz[ii];
+            }
+
+            for (size_t pi = 0; pi < numPolys; pi++)
+            {
+                auto &batchPoly = polys[pi];
+                const Point3d &p0 = (*batchPoly.poly)[0];
+                const Vector4d base = projFull * Vector4d(p0.x(),p0.y(),p0.z(),1.0);
+
+                int andCode = ~0, orCode = 0;
+                double sx[4],sy[4];
+                for (int ci = 0; ci < 4; ci++)
+                {
+                    const size_t ii = pi*4+ci;
+                    const double x = base.x()+cx[ii], y = base.y()+cy[ii], z = base.z()+cz[ii], w = base.w()+cw[ii];
+                    const int code = ClipOutcode(x,y,z,w);
+                    andCode &= code;
+                    orCode |= code;
+                    sx[ci] = x/w * halfFrameX + halfFrameX;
+                    sy[ci] = y/w * halfFrameY + halfFrameY;
+                }
+
+                double import = 0.0;
+                if (orCode == 0)
+                {
+                    // Entirely on screen, so nothing gets clipped and the whole polygon counts.
+                    // That's just the screen area (same loop sum as CalcLoopArea), within about 1e-5 of the double version.
+                    const double screenArea = (sx[0]*sy[1] - sx[1]*sy[0]) + (sx[1]*sy[2] - sx[2]*sy[1]) +
+                                              (sx[2]*sy[3] - sx[3]*sy[2]) + (sx[3]*sy[0] - sx[0]*sy[3]);
+                    if (std::isfinite(screenArea) && screenArea > 0.0)
+                    {
+                        import = screenArea;
+                    }
+                }
+                else if (andCode == 0)
+                {
+                    // Partly clipped, take the long way around
+                    import = PolyImportanceForOffset(*batchPoly.poly,*batchPoly.norm,batchPoly.origArea,viewState,frameSize,offi);
+                }
+
+                batchPoly.import = std::max(batchPoly.import, import);
+            }
+        }
+
+        for (const auto &batchPoly : polys)
+        {
+            importances[batchPoly.tile] += batchPoly.import * scaleFactors[batchPoly.tile];
+        }
+    }
+}
+
 }
@@ -281,6 +281,35 @@ void main()
 }
 )";
 
+// Texture alpha is a distance field with the edge at 0.5.
+// The falloff is kept to about a pixel on screen however far the glyph is scaled.
+// Contexts are ES 2.0, so derivatives come from the extension, with a fixed falloff
+//  on the rare driver that doesn't have it.
+static const char *fragmentShaderSDFTri = R"(
+#ifdef GL_OES_standard_derivatives
+#extension GL_OES_standard_derivatives : enable
+#endif
+precision highp float;
+
+uniform sampler2D s_baseMap0;
+uniform bool  u_hasTexture;
+
+varying vec2      v_texCoord;
+varying vec4      v_color;
+
+void main()
+{
+    float dist = u_hasTexture ? texture2D(s_baseMap0, v_texCoord).a : 1.0;
+#ifdef GL_OES_standard_derivatives
+    float width = max(0.7 * fwidth(dist), 0.001);
+#else
+    float width = 0.1;
+#endif
+    float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+    gl_FragColor = v_color * alpha;
+}
+)";
+
 ProgramGLES *BuildScreenSpaceProgramGLES(const std::string &name,SceneRenderer *render)
 {
     ProgramGLES *shader = new ProgramGLES(name,vertexShaderTri,fragmentShaderTri);
@@ -341,4 +370,34 @@ ProgramGLES *BuildScreenSpaceMotion2DProgramGLES(const std::string &name,SceneRe
     return shader;
 }
 
+ProgramGLES *BuildScreenSpaceSDFProgramGLES(const std::string &name,SceneRenderer *render)
+{
+    ProgramGLES *shader = new ProgramGLES(name,vertexShaderTri,fragmentShaderSDFTri);
+    if (!shader->isValid())
+    {
+        delete shader;
+        shader = nullptr;
+    }
+    
+    if (shader)
+        glUseProgram(shader->getProgram());
+    
+    return shader;
+}
+
+ProgramGLES *BuildScreenSpaceSDFMotionProgramGLES(const std::string &name,SceneRenderer *render)
+{
+    ProgramGLES *shader = new ProgramGLES(name,vertexShaderMotionTri,fragmentShaderSDFTri);
+    if (!shader->isValid())
+    {
+        delete shader;
+        shader = nullptr;
+    }
+    
+    if (shader)
+        glUseProgram(shader->getProgram());
+    
+    return shader;
+}
+
 }
@@ -66,6 +66,72 @@ bool BillboardSelectable::operator < (const BillboardSelectable &that) const
     return selectID < that.selectID;
 }
 
+static void AddToBounds(const Point3d &pt,bool &first,BoundingBoxTree::Box &box)
+{
+    if (first)
+    {
+        box.ll = box.ur = pt;
+        first = false;
+    }
+    else
+    {
+        box.ll = box.ll.cwiseMin(pt);
+        box.ur = box.ur.cwiseMax(pt);
+    }
+}
+
+// Bounds of the selectables we keep in trees, in display space
+static bool SelectableBounds(const RectSelectable3D &sel,BoundingBoxTree::Box &box)
+{
+    bool first = true;
+    for (const auto &pt : sel.pts)
+    {
+        AddToBounds(pt.cast<double>(), first, box);
+    }
+    return !first;
+}
+
+static bool SelectableBounds(const PolytopeSelectable &sel,BoundingBoxTree::Box &box)
+{
+    bool first = true;
+    for (const auto &poly : sel.polys)
+    {
+        for (const auto &pt : poly)
+        {
+            AddToBounds(pt.cast<double>() + sel.centerPt, first, box);
+        }
+    }
+    return !first;
+}
+
+static bool SelectableBounds(const LinearSelectable &sel,BoundingBoxTree::Box &box)
+{
+    bool first = true;
+    for (const auto &pt : sel.pts)
+    {
+        AddToBounds(pt, first, box);
+    }
+    return !first;
+}
+
+// Only enabled selectables go in the trees.  The geometry doesn't change once it's added.
+template <typename T>
+static void UpdateSelectableTree(BoundingBoxTree &tree,const T &sel)
+{
+    if (sel.enable && sel.selectID != EmptyIdentity)
+    {
+        BoundingBoxTree::Box box;
+        if (!tree.hasBox(sel.selectID) && SelectableBounds(sel, box))
+        {
+            tree.addBox(sel.selectID, box);
+        }
+    }
+    else
+    {
+        tree.removeBox(sel.selectID);
+    }
+}
+
 SelectionManager::SelectedObject::SelectedObject(double distIn3D,double screenDist) :
     SelectedObject(std::vector<SimpleIdentity>(), distIn3D, screenDist)
 {
@@ -122,7 +188,11 @@ void SelectionManager::addSelectableRect(SimpleIdentity selectId,const Point3f *
     }
 
     std::lock_guard<std::mutex> guardLock(lock);
-    rect3Dselectables.insert(std::move(newSelect));
+    const auto result = rect3Dselectables.insert(std::move(newSelect));
+    if (result.second)
+    {
+        UpdateSelectableTree(rect3DTree, *result.first);
+    }
 }
 
 // Add a rectangle (in 3-space) for selection, but only between the given visibilities
@@ -144,7 +214,11 @@ void SelectionManager::addSelectableRect(SimpleIdentity selectId,const Point3f *
     }
 
     std::lock_guard<std::mutex> guardLock(lock);
-    rect3Dselectables.insert(std::move(newSelect));
+    const auto result = rect3Dselectables.insert(std::move(newSelect));
+    if (result.second)
+    {
+        UpdateSelectableTree(rect3DTree, *result.first);
+    }
 }
 
 /// Add a screen space rectangle (2D) for selection, between the given visibilities
@@ -171,6 +245,7 @@ void SelectionManager::addSelectableScreenRect(SimpleIdentity selectId,const Poi
     
     std::lock_guard<std::mutex> guardLock(lock);
     rect2Dselectables.insert(std::move(newSelect));
+    screenRectGeneration++;
 }
 
 /// Add a screen space rectangle (2D) for selection, between the given visibilities
@@ -243,7 +318,11 @@ void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const Poin
     
     {
         std::lock_guard<std::mutex> guardLock(lock);
-        polytopeSelectables.insert(std::move(newSelect));
+        const auto result = polytopeSelectables.insert(std::move(newSelect));
+        if (result.second)
+        {
+            UpdateSelectableTree(polytopeTree, *result.first);
+        }
     }
 }
 
@@ -282,7 +361,11 @@ void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const Poin
     }
     
     std::lock_guard<std::mutex> guardLock(lock);
-    polytopeSelectables.insert(std::move(newSelect));
+    const auto result = polytopeSelectables.insert(std::move(newSelect));
+    if (result.second)
+    {
+        UpdateSelectableTree(polytopeTree, *result.first);
+    }
 }
 
 void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const BBox &bbox,
@@ -331,7 +414,11 @@ void SelectionManager::addPolytope(SimpleIdentity selectId,
     }
     
     std::lock_guard<std::mutex> guardLock(lock);
-    polytopeSelectables.insert(std::move(newSelect));
+    const auto result = polytopeSelectables.insert(std::move(newSelect));
+    if (result.second)
+    {
+        UpdateSelectableTree(polytopeTree, *result.first);
+    }
 }
 
 void SelectionManager::addPolytopeFromBox(SimpleIdentity selectId,const Point3d &ll,const Point3d &ur,
@@ -470,7 +557,11 @@ void SelectionManager::addSelectableLinear(SimpleIdentity selectId,const Point3d
     newSelect.pts = pts;
 
     std::lock_guard<std::mutex> guardLock(lock);
-    linearSelectables.insert(std::move(newSelect));
+    const auto result = linearSelectables.insert(std::move(newSelect));
+    if (result.second)
+    {
+        UpdateSelectableTree(linearTree, *result.first);
+    }
 }
 
 void SelectionManager::addSelectableBillboard(SimpleIdentity selectId,const Point3d &center,
@@ -505,7 +596,8 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         RectSelectable3D sel = *it;
         rect3Dselectables.erase(it);
         sel.enable = enable;
-        rect3Dselectables.insert(std::move(sel));
+        const auto result = rect3Dselectables.insert(std::move(sel));
+        UpdateSelectableTree(rect3DTree, *result.first);
     }
 
     const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
@@ -515,6 +607,7 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         rect2Dselectables.erase(it2);
         sel.enable = enable;
         rect2Dselectables.insert(std::move(sel));
+        screenRectGeneration++;
     }
 
     const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
@@ -532,7 +625,8 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         PolytopeSelectable sel = *it3;
         polytopeSelectables.erase(it3);
         sel.enable = enable;
-        polytopeSelectables.insert(std::move(sel));
+        const auto result = polytopeSelectables.insert(std::move(sel));
+        UpdateSelectableTree(polytopeTree, *result.first);
     }
 
     const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
@@ -550,7 +644,8 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         LinearSelectable sel = *it5;
         linearSelectables.erase(it5);
         sel.enable = enable;
-        linearSelectables.insert(std::move(sel));
+        const auto result = linearSelectables.insert(std::move(sel));
+        UpdateSelectableTree(linearTree, *result.first);
     }
 
     const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
@@ -576,7 +671,8 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             RectSelectable3D sel = *it;
             rect3Dselectables.erase(it);
             sel.enable = enable;
-            rect3Dselectables.insert(std::move(sel));
+            const auto result = rect3Dselectables.insert(std::move(sel));
+            UpdateSelectableTree(rect3DTree, *result.first);
         }
 
         const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
@@ -586,6 +682,7 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             rect2Dselectables.erase(it2);
             sel.enable = enable;
             rect2Dselectables.insert(std::move(sel));
+            screenRectGeneration++;
         }
 
         const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
@@ -603,7 +700,8 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             PolytopeSelectable sel = *it3;
             polytopeSelectables.erase(it3);
             sel.enable = enable;
-            polytopeSelectables.insert(std::move(sel));
+            const auto result = polytopeSelectables.insert(std::move(sel));
+            UpdateSelectableTree(polytopeTree, *result.first);
         }
 
         const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
@@ -621,7 +719,8 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             LinearSelectable sel = *it5;
             linearSelectables.erase(it5);
             sel.enable = enable;
-            linearSelectables.insert(std::move(sel));
+            const auto result = linearSelectables.insert(std::move(sel));
+            UpdateSelectableTree(linearTree, *result.first);
         }
 
         const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
@@ -642,11 +741,17 @@ void SelectionManager::removeSelectable(SimpleIdentity selectID)
 
     const auto it = rect3Dselectables.find(RectSelectable3D(selectID));
     if (it != rect3Dselectables.end())
+    {
         rect3Dselectables.erase(it);
+        rect3DTree.removeBox(selectID);
+    }
 
     const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
     if (it2 != rect2Dselectables.end())
+    {
         rect2Dselectables.erase(it2);
+        screenRectGeneration++;
+    }
 
     const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
     if (itM != movingRect2Dselectables.end())
@@ -654,7 +759,10 @@ void SelectionManager::removeSelectable(SimpleIdentity selectID)
 
     const auto it3 = polytopeSelectables.find(PolytopeSelectable(selectID));
     if (it3 != polytopeSelectables.end())
+    {
         polytopeSelectables.erase(it3);
+        polytopeTree.removeBox(selectID);
+    }
 
     const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
     if (it3a != movingPolytopeSelectables.end())
@@ -662,7 +770,10 @@ void SelectionManager::removeSelectable(SimpleIdentity selectID)
 
     const auto it5 = linearSelectables.find(LinearSelectable(selectID));
     if (it5 != linearSelectables.end())
+    {
         linearSelectables.erase(it5);
+        linearTree.removeBox(selectID);
+    }
 
     const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
     if (it4 != billboardSelectables.end())
@@ -681,6 +792,7 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
         {
             //found = true;
             rect3Dselectables.erase(it);
+            rect3DTree.removeBox(selectID);
         }
 
         const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
@@ -688,6 +800,7 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
         {
             //found = true;
             rect2Dselectables.erase(it2);
+            screenRectGeneration++;
         }
 
         const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
@@ -702,6 +815,7 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
         {
             //found = true;
             polytopeSelectables.erase(it3);
+            polytopeTree.removeBox(selectID);
         }
 
         const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
@@ -716,6 +830,7 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
         {
             //found = true;
             linearSelectables.erase(it5);
+            linearTree.removeBox(selectID);
         }
 
         const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
@@ -730,9 +845,9 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
 //        NSLog(@"Tried to delete selectable that doesn't exist.");
 }
 
-void SelectionManager::getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenPts,TimeInterval now)
+void SelectionManager::getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenPts)
 {
-    screenPts.reserve(screenPts.size() + rect2Dselectables.size() + movingRect2Dselectables.size());
+    screenPts.reserve(screenPts.size() + rect2Dselectables.size());
     for (const auto &sel : rect2Dselectables)
     {
         if (sel.selectID != EmptyIdentity && sel.enable)
@@ -753,7 +868,11 @@ void SelectionManager::getScreenSpaceObjects(const PlacementInfo &pInfo,std::vec
             }
         }
     }
+}
 
+void SelectionManager::getMovingScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenPts,TimeInterval now)
+{
+    screenPts.reserve(screenPts.size() + movingRect2Dselectables.size());
     for (const auto & sel : movingRect2Dselectables)
     {
         if (sel.selectID != EmptyIdentity)
@@ -831,6 +950,356 @@ void SelectionManager::projectWorldPointToScreen(const Point3d &worldLoc,const P
     }
 }
 
+// Project the corners of a box the way pointOnScreenFromDisplay does.
+// If any of it is behind the eye the corners don't bound the rest, so we give up.
+static bool ProjectBoxToScreen(const BoundingBoxTree::Box &box,ViewState *viewState,const Matrix4d &modelMat,
+                               const Point2f &frameSize,float scale,Mbr &screenMbr)
+{
+    for (int ii=0;ii<8;ii++)
+    {
+        const Point3d pt((ii & 1) ? box.ur.x() : box.ll.x(),
+                         (ii & 2) ? box.ur.y() : box.ll.y(),
+                         (ii & 4) ? box.ur.z() : box.ll.z());
+        const Vector4d eyePt = modelMat * Vector4d(pt.x(),pt.y(),pt.z(),1.0);
+        if (eyePt.w() <= 0.0 || eyePt.z() >= 0.0)
+        {
+            return false;
+        }
+        const Point2f screenPt = viewState->pointOnScreenFromDisplay(pt, &modelMat, frameSize);
+        screenMbr.addPoint(Point2f(screenPt.x()/scale,screenPt.y()/scale));
+    }
+    return true;
+}
+
+// Project the corners of a box the way ClipAndProjectPolygon does
+static bool ProjectBoxToClip(const BoundingBoxTree::Box &box,const Matrix4d &modelMat,const Matrix4d &projMat,
+                             const Point2f &frameSize,Mbr &screenMbr)
+{
+    const Point2d halfFrameSize(frameSize.x()/2.0,frameSize.y()/2.0);
+    for (int ii=0;ii<8;ii++)
+    {
+        const Vector4d modPt = modelMat * Vector4d((ii & 1) ? box.ur.x() : box.ll.x(),
+                                                   (ii & 2) ? box.ur.y() : box.ll.y(),
+                                                   (ii & 4) ? box.ur.z() : box.ll.z(),1.0);
+        const Vector4d clipPt = projMat * modPt;
+        if (clipPt.w() <= 0.0)
+        {
+            return false;
+        }
+        screenMbr.addPoint(Point2f(clipPt.x()/clipPt.w() * halfFrameSize.x()+halfFrameSize.x(),
+                                   frameSize.y() - (clipPt.y()/clipPt.w() * halfFrameSize.y()+halfFrameSize.y())));
+    }
+    return true;
+}
+
+static bool ScreenMbrsOverlap(const Mbr &a,const Mbr &b)
+{
+    return a.ll().x() <= b.ur().x() && b.ll().x() <= a.ur().x() &&
+           a.ll().y() <= b.ur().y() && b.ll().y() <= a.ur().y();
+}
+
+// Polytopes whose bounds might project into the search area, in ID order
+static void FindPolytopeCandidates(const BoundingBoxTree &tree,const SelectionManager::PlacementInfo &pInfo,
+                                   const Mbr &searchMbr,std::vector<SimpleIdentity> &candidates)
+{
+    candidates.clear();
+    tree.query([&](const BoundingBoxTree::Box &box) {
+            Mbr screenMbr;
+            return !ProjectBoxToClip(box,pInfo.viewState->fullMatrices[0],pInfo.viewState->projMatrix,pInfo.frameSizeScale,screenMbr) ||
+                   ScreenMbrsOverlap(screenMbr,searchMbr);
+        },
+        [&](SimpleIdentity selectID) { candidates.push_back(selectID); });
+    std::sort(candidates.begin(),candidates.end());
+}
+
+// Linears whose bounds might project into the search area, in ID order
+static void FindLinearCandidates(const BoundingBoxTree &tree,const SelectionManager::PlacementInfo &pInfo,float scale,
+                                 const Mbr &searchMbr,std::vector<SimpleIdentity> &candidates)
+{
+    candidates.clear();
+    tree.query([&](const BoundingBoxTree::Box &box) {
+            // Segments can join points from different wraps, so look at all of them together
+            Mbr screenMbr;
+            for (const auto &modelAndViewMat : pInfo.viewState->fullMatrices)
+            {
+                if (!ProjectBoxToScreen(box,pInfo.viewState.get(),modelAndViewMat,pInfo.frameSize,scale,screenMbr))
+                {
+                    return true;
+                }
+            }
+            return ScreenMbrsOverlap(screenMbr,searchMbr);
+        },
+        [&](SimpleIdentity selectID) { candidates.push_back(selectID); });
+    std::sort(candidates.begin(),candidates.end());
+}
+
+// 3D rectangles whose bounds might project into the search area, in ID order
+static void FindRect3DCandidates(const BoundingBoxTree &tree,const SelectionManager::PlacementInfo &pInfo,
+                                 const Mbr &searchMbr,std::vector<SimpleIdentity> &candidates)
+{
+    candidates.clear();
+    tree.query([&](const BoundingBoxTree::Box &box) {
+            Mbr screenMbr;
+            return !ProjectBoxToScreen(box,pInfo.viewState.get(),pInfo.viewState->fullMatrices[0],pInfo.frameSizeScale,1.0f,screenMbr) ||
+                   ScreenMbrsOverlap(screenMbr,searchMbr);
+        },
+        [&](SimpleIdentity selectID) { candidates.push_back(selectID); });
+    std::sort(candidates.begin(),candidates.end());
+}
+
+// Do two line segments cross or touch?
+static bool SegmentsIntersect(const Point2f &a0,const Point2f &a1,const Point2f &b0,const Point2f &b1)
+{
+    const auto cross = [](const Point2f &o,const Point2f &a,const Point2f &b) {
+        return (double)(a.x()-o.x())*(b.y()-o.y()) - (double)(a.y()-o.y())*(b.x()-o.x());
+    };
+    const double d0 = cross(b0,b1,a0), d1 = cross(b0,b1,a1);
+    const double d2 = cross(a0,a1,b0), d3 = cross(a0,a1,b1);
+    if (((d0 > 0 && d1 < 0) || (d0 < 0 && d1 > 0)) &&
+        ((d2 > 0 && d3 < 0) || (d2 < 0 && d3 > 0)))
+    {
+        return true;
+    }
+
+    // Collinear or touching at an end
+    const auto onSegment = [](const Point2f &p0,const Point2f &p1,const Point2f &pt) {
+        return std::min(p0.x(),p1.x()) <= pt.x() && pt.x() <= std::max(p0.x(),p1.x()) &&
+               std::min(p0.y(),p1.y()) <= pt.y() && pt.y() <= std::max(p0.y(),p1.y());
+    };
+    return (d0 == 0 && onSegment(b0,b1,a0)) || (d1 == 0 && onSegment(b0,b1,a1)) ||
+           (d2 == 0 && onSegment(a0,a1,b0)) || (d3 == 0 && onSegment(a0,a1,b1));
+}
+
+// Does a line segment touch the inside of the region?
+static bool SegmentOverlapsRegion(const Point2f &p0,const Point2f &p1,const Point2fVector &region)
+{
+    if (PointInPolygon(p0, region) || PointInPolygon(p1, region))
+    {
+        return true;
+    }
+    for (unsigned int ii=0;ii<region.size();ii++)
+    {
+        if (SegmentsIntersect(p0,p1,region[ii],region[(ii+1)%region.size()]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Does a screen polygon overlap the region at all?
+static bool PolygonOverlapsRegion(const Point2fVector &poly,const Point2fVector &region)
+{
+    if (poly.empty())
+    {
+        return false;
+    }
+    // Region could be entirely inside the polygon
+    if (poly.size() > 2 && PointInPolygon(region[0], poly))
+    {
+        return true;
+    }
+    for (unsigned int ii=0;ii<poly.size();ii++)
+    {
+        if (SegmentOverlapsRegion(poly[ii],poly[(ii+1)%poly.size()],region))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Slop for the tree and grid checks, so rounding can't throw out a real hit
+static const float SelectionSlop = 1.0f;
+
+void SelectionManager::calcScreenPolys(const ScreenSpaceObjectLocation &screenObj,const PlacementInfo &pInfo,
+                                       const Matrix4d &modelTrans,const Matrix4d &normalMat,
+                                       const Point2f &frameBufferSize,std::vector<Point2fVector> &polys)
+{
+    if (screenObj.shapeIDs.empty())
+    {
+        return;
+    }
+
+    Point2dVector projPts;
+    projectWorldPointToScreen(screenObj.dispLoc, pInfo, projPts, renderer->getScale());
+
+    // Work through the possible locations of the projected point
+    for (const auto &projPt : projPts)
+    {
+        Mbr objMbr = screenObj.mbr;
+        objMbr.ll() += Point2f(projPt.x(),projPt.y());
+        objMbr.ur() += Point2f(projPt.x(),projPt.y());
+
+        // Make sure it's on the screen at least
+        if (!pInfo.frameMbr.overlaps(objMbr))
+        {
+            continue;
+        }
+
+        Matrix2d screenRotMat;
+        float screenRot = 0.0;
+        Point2f objPt = projPt.cast<float>();
+        if (screenObj.rotation != 0.0)
+        {
+            screenRotMat = calcScreenRot(screenRot,pInfo.viewState,pInfo.globeViewState,&screenObj,objPt,modelTrans,normalMat,frameBufferSize);
+        }
+
+        polys.emplace_back();
+        Point2fVector &screenPts = polys.back();
+        screenPts.reserve(screenObj.pts.size());
+        if (screenRot == 0.0)
+        {
+            for (unsigned int kk=0;kk<screenObj.pts.size();kk++)
+            {
+                const Point2d &screenObjPt = screenObj.pts[kk];
+                Point2d theScreenPt = Point2d(screenObjPt.x(),-screenObjPt.y()) + projPt + Point2d(screenObj.offset.x(),-screenObj.offset.y());
+                screenPts.emplace_back(theScreenPt.x(),theScreenPt.y());
+            }
+        }
+        else
+        {
+            for (unsigned int kk=0;kk<screenObj.pts.size();kk++)
+            {
+                const Point2d screenObjPt = screenRotMat * (screenObj.pts[kk] + Point2d(screenObj.offset.x(),screenObj.offset.y()));
+                Point2d theScreenPt = Point2d(screenObjPt.x(),-screenObjPt.y()) + projPt;
+                screenPts.emplace_back(theScreenPt.x(),theScreenPt.y());
+            }
+        }
+    }
+}
+
+void SelectionManager::updateScreenObjectCache(const PlacementInfo &pInfo,const Matrix4d &modelTrans,
+                                               const Matrix4d &normalMat,const Point2f &frameBufferSize,
+                                               int layoutGeneration)
+{
+    auto &cache = screenObjCache;
+    const auto &viewState = pInfo.viewState;
+    const float scale = renderer->getScale();
+
+    // Same view, same objects, and we can use what we had
+    if (cache.viewState && cache.rectGeneration == screenRectGeneration &&
+        cache.layoutGeneration == layoutGeneration &&
+        cache.frameSize == pInfo.frameSize && cache.scale == scale)
+    {
+        bool sameView = (cache.viewState == viewState);
+        if (!sameView && viewState->isSameAs(cache.viewState.get()) &&
+            viewState->fullMatrices.size() == cache.viewState->fullMatrices.size())
+        {
+            sameView = true;
+            for (unsigned int offi=1;offi<viewState->fullMatrices.size();offi++)
+            {
+                if (viewState->fullMatrices[offi] != cache.viewState->fullMatrices[offi])
+                {
+                    sameView = false;
+                    break;
+                }
+            }
+        }
+        if (sameView)
+        {
+            return;
+        }
+    }
+
+    cache.viewState = viewState;
+    cache.frameSize = pInfo.frameSize;
+    cache.scale = scale;
+    cache.rectGeneration = screenRectGeneration;
+    cache.layoutGeneration = layoutGeneration;
+
+    cache.objs.clear();
+    getScreenSpaceObjects(pInfo,cache.objs);
+    cache.numRectObjs = (int)cache.objs.size();
+    if (const auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager))
+    {
+        layoutManager->getScreenSpaceObjects(pInfo,cache.objs);
+    }
+
+    // Project everything and figure out how much of the screen it covers
+    cache.polys.clear();
+    cache.polys.resize(cache.objs.size());
+    std::vector<Mbr> objMbrs(cache.objs.size());
+    cache.gridMbr.reset();
+    for (unsigned int ii=0;ii<cache.objs.size();ii++)
+    {
+        calcScreenPolys(cache.objs[ii],pInfo,modelTrans,normalMat,frameBufferSize,cache.polys[ii]);
+        for (const auto &poly : cache.polys[ii])
+        {
+            objMbrs[ii].addPoints(poly);
+        }
+        if (objMbrs[ii].valid())
+        {
+            cache.gridMbr.expand(objMbrs[ii]);
+        }
+    }
+
+    // A few objects per cell on average
+    const int numCells = std::max(1,std::min(64,(int)std::sqrt(cache.objs.size() / 4.0)));
+    cache.gridSizeX = cache.gridSizeY = numCells;
+    cache.grid.clear();
+    cache.grid.resize(numCells * numCells);
+    if (!cache.gridMbr.valid())
+    {
+        return;
+    }
+    cache.cellSize = Point2f(std::max(cache.gridMbr.span().x() / numCells, 1.0f),
+                             std::max(cache.gridMbr.span().y() / numCells, 1.0f));
+
+    for (unsigned int ii=0;ii<cache.objs.size();ii++)
+    {
+        const Mbr &objMbr = objMbrs[ii];
+        if (!objMbr.valid())
+        {
+            continue;
+        }
+        const int sx = std::min(numCells-1,(int)((objMbr.ll().x() - cache.gridMbr.ll().x()) / cache.cellSize.x()));
+        const int sy = std::min(numCells-1,(int)((objMbr.ll().y() - cache.gridMbr.ll().y()) / cache.cellSize.y()));
+        const int ex = std::min(numCells-1,(int)((objMbr.ur().x() - cache.gridMbr.ll().x()) / cache.cellSize.x()));
+        const int ey = std::min(numCells-1,(int)((objMbr.ur().y() - cache.gridMbr.ll().y()) / cache.cellSize.y()));
+        for (int iy=sy;iy<=ey;iy++)
+        {
+            for (int ix=sx;ix<=ex;ix++)
+            {
+                cache.grid[iy*numCells + ix].push_back((int)ii);
+            }
+        }
+    }
+}
+
+void SelectionManager::findScreenObjects(const Mbr &searchMbr,std::vector<int> &which) const
+{
+    const auto &cache = screenObjCache;
+    if (cache.grid.empty() || !cache.gridMbr.valid())
+    {
+        return;
+    }
+
+    // Everything is inside the grid bounds, so if we're not near them there's nothing to find
+    if (!ScreenMbrsOverlap(cache.gridMbr,searchMbr))
+    {
+        return;
+    }
+
+    const int numX = cache.gridSizeX, numY = cache.gridSizeY;
+    const auto cellX = [&](float x) { return std::max(0,std::min(numX-1,(int)std::floor((x - cache.gridMbr.ll().x()) / cache.cellSize.x()))); };
+    const auto cellY = [&](float y) { return std::max(0,std::min(numY-1,(int)std::floor((y - cache.gridMbr.ll().y()) / cache.cellSize.y()))); };
+    const int sx = cellX(searchMbr.ll().x()), ex = cellX(searchMbr.ur().x());
+    const int sy = cellY(searchMbr.ll().y()), ey = cellY(searchMbr.ur().y());
+    for (int iy=sy;iy<=ey;iy++)
+    {
+        for (int ix=sx;ix<=ex;ix++)
+        {
+            const auto &cell = cache.grid[iy*numX + ix];
+            which.insert(which.end(),cell.begin(),cell.end());
+        }
+    }
+
+    // Objects can be in more than one cell, and we want them in the original order
+    std::sort(which.begin(),which.end());
+    which.erase(std::unique(which.begin(),which.end()),which.end());
+}
+
 // Sorter for selected objects
 static const struct SelectedSorter_t
 {
@@ -908,6 +1377,62 @@ Matrix2d SelectionManager::calcScreenRot(float &screenRot,const ViewStateRef &vi
     return Matrix2d(Eigen::Rotation2Dd(screenRot));
 }
 
+SelectionManager::PickContext::PickContext(const ViewStateRef &viewState,SceneRenderer *renderer,TimeInterval now) :
+    pInfo(viewState,renderer),
+    now(now),
+    frameBufferSize(renderer->getFramebufferSize())
+{
+    if (!isValid())
+    {
+        return;
+    }
+
+    // And the eye vector for billboards
+    const Vector4d eyeVec4 = pInfo.viewState->fullMatrices[0].inverse() * Vector4d(0,0,1,0);
+    eyeVec = Vector3d(eyeVec4.x(),eyeVec4.y(),eyeVec4.z());
+    modelTrans = pInfo.viewState->fullMatrices[0];
+    normalMat = pInfo.viewState->fullMatrices[0].inverse().transpose();
+
+    eyePos = pInfo.globeViewState ? pInfo.globeViewState->eyePos : pInfo.mapViewState->eyePos;
+}
+
+void SelectionManager::setupPick(PickContext &ctx)
+{
+    const auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager);
+    const int layoutGeneration = layoutManager ? layoutManager->getScreenSpaceGeneration() : 0;
+
+    // Figure out where the screen space objects are, both layout manager
+    //  controlled and other.  The ones that don't move only change with the view.
+    updateScreenObjectCache(ctx.pInfo,ctx.modelTrans,ctx.normalMat,ctx.frameBufferSize,layoutGeneration);
+
+    ctx.movingObjs.clear();
+    getMovingScreenSpaceObjects(ctx.pInfo,ctx.movingObjs,ctx.now);
+    ctx.movingPolys.clear();
+    ctx.movingPolys.resize(ctx.movingObjs.size());
+    for (unsigned int ii=0;ii<ctx.movingObjs.size();ii++)
+    {
+        calcScreenPolys(ctx.movingObjs[ii],ctx.pInfo,ctx.modelTrans,ctx.normalMat,ctx.frameBufferSize,ctx.movingPolys[ii]);
+    }
+}
+
+void SelectionManager::addScreenObjSelected(const ScreenSpaceObjectLocation &screenObj,double screenDist,
+                                            std::vector<SelectedObject> &selObjs) const
+{
+    const auto coordAdapter = scene->getCoordAdapter();
+    const auto coordSys = coordAdapter->getCoordSystem();
+    const auto center = coordSys->localToGeographic(coordAdapter->displayToLocal(screenObj.dispLoc));
+
+    for (SimpleIdentity shapeID : screenObj.shapeIDs)
+    {
+        selObjs.emplace_back(shapeID,0.0,screenDist);
+        auto &selObj = selObjs.back();
+        selObj.isCluster = screenObj.isCluster();
+        selObj.center = center;
+        selObj.clusterId = screenObj.clusterId;
+        selObj.clusterGroup = screenObj.clusterGroup;
+    }
+}
+
 /// Pass in the screen point where the user touched.  This returns the closest hit within the given distance
 void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const ViewStateRef &viewState,
                                    bool multi,std::vector<SelectedObject> &selObjs)
@@ -916,131 +1441,160 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
         return;
 
     // All the various parameters we need to evaluate... stuff
-    PlacementInfo pInfo(viewState,renderer);
-    if (!pInfo.globeViewState && !pInfo.mapViewState)
+    PickContext ctx(viewState,renderer,scene->getCurrentTime());
+    if (!ctx.isValid())
         return;
-    
-    const TimeInterval now = scene->getCurrentTime();
-    const double maxDist2 = maxDist * maxDist;
 
-    // And the eye vector for billboards
-    const Vector4d eyeVec4 = pInfo.viewState->fullMatrices[0].inverse() * Vector4d(0,0,1,0);
-    const Vector3d eyeVec(eyeVec4.x(),eyeVec4.y(),eyeVec4.z());
-    const Matrix4d modelTrans = pInfo.viewState->fullMatrices[0];
-    const Matrix4d normalMat = pInfo.viewState->fullMatrices[0].inverse().transpose();
+    std::lock_guard<std::mutex> guardLock(lock);
 
-    const Point2f frameBufferSize = renderer->getFramebufferSize();
+    setupPick(ctx);
+    pickObjects(ctx,touchPt,maxDist,multi,selObjs);
+}
 
-    const auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager);
+void SelectionManager::pickObjects(const Point2fVector &touchPts,float maxDist,const ViewStateRef &viewState,
+                                   std::vector<std::vector<SelectedObject>> &selObjs)
+{
+    selObjs.clear();
+    selObjs.resize(touchPts.size());
+    if (!renderer || touchPts.empty())
+        return;
 
-    std::lock_guard<std::mutex> guardLock(lock);
+    PickContext ctx(viewState,renderer,scene->getCurrentTime());
+    if (!ctx.isValid())
+        return;
 
-    // Figure out where the screen space objects are, both layout manager
-    //  controlled and other
-    std::vector<ScreenSpaceObjectLocation> ssObjs;
-    getScreenSpaceObjects(pInfo,ssObjs,now);
-    if (layoutManager)
-        layoutManager->getScreenSpaceObjects(pInfo,ssObjs);
-    
-    // Work through the 2D rectangles
-    for (const auto &screenObj : ssObjs)
     {
-        Point2dVector projPts;
-        projectWorldPointToScreen(screenObj.dispLoc, pInfo, projPts, renderer->getScale());
-        
+        std::lock_guard<std::mutex> guardLock(lock);
+
+        setupPick(ctx);
+        for (unsigned int ii=0;ii<touchPts.size();ii++)
+        {
+            pickObjects(ctx,touchPts[ii],maxDist,true,selObjs[ii]);
+        }
+    }
+
+    for (auto &pointObjs : selObjs)
+    {
+        std::sort(pointObjs.begin(),pointObjs.end(),selectedSorter);
+    }
+}
+
+void SelectionManager::pickObjectsInRegion(const Mbr &region,const ViewStateRef &viewState,
+                                           std::vector<SelectedObject> &selObjs)
+{
+    const Point2fVector pts = {
+        region.ll(),
+        Point2f(region.ur().x(),region.ll().y()),
+        region.ur(),
+        Point2f(region.ll().x(),region.ur().y())
+    };
+    pickObjectsInRegion(pts,viewState,selObjs);
+}
+
+void SelectionManager::pickObjectsInRegion(const Point2fVector &region,const ViewStateRef &viewState,
+                                           std::vector<SelectedObject> &selObjs)
+{
+    if (!renderer || region.size() < 3)
+        return;
+
+    PickContext ctx(viewState,renderer,scene->getCurrentTime());
+    if (!ctx.isValid())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+
+        setupPick(ctx);
+        pickObjectsInRegion(ctx,region,selObjs);
+    }
+
+    std::sort(selObjs.begin(),selObjs.end(),selectedSorter);
+}
+
+void SelectionManager::pickObjects(const PickContext &ctx,const Point2f &touchPt,float maxDist,
+                                   bool multi,std::vector<SelectedObject> &selObjs)
+{
+    const PlacementInfo &pInfo = ctx.pInfo;
+    const TimeInterval now = ctx.now;
+    const double maxDist2 = maxDist * maxDist;
+    const Vector3d &eyeVec = ctx.eyeVec;
+    const Point3d &eyePos = ctx.eyePos;
+
+    // Only look at things whose bounds come near the touch point
+    const float searchDist = maxDist + SelectionSlop;
+    const Mbr searchMbr(touchPt - Point2f(searchDist,searchDist),touchPt + Point2f(searchDist,searchDist));
+
+    std::vector<int> cachedObjs;
+    findScreenObjects(searchMbr,cachedObjs);
+
+    const auto checkScreenObj = [&](const ScreenSpaceObjectLocation &screenObj,const std::vector<Point2fVector> &polys)
+    {
         double closeDist2 = std::numeric_limits<double>::max();
-        // Work through the possible locations of the projected point
-        for (const auto &projPt : projPts)
+        for (const auto &screenPts : polys)
         {
-            Mbr objMbr = screenObj.mbr;
-            objMbr.ll() += Point2f(projPt.x(),projPt.y());
-            objMbr.ur() += Point2f(projPt.x(),projPt.y());
-            
-            // Make sure it's on the screen at least
-            if (!pInfo.frameMbr.overlaps(objMbr))
+            // See if we fall within that polygon
+            if (PointInPolygon(touchPt, screenPts))
             {
-                continue;
+                // Distance is zero since we're inside, but maybe distance from the center would be more useful...
+                closeDist2 = 0.0;
+                break;
             }
             
-            if (!screenObj.shapeIDs.empty())
+            // Now for a proximity check around the edges
+            for (unsigned int kk=0; kk < screenObj.pts.size(); kk++)
             {
-                Matrix2d screenRotMat;
-                float screenRot = 0.0;
-                Point2f objPt = projPt.cast<float>();
-                if (screenObj.rotation != 0.0)
-                {
-                    screenRotMat = calcScreenRot(screenRot,pInfo.viewState,pInfo.globeViewState,&screenObj,objPt,modelTrans,normalMat,frameBufferSize);
-                }
-
-                Point2fVector screenPts;
-                if (screenRot == 0.0)
-                {
-                    for (unsigned int kk=0;kk<screenObj.pts.size();kk++)
-                    {
-                        const Point2d &screenObjPt = screenObj.pts[kk];
-                        Point2d theScreenPt = Point2d(screenObjPt.x(),-screenObjPt.y()) + projPt + Point2d(screenObj.offset.x(),-screenObj.offset.y());
-                        screenPts.emplace_back(theScreenPt.x(),theScreenPt.y());
-                    }
-                }
-                else
-                {
-                    for (unsigned int kk=0;kk<screenObj.pts.size();kk++)
-                    {
-                        const Point2d screenObjPt = screenRotMat * (screenObj.pts[kk] + Point2d(screenObj.offset.x(),screenObj.offset.y()));
-                        Point2d theScreenPt = Point2d(screenObjPt.x(),-screenObjPt.y()) + projPt;
-                        screenPts.emplace_back(theScreenPt.x(),theScreenPt.y());
-                    }
-                }
-                
-                // See if we fall within that polygon
-                if (PointInPolygon(touchPt, screenPts))
-                {
-                    // Distance is zero since we're inside, but maybe distance from the center would be more useful...
-                    closeDist2 = 0.0;
-                    break;
-                }
-                
-                // Now for a proximity check around the edges
-                for (unsigned int kk=0; kk < screenObj.pts.size(); kk++)
-                {
-                    float t;
-                    const Point2f closePt = ClosestPointOnLineSegment(screenPts[kk], screenPts[(kk + 1) % 4], touchPt, t);
-                    const double dist2 = (closePt-touchPt).squaredNorm();
-                    closeDist2 = std::min(dist2,closeDist2);
-                }
+                float t;
+                const Point2f closePt = ClosestPointOnLineSegment(screenPts[kk], screenPts[(kk + 1) % 4], touchPt, t);
+                const double dist2 = (closePt-touchPt).squaredNorm();
+                closeDist2 = std::min(dist2,closeDist2);
             }
         }
         // Got close enough to this object to select it
         if (closeDist2 < maxDist2)
         {
-            const auto coordAdapter = scene->getCoordAdapter();
-            const auto coordSys = coordAdapter->getCoordSystem();
-            const auto center = coordSys->localToGeographic(coordAdapter->displayToLocal(screenObj.dispLoc));
-
-            for (SimpleIdentity shapeID : screenObj.shapeIDs)
-            {
-                selObjs.emplace_back(shapeID,0.0,std::sqrt(closeDist2));
-                auto &selObj = selObjs.back();
-                selObj.isCluster = screenObj.isCluster();
-                selObj.center = center;
-                selObj.clusterId = screenObj.clusterId;
-                selObj.clusterGroup = screenObj.clusterGroup;
-            }
+            addScreenObjSelected(screenObj,std::sqrt(closeDist2),selObjs);
         }
         
-        if (!multi && !selObjs.empty())
+        return !multi && !selObjs.empty();
+    };
+
+    // Work through the 2D rectangles, in the same order we always have: ours, the moving ones, then the layout manager's
+    auto cachedIt = cachedObjs.begin();
+    for (;cachedIt != cachedObjs.end() && *cachedIt < screenObjCache.numRectObjs;++cachedIt)
+    {
+        if (checkScreenObj(screenObjCache.objs[*cachedIt],screenObjCache.polys[*cachedIt]))
+        {
+            return;
+        }
+    }
+    for (unsigned int ii=0;ii<ctx.movingObjs.size();ii++)
+    {
+        if (checkScreenObj(ctx.movingObjs[ii],ctx.movingPolys[ii]))
+        {
+            return;
+        }
+    }
+    for (;cachedIt != cachedObjs.end();++cachedIt)
+    {
+        if (checkScreenObj(screenObjCache.objs[*cachedIt],screenObjCache.polys[*cachedIt]))
         {
             return;
         }
     }
 
-    const Point3d eyePos = pInfo.globeViewState ? pInfo.globeViewState->eyePos : pInfo.mapViewState->eyePos;
+    std::vector<SimpleIdentity> candidates;
 
     if (!polytopeSelectables.empty())
     {
+        FindPolytopeCandidates(polytopeTree,pInfo,searchMbr,candidates);
+
         // Work through the axis aligned rectangular solids
-        for (const auto &sel : polytopeSelectables)
+        for (const SimpleIdentity selectID : candidates)
         {
+            const auto it = polytopeSelectables.find(PolytopeSelectable(selectID));
+            if (it == polytopeSelectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -1148,8 +1702,14 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
     
     if (!linearSelectables.empty())
     {
-        for (const auto &sel : linearSelectables)
+        FindLinearCandidates(linearTree,pInfo,renderer->getScale(),searchMbr,candidates);
+
+        for (const SimpleIdentity selectID : candidates)
         {
+            const auto it = linearSelectables.find(LinearSelectable(selectID));
+            if (it == linearSelectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -1197,9 +1757,15 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
     
     if (!rect3Dselectables.empty())
     {
+        FindRect3DCandidates(rect3DTree,pInfo,searchMbr,candidates);
+
         // Work through the 3D rectangles
-        for (const auto &sel : rect3Dselectables)
+        for (const SimpleIdentity selectID : candidates)
         {
+            const auto it = rect3Dselectables.find(RectSelectable3D(selectID));
+            if (it == rect3Dselectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -1315,3 +1881,183 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
     
 //    NSLog(@"Found %d selected objects",selObjs.size());    
 }
+
+void SelectionManager::pickObjectsInRegion(const PickContext &ctx,const Point2fVector &region,
+                                           std::vector<SelectedObject> &selObjs)
+{
+    const PlacementInfo &pInfo = ctx.pInfo;
+    const Point3d &eyePos = ctx.eyePos;
+
+    Mbr searchMbr;
+    searchMbr.addPoints(region);
+    searchMbr.ll() -= Point2f(SelectionSlop,SelectionSlop);
+    searchMbr.ur() += Point2f(SelectionSlop,SelectionSlop);
+
+    const auto isVisible = [&](const Selectable &sel)
+    {
+        return sel.selectID != EmptyIdentity && sel.enable &&
+               (sel.minVis == DrawVisibleInvalid ||
+                (sel.minVis < pInfo.heightAboveSurface && pInfo.heightAboveSurface < sel.maxVis));
+    };
+    const auto polysOverlap = [&](const std::vector<Point2fVector> &polys)
+    {
+        return std::any_of(polys.begin(),polys.end(),[&](const Point2fVector &poly) { return PolygonOverlapsRegion(poly,region); });
+    };
+
+    // Screen space objects, in the same order as a point pick
+    std::vector<int> cachedObjs;
+    findScreenObjects(searchMbr,cachedObjs);
+    auto cachedIt = cachedObjs.begin();
+    for (;cachedIt != cachedObjs.end() && *cachedIt < screenObjCache.numRectObjs;++cachedIt)
+    {
+        if (polysOverlap(screenObjCache.polys[*cachedIt]))
+        {
+            addScreenObjSelected(screenObjCache.objs[*cachedIt],0.0,selObjs);
+        }
+    }
+    for (unsigned int ii=0;ii<ctx.movingObjs.size();ii++)
+    {
+        if (polysOverlap(ctx.movingPolys[ii]))
+        {
+            addScreenObjSelected(ctx.movingObjs[ii],0.0,selObjs);
+        }
+    }
+    for (;cachedIt != cachedObjs.end();++cachedIt)
+    {
+        if (polysOverlap(screenObjCache.polys[*cachedIt]))
+        {
+            addScreenObjSelected(screenObjCache.objs[*cachedIt],0.0,selObjs);
+        }
+    }
+
+    // Project a polytope at its current center and see if any side lands in the region
+    const auto polytopeOverlaps = [&](const PolytopeSelectable &sel,const Point3d &centerPt)
+    {
+        for (const auto &poly3f : sel.polys)
+        {
+            Point3dVector poly;
+            poly.reserve(poly3f.size());
+            for (const auto &pt : poly3f)
+            {
+                poly.push_back(pt.cast<double>() + centerPt);
+            }
+
+            Point2fVector screenPts;
+            ClipAndProjectPolygon(pInfo.viewState->fullMatrices[0],pInfo.viewState->projMatrix,pInfo.frameSizeScale,poly,screenPts);
+            if (screenPts.size() > 2 && PolygonOverlapsRegion(screenPts,region))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<SimpleIdentity> candidates;
+    if (!polytopeSelectables.empty())
+    {
+        FindPolytopeCandidates(polytopeTree,pInfo,searchMbr,candidates);
+        for (const SimpleIdentity selectID : candidates)
+        {
+            const auto it = polytopeSelectables.find(PolytopeSelectable(selectID));
+            if (it != polytopeSelectables.end() && isVisible(*it) && polytopeOverlaps(*it,it->centerPt))
+            {
+                selObjs.emplace_back(selectID,(it->centerPt - eyePos).norm(),0.0);
+            }
+        }
+    }
+
+    for (const auto &sel : movingPolytopeSelectables)
+    {
+        if (isVisible(sel))
+        {
+            const double t = (ctx.now-sel.startTime)/sel.duration;
+            const Point3d centerPt = (sel.endCenterPt - sel.centerPt)*t + sel.centerPt;
+            if (polytopeOverlaps(sel,centerPt))
+            {
+                selObjs.emplace_back(sel.selectID,(centerPt - eyePos).norm(),0.0);
+            }
+        }
+    }
+
+    if (!linearSelectables.empty())
+    {
+        FindLinearCandidates(linearTree,pInfo,renderer->getScale(),searchMbr,candidates);
+        for (const SimpleIdentity selectID : candidates)
+        {
+            const auto it = linearSelectables.find(LinearSelectable(selectID));
+            if (it == linearSelectables.end() || !isVisible(*it))
+                continue;
+            const auto &sel = *it;
+
+            // Same pairing of the projected points as the point pick
+            Point2dVector p0Pts;
+            projectWorldPointToScreen(sel.pts[0],pInfo,p0Pts,renderer->getScale());
+            bool found = false;
+            for (unsigned int ip=1;ip<sel.pts.size() && !found;ip++)
+            {
+                Point2dVector p1Pts;
+                projectWorldPointToScreen(sel.pts[ip],pInfo,p1Pts,renderer->getScale());
+                if (p0Pts.size() == p1Pts.size())
+                {
+                    for (unsigned int iw=0;iw<p0Pts.size();iw++)
+                    {
+                        if (SegmentOverlapsRegion(p0Pts[iw].cast<float>(),p1Pts[iw].cast<float>(),region))
+                        {
+                            const Point3d midPt = (sel.pts[ip-1] + sel.pts[ip]) / 2.0;
+                            selObjs.emplace_back(selectID,(midPt - eyePos).norm(),0.0);
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                p0Pts = p1Pts;
+            }
+        }
+    }
+
+    if (!rect3Dselectables.empty())
+    {
+        FindRect3DCandidates(rect3DTree,pInfo,searchMbr,candidates);
+        for (const SimpleIdentity selectID : candidates)
+        {
+            const auto it = rect3Dselectables.find(RectSelectable3D(selectID));
+            if (it == rect3Dselectables.end() || !isVisible(*it))
+                continue;
+            const auto &sel = *it;
+
+            Point2fVector screenPts;
+            Point3d midPt(0,0,0);
+            for (const auto &pt : sel.pts)
+            {
+                const Point3d pt3d = pt.cast<double>();
+                screenPts.push_back(pInfo.viewState->pointOnScreenFromDisplay(pt3d, &pInfo.viewState->fullMatrices[0], pInfo.frameSizeScale));
+                midPt += pt3d;
+            }
+            if (PolygonOverlapsRegion(screenPts,region))
+            {
+                selObjs.emplace_back(selectID,(midPt / 4.0 - eyePos).norm(),0.0);
+            }
+        }
+    }
+
+    for (const auto &sel : billboardSelectables)
+    {
+        if (sel.selectID == EmptyIdentity || !sel.enable)
+            continue;
+
+        // Same rectangle facing the eye as the point pick
+        Point3dVector poly(4);
+        const Point3d axisX = ctx.eyeVec.cross(sel.normal);
+        poly[0] = -sel.size.x()/2.0 * axisX + sel.center;
+        poly[3] = sel.size.x()/2.0 * axisX + sel.center;
+        poly[2] = -sel.size.x()/2.0 * axisX + sel.size.y() * sel.normal + sel.center;
+        poly[1] = sel.size.x()/2.0 * axisX + sel.size.y() * sel.normal + sel.center;
+
+        Point2fVector screenPts;
+        ClipAndProjectPolygon(pInfo.viewState->fullMatrices[0],pInfo.viewState->projMatrix,pInfo.frameSizeScale,poly,screenPts);
+        if (screenPts.size() > 2 && PolygonOverlapsRegion(screenPts,region))
+        {
+            selObjs.emplace_back(sel.selectID,(sel.center - eyePos).norm(),0.0);
+        }
+    }
+}
@@ -69,13 +69,14 @@ void ShapeDrawableBuilder::addPoints(Point3dVector &pts,RGBAColor color,Mbr mbr,
     // Decide if we'll appending to an existing drawable or
     //  create a new one
     int ptCount = (int)(2*(pts.size()+1));
-    if (!drawable || (drawable->getNumPoints()+ptCount > MaxDrawablePoints) || (drawable->getLineWidth() != lineWidth))
+    if (!drawable || (drawable->getNumPoints()+ptCount > drawable->getMaxPoints()) || (drawable->getLineWidth() != lineWidth))
     {
         // We're done with it, toss it to the scene
         if (drawable)
             flush();
 
         drawable = sceneRender->makeBasicDrawableBuilder("Shape Manager");
+        drawable->setIndexPolicy(DrawableIndexAuto);
         shapeInfo.setupBasicDrawable(drawable);
         drawMbr.reset();
         drawable->setType(primType);
@@ -177,6 +178,7 @@ ShapeDrawableBuilderTri::ShapeDrawableBuilderTri(WhirlyKit::CoordSystemDisplayAd
 void ShapeDrawableBuilderTri::setupNewDrawable()
 {
     drawable = sceneRender->makeBasicDrawableBuilder("Shape Layer");
+    drawable->setIndexPolicy(DrawableIndexAuto);
     shapeInfo.setupBasicDrawable(drawable);
     if (clipCoords)
         drawable->setClipCoords(true);
@@ -196,6 +198,26 @@ void ShapeDrawableBuilderTri::setupNewDrawable()
         Matrix4d transMat = trans.matrix();
         drawable->setMatrix(&transMat);
     }
+
+    // Vertices go straight into an interleaved buffer, with texture coordinates if we're textured
+    if (texIDs.empty())
+    {
+        verts = std::make_unique<InterleavedVertexBuilder<Point3f,RGBAColor>>(drawable.get(),
+                        std::array<StringIdentity,2> { a_normalNameID, a_colorNameID });
+    }
+    else
+    {
+        const StringIdentity texCoordNameID = StringIndexer::getStringID("a_texCoord0");
+        texVerts = std::make_unique<InterleavedVertexBuilder<Point3f,RGBAColor,TexCoord>>(drawable.get(),
+                        std::array<StringIdentity,3> { a_normalNameID, a_colorNameID, texCoordNameID });
+    }
+}
+
+unsigned int ShapeDrawableBuilderTri::addVertex(const Point3f &pt,const Point3f &norm,RGBAColor color,const TexCoord &texCoord)
+{
+    if (texVerts)
+        return texVerts->addVertex(pt,norm,color,texCoord);
+    return verts->addVertex(pt,norm,color);
 }
 
 void ShapeDrawableBuilderTri::setClipCoords(bool newClipCoords)
@@ -227,8 +249,8 @@ void ShapeDrawableBuilderTri::addTriangle(Point3f p0,Point3f n0,RGBAColor c0,Poi
     Point3f center3f(center.x(),center.y(),center.z());
 
     if (!drawable ||
-        (drawable->getNumPoints()+3 > MaxDrawablePoints) ||
-        (drawable->getNumTris()+1 > MaxDrawableTriangles))
+        (drawable->getNumPoints()+3 > drawable->getMaxPoints()) ||
+        (drawable->getNumTris()+1 > drawable->getMaxTriangles()))
     {
         // We're done with it, toss it to the scene
         if (drawable)
@@ -240,15 +262,9 @@ void ShapeDrawableBuilderTri::addTriangle(Point3f p0,Point3f n0,RGBAColor c0,Poi
     mbr.expand(shapeMbr);
     drawable->setLocalMbr(mbr);
     int baseVert = drawable->getNumPoints();
-    drawable->addPoint((Point3f)(p0-center3f));
-    drawable->addNormal(n0);
-    drawable->addColor(c0);
-    drawable->addPoint((Point3f)(p1-center3f));
-    drawable->addNormal(n1);
-    drawable->addColor(c1);
-    drawable->addPoint((Point3f)(p2-center3f));
-    drawable->addNormal(n2);
-    drawable->addColor(c2);
+    addVertex(p0-center3f,n0,c0);
+    addVertex(p1-center3f,n1,c1);
+    addVertex(p2-center3f,n2,c2);
 
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
@@ -258,8 +274,8 @@ void ShapeDrawableBuilderTri::addTriangle(Point3f p0,Point3f n0,RGBAColor c0,Poi
 void ShapeDrawableBuilderTri::addTriangle(const Point3d &p0,const Point3d &n0,RGBAColor c0,const TexCoord &tx0,const Point3d &p1,const Point3d &n1,RGBAColor c1,const TexCoord &tx1,const Point3d &p2,const Point3d &n2,RGBAColor c2,const TexCoord &tx2,Mbr shapeMbr)
 {
     if (!drawable ||
-        (drawable->getNumPoints()+3 > MaxDrawablePoints) ||
-        (drawable->getNumTris()+1 > MaxDrawableTriangles))
+        (drawable->getNumPoints()+3 > drawable->getMaxPoints()) ||
+        (drawable->getNumTris()+1 > drawable->getMaxTriangles()))
     {
         // We're done with it, toss it to the scene
         if (drawable)
@@ -271,18 +287,9 @@ void ShapeDrawableBuilderTri::addTriangle(const Point3d &p0,const Point3d &n0,RG
     mbr.expand(shapeMbr);
     drawable->setLocalMbr(mbr);
     int baseVert = drawable->getNumPoints();
-    drawable->addPoint((Point3d)(p0-center));
-    drawable->addNormal(n0);
-    drawable->addColor(c0);
-    drawable->addTexCoord(0,tx0);
-    drawable->addPoint((Point3d)(p1-center));
-    drawable->addNormal(n1);
-    drawable->addColor(c1);
-    drawable->addTexCoord(0,tx1);
-    drawable->addPoint((Point3d)(p2-center));
-    drawable->addNormal(n2);
-    drawable->addColor(c2);
-    drawable->addTexCoord(0,tx2);
+    addVertex((p0-center).cast<float>(),n0.cast<float>(),c0,tx0);
+    addVertex((p1-center).cast<float>(),n1.cast<float>(),c1,tx1);
+    addVertex((p2-center).cast<float>(),n2.cast<float>(),c2,tx2);
     
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
@@ -292,8 +299,8 @@ void ShapeDrawableBuilderTri::addTriangle(const Point3d &p0,const Point3d &n0,RG
 void ShapeDrawableBuilderTri::addTriangle(Point3d p0,Point3d n0,RGBAColor c0,Point3d p1,Point3d n1,RGBAColor c1,Point3d p2,Point3d n2,RGBAColor c2,Mbr shapeMbr)
 {
     if (!drawable ||
-        (drawable->getNumPoints()+3 > MaxDrawablePoints) ||
-        (drawable->getNumTris()+1 > MaxDrawableTriangles))
+        (drawable->getNumPoints()+3 > drawable->getMaxPoints()) ||
+        (drawable->getNumTris()+1 > drawable->getMaxTriangles()))
     {
         // We're done with it, toss it to the scene
         if (drawable)
@@ -305,15 +312,9 @@ void ShapeDrawableBuilderTri::addTriangle(Point3d p0,Point3d n0,RGBAColor c0,Poi
     mbr.expand(shapeMbr);
     drawable->setLocalMbr(mbr);
     int baseVert = drawable->getNumPoints();
-    drawable->addPoint((Point3d)(p0-center));
-    drawable->addNormal(n0);
-    drawable->addColor(c0);
-    drawable->addPoint((Point3d)(p1-center));
-    drawable->addNormal(n1);
-    drawable->addColor(c1);
-    drawable->addPoint((Point3d)(p2-center));
-    drawable->addNormal(n2);
-    drawable->addColor(c2);
+    addVertex((p0-center).cast<float>(),n0.cast<float>(),c0);
+    addVertex((p1-center).cast<float>(),n1.cast<float>(),c1);
+    addVertex((p2-center).cast<float>(),n2.cast<float>(),c2);
 
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
@@ -323,8 +324,8 @@ void ShapeDrawableBuilderTri::addTriangle(Point3d p0,Point3d n0,RGBAColor c0,Poi
 void ShapeDrawableBuilderTri::addTriangles(Point3dVector &pts,Point3dVector &norms,std::vector<RGBAColor> &colors,std::vector<BasicDrawable::Triangle> &tris)
 {
     if (!drawable ||
-        (drawable->getNumPoints()+pts.size() > MaxDrawablePoints) ||
-        (drawable->getNumTris()+tris.size() > MaxDrawableTriangles))
+        (drawable->getNumPoints()+pts.size() > drawable->getMaxPoints()) ||
+        (drawable->getNumTris()+tris.size() > drawable->getMaxTriangles()))
     {
         if (drawable)
             flush();
@@ -335,11 +336,8 @@ void ShapeDrawableBuilderTri::addTriangles(Point3dVector &pts,Point3dVector &nor
     int baseVert = drawable->getNumPoints();
     for (unsigned int ii=0;ii<pts.size();ii++)
     {
-        const Point3d &pt = pts[ii];
-        drawable->addPoint(Point3d(pt.x()-center.x(),pt.y()-center.y(),pt.z()-center.z()));
-        drawable->addNormal(norms[ii]);
-        drawable->addColor(colors[ii]);
-	}
+        addVertex((pts[ii]-center).cast<float>(),norms[ii].cast<float>(),colors[ii]);
+    }
     for (unsigned int ii=0;ii<tris.size();ii++)
     {
         BasicDrawable::Triangle tri = tris[ii];
@@ -415,6 +413,8 @@ void ShapeDrawableBuilderTri::flush()
             drawables.push_back(drawable);
         }
         drawable = NULL;
+        verts.reset();
+        texVerts.reset();
     }
 }
 
@@ -0,0 +1,129 @@
+/*  SignedDistanceField.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "SignedDistanceField.h"
+#import <algorithm>
+#import <cmath>
+
+namespace WhirlyKit
+{
+
+static constexpr float SDFInfinity = 1e20f;
+
+// Felzenszwalb & Huttenlocher squared distance transform of one row or column, in place.
+// f is read and written every stride entries.  v and z are scratch space.
+static void DistanceTransform1D(float *grid,int offset,int stride,int length,
+                                std::vector<float> &f,std::vector<int> &v,std::vector<float> &z)
+{
+    for (int ii=0;ii<length;ii++)
+        f[ii] = grid[offset + ii * stride];
+
+    // Lower envelope of the parabolas rooted at each sample
+    int k = 0;
+    v[0] = 0;
+    z[0] = -SDFInfinity;
+    z[1] = SDFInfinity;
+    for (int q=1;q<length;q++)
+    {
+        float s;
+        do
+        {
+            const int r = v[k];
+            s = (f[q] - f[r] + (float)(q * q - r * r)) / (float)(2 * (q - r));
+        } while (s <= z[k] && --k >= 0);
+
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = SDFInfinity;
+    }
+
+    // Then read it back off
+    k = 0;
+    for (int q=0;q<length;q++)
+    {
+        while (z[k+1] < q)
+            k++;
+        const int r = v[k];
+        grid[offset + q * stride] = f[r] + (float)((q - r) * (q - r));
+    }
+}
+
+static void DistanceTransform2D(std::vector<float> &grid,int width,int height)
+{
+    const int maxDim = std::max(width,height);
+    std::vector<float> f(maxDim);
+    std::vector<int> v(maxDim);
+    std::vector<float> z(maxDim+1);
+
+    for (int x=0;x<width;x++)
+        DistanceTransform1D(&grid[0], x, width, height, f, v, z);
+    for (int y=0;y<height;y++)
+        DistanceTransform1D(&grid[0], y * width, 1, width, f, v, z);
+}
+
+void BuildSignedDistanceField(const unsigned char *coverage,int width,int height,
+                              int pixelStride,int rowStride,float spread,
+                              std::vector<unsigned char> &distField)
+{
+    distField.resize(width * height);
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Squared distances to the nearest pixel outside and inside the shape.
+    // Partly covered pixels count as being part way to the edge, which keeps it smooth.
+    std::vector<float> outer(width * height),inner(width * height);
+    for (int y=0;y<height;y++)
+    {
+        const unsigned char *row = coverage + y * rowStride;
+        for (int x=0;x<width;x++)
+        {
+            const float a = row[x * pixelStride] / 255.0f;
+            const int which = y * width + x;
+            if (a >= 1.0f)
+            {
+                outer[which] = 0.0f;
+                inner[which] = SDFInfinity;
+            }
+            else if (a <= 0.0f)
+            {
+                outer[which] = SDFInfinity;
+                inner[which] = 0.0f;
+            }
+            else
+            {
+                const float toOuter = std::max(0.0f, 0.5f - a);
+                const float toInner = std::max(0.0f, a - 0.5f);
+                outer[which] = toOuter * toOuter;
+                inner[which] = toInner * toInner;
+            }
+        }
+    }
+
+    DistanceTransform2D(outer, width, height);
+    DistanceTransform2D(inner, width, height);
+
+    for (int ii=0;ii<width * height;ii++)
+    {
+        // Positive inside the shape, negative outside
+        const float dist = std::sqrt(inner[ii]) - std::sqrt(outer[ii]);
+        const float val = 0.5f + dist / (2.0f * spread);
+        distField[ii] = (unsigned char)std::round(255.0f * std::min(1.0f, std::max(0.0f, val)));
+    }
+}
+
+}
@@ -16,7 +16,9 @@
  *  limitations under the License.
  */
 
-#import <list>
+#import <algorithm>
+#import <memory>
+#import <cstring>
 #include "glues.h"
 #import "Tesselator.h"
 
@@ -24,81 +26,975 @@ using namespace Eigen;
 
 namespace WhirlyKit
 {
-    
-//static float PolyScale = 1e14;
-    
-typedef struct
+
+// Scratch memory past this gets freed after use rather than kept for the next polygon
+static constexpr size_t MaxScratchKeepSize = 16 * 1024 * 1024;
+
+// Free a scratch vector if a big polygon blew it up past the limit
+template<typename T>
+static void TrimScratch(std::vector<T> &vec)
+{
+    if (vec.capacity() * sizeof(T) > MaxScratchKeepSize)
+    {
+        std::vector<T>().swap(vec);
+    }
+}
+
+/// Bump allocator for libtess.
+/// Nothing is freed individually, it all goes at once when the tesselator is done.
+/// Each thread keeps one around so the memory gets reused from polygon to polygon.
+class TessArena
+{
+public:
+    void *alloc(size_t size)
+    {
+        // Keep the size up front for realloc
+        const size_t total = align(size) + HeaderSize;
+        if (blocks.empty() || blocks[curBlock].size - curOffset < total)
+        {
+            nextBlock(total);
+        }
+
+        uint8_t *ptr = blocks[curBlock].data.get() + curOffset;
+        curOffset += total;
+        *(size_t *)ptr = size;
+        return ptr + HeaderSize;
+    }
+
+    void *realloc(void *ptr,size_t size)
+    {
+        if (!ptr)
+        {
+            return alloc(size);
+        }
+        const size_t oldSize = *(size_t *)((uint8_t *)ptr - HeaderSize);
+        if (size <= oldSize)
+        {
+            return ptr;
+        }
+        void *newPtr = alloc(size);
+        memcpy(newPtr, ptr, oldSize);
+        return newPtr;
+    }
+
+    /// Let go of everything allocated so far
+    void reset()
+    {
+        // If we spilled into more blocks, use one big one next time, within reason
+        size_t total = 0;
+        for (const auto &block : blocks)
+        {
+            total += block.size;
+        }
+        if (total > MaxScratchKeepSize)
+        {
+            blocks.clear();
+        }
+        else if (blocks.size() > 1)
+        {
+            blocks.clear();
+            blocks.emplace_back(total);
+        }
+        curBlock = 0;
+        curOffset = 0;
+    }
+
+protected:
+    static constexpr size_t HeaderSize = 16;
+    static constexpr size_t MinBlockSize = 64 * 1024;
+
+    static size_t align(size_t size) { return (size + 15) & ~(size_t)15; }
+
+    void nextBlock(size_t size)
+    {
+        curOffset = 0;
+        if (!blocks.empty() && curBlock + 1 < blocks.size() && blocks[curBlock + 1].size >= size)
+        {
+            curBlock++;
+            return;
+        }
+        const size_t lastSize = blocks.empty() ? 0 : blocks.back().size;
+        blocks.emplace_back(std::max(std::max(size, lastSize * 2), MinBlockSize));
+        curBlock = blocks.size() - 1;
+    }
+
+    struct Block
+    {
+        explicit Block(size_t size) : data(new uint8_t[size]), size(size) { }
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t curBlock = 0;
+    size_t curOffset = 0;
+};
+
+static void* arenaAlloc(void* userData, unsigned int size)
 {
-    Point3fVector pts;
-    std::vector<std::vector<int>> tris;
-//    std::vector<int> vertIDs;
-    bool newVert;
-} TriangulationInfo;
+    return ((TessArena *)userData)->alloc(size);
+}
 
-static void* stdAlloc(void* userData, unsigned int size)
+static void* arenaRealloc(void* userData, void* ptr, unsigned int size)
 {
-  TESS_NOTUSED(userData);
-  return malloc(size);
+    return ((TessArena *)userData)->realloc(ptr, size);
 }
 
-static void stdFree(void* userData, void* ptr)
+static void arenaFree(void* userData, void* ptr)
 {
-  TESS_NOTUSED(userData);
-  free(ptr);
+    TESS_NOTUSED(userData);
+    TESS_NOTUSED(ptr);
 }
 
+/** Ear clipping triangulation for polygons with holes, along the lines of Mapbox's earcut.
+    Holes are bridged into the outer loop, then ears are cut off, using a z-order
+    curve to find nearby points for bigger polygons.
+    Nodes live in one vector that's kept between runs, so there's no allocation once it's warmed up.
+  */
+class EarClipper
+{
+public:
+    /// Triangulate the given loops, which start at the given offsets in pts.
+    /// Indices into pts come back three to a triangle.
+    void run(const std::vector<Point2d> &pts,const std::vector<int> &loopStarts,std::vector<int> &outIndices)
+    {
+        nodes.clear();
+        holeQueue.clear();
+        indices = &outIndices;
+        hashing = false;
+
+        const int numLoops = (int)loopStarts.size();
+        const int outerEnd = (numLoops > 1) ? loopStarts[1] : (int)pts.size();
+        int outerNode = linkedList(pts, 0, outerEnd, true);
+        if (outerNode < 0 || node(outerNode).prev == node(outerNode).next)
+        {
+            return;
+        }
+
+        if (numLoops > 1)
+        {
+            outerNode = eliminateHoles(pts, loopStarts, outerNode);
+        }
+
+        // The z-order hash only pays off for bigger polygons
+        if (pts.size() > 80)
+        {
+            hashing = true;
+            minX = maxX = pts[0].x();
+            minY = maxY = pts[0].y();
+            for (int ii = 1; ii < outerEnd; ii++)
+            {
+                minX = std::min(minX, pts[ii].x());
+                minY = std::min(minY, pts[ii].y());
+                maxX = std::max(maxX, pts[ii].x());
+                maxY = std::max(maxY, pts[ii].y());
+            }
+            const double size = std::max(maxX - minX, maxY - minY);
+            invSize = (size != 0.0) ? (32767.0 / size) : 0.0;
+        }
+
+        earcutLinked(outerNode, 0);
+    }
+
+    /// Let go of the working space if it's gotten too big
+    void trim()
+    {
+        TrimScratch(nodes);
+        TrimScratch(holeQueue);
+    }
+
+protected:
+    struct Node
+    {
+        int i;
+        double x,y;
+        int prev,next;
+        int32_t z;
+        int prevZ,nextZ;
+        bool steiner;
+    };
+
+    Node &node(int which) { return nodes[which]; }
+
+    int newNode(int i,double x,double y)
+    {
+        nodes.push_back(Node { i, x, y, -1, -1, 0, -1, -1, false });
+        return (int)nodes.size() - 1;
+    }
+
+    // Loop of nodes in the given winding order
+    int linkedList(const std::vector<Point2d> &pts,int start,int end,bool clockwise)
+    {
+        double sum = 0.0;
+        for (int ii = start, jj = end - 1; ii < end; jj = ii++)
+        {
+            sum += (pts[jj].x() - pts[ii].x()) * (pts[ii].y() + pts[jj].y());
+        }
+
+        int last = -1;
+        if (clockwise == (sum > 0.0))
+        {
+            for (int ii = start; ii < end; ii++)
+                last = insertNode(ii, pts[ii], last);
+        }
+        else
+        {
+            for (int ii = end - 1; ii >= start; ii--)
+                last = insertNode(ii, pts[ii], last);
+        }
+
+        if (last >= 0 && equals(last, node(last).next))
+        {
+            const int next = node(last).next;
+            removeNode(last);
+            last = next;
+        }
+
+        return last;
+    }
+
+    // Get rid of duplicate and collinear points
+    int filterPoints(int start,int end = -1)
+    {
+        if (start < 0)
+            return start;
+        if (end < 0)
+            end = start;
+
+        int p = start;
+        bool again;
+        do
+        {
+            again = false;
+            if (!node(p).steiner && (equals(p, node(p).next) || area(node(p).prev, p, node(p).next) == 0.0))
+            {
+                const int prev = node(p).prev;
+                removeNode(p);
+                p = end = prev;
+                if (p == node(p).next)
+                    break;
+                again = true;
+            }
+            else
+            {
+                p = node(p).next;
+            }
+        } while (again || p != end);
+
+        return end;
+    }
+
+    // Main ear slicing loop
+    void earcutLinked(int ear,int pass)
+    {
+        if (ear < 0)
+            return;
+
+        if (!pass && hashing)
+            indexCurve(ear);
+
+        int stop = ear;
+        while (node(ear).prev != node(ear).next)
+        {
+            const int prev = node(ear).prev;
+            const int next = node(ear).next;
+
+            if (hashing ? isEarHashed(ear) : isEar(ear))
+            {
+                indices->push_back(node(prev).i);
+                indices->push_back(node(ear).i);
+                indices->push_back(node(next).i);
+
+                removeNode(ear);
+
+                // Skipping the next vertex leads to fewer sliver triangles
+                ear = node(next).next;
+                stop = node(next).next;
+                continue;
+            }
+
+            ear = next;
+
+            // Went all the way around without finding an ear
+            if (ear == stop)
+            {
+                if (!pass)
+                {
+                    // Try again after filtering points
+                    earcutLinked(filterPoints(ear), 1);
+                }
+                else if (pass == 1)
+                {
+                    // Still stuck, try fixing small self-intersections
+                    ear = cureLocalIntersections(filterPoints(ear));
+                    earcutLinked(ear, 2);
+                }
+                else if (pass == 2)
+                {
+                    // As a last resort, split the polygon in two
+                    splitEarcut(ear);
+                }
+                break;
+            }
+        }
+    }
+
+    bool isEar(int ear)
+    {
+        const Node &a = node(node(ear).prev), &b = node(ear), &c = node(node(ear).next);
+        if (area(a, b, c) >= 0.0)
+            return false;   // Reflex
+
+        // Nothing else can be inside the ear
+        int p = c.next;
+        while (p != b.prev)
+        {
+            const Node &pn = node(p);
+            if (pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, pn.x, pn.y) &&
+                area(pn.prev, p, pn.next) >= 0.0)
+                return false;
+            p = pn.next;
+        }
+
+        return true;
+    }
+
+    bool isEarHashed(int ear)
+    {
+        const int ia = node(ear).prev, ic = node(ear).next;
+        const Node &a = node(ia), &b = node(ear), &c = node(ic);
+        if (area(a, b, c) >= 0.0)
+            return false;   // Reflex
+
+        // Bounding box of the triangle
+        const double minTX = std::min(a.x, std::min(b.x, c.x));
+        const double minTY = std::min(a.y, std::min(b.y, c.y));
+        const double maxTX = std::max(a.x, std::max(b.x, c.x));
+        const double maxTY = std::max(a.y, std::max(b.y, c.y));
+
+        // Only look at the points nearby in z-order
+        const int32_t minZ = zOrder(minTX, minTY);
+        const int32_t maxZ = zOrder(maxTX, maxTY);
+
+        const auto inEar = [&](int which) {
+            const Node &pn = node(which);
+            return which != ia && which != ic &&
+                   pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, pn.x, pn.y) &&
+                   area(pn.prev, which, pn.next) >= 0.0;
+        };
+
+        int p = b.prevZ;
+        int n = b.nextZ;
+        while (p >= 0 && node(p).z >= minZ && n >= 0 && node(n).z <= maxZ)
+        {
+            if (inEar(p))
+                return false;
+            p = node(p).prevZ;
+
+            if (inEar(n))
+                return false;
+            n = node(n).nextZ;
+        }
+        while (p >= 0 && node(p).z >= minZ)
+        {
+            if (inEar(p))
+                return false;
+            p = node(p).prevZ;
+        }
+        while (n >= 0 && node(n).z <= maxZ)
+        {
+            if (inEar(n))
+                return false;
+            n = node(n).nextZ;
+        }
+
+        return true;
+    }
+
+    // Go through the polygon and fix small local self-intersections
+    int cureLocalIntersections(int start)
+    {
+        int p = start;
+        do
+        {
+            const int a = node(p).prev;
+            const int b = node(node(p).next).next;
+
+            if (!equals(a, b) && intersects(a, p, node(p).next, b) && locallyInside(a, b) && locallyInside(b, a))
+            {
+                indices->push_back(node(a).i);
+                indices->push_back(node(p).i);
+                indices->push_back(node(b).i);
+
+                // Remove the two nodes involved
+                removeNode(node(p).next);
+                removeNode(p);
+
+                p = start = b;
+            }
+            p = node(p).next;
+        } while (p != start);
+
+        return filterPoints(p);
+    }
+
+    // Try splitting the polygon into two and triangulate them separately
+    void splitEarcut(int start)
+    {
+        int a = start;
+        do
+        {
+            int b = node(node(a).next).next;
+            while (b != node(a).prev)
+            {
+                if (node(a).i != node(b).i && isValidDiagonal(a, b))
+                {
+                    int c = splitPolygon(a, b);
+
+                    a = filterPoints(a, node(a).next);
+                    c = filterPoints(c, node(c).next);
+
+                    earcutLinked(a, 0);
+                    earcutLinked(c, 0);
+                    return;
+                }
+                b = node(b).next;
+            }
+            a = node(a).next;
+        } while (a != start);
+    }
+
+    // Link the holes into the outer loop one at a time, left to right
+    int eliminateHoles(const std::vector<Point2d> &pts,const std::vector<int> &loopStarts,int outerNode)
+    {
+        const int numLoops = (int)loopStarts.size();
+        for (int li = 1; li < numLoops; li++)
+        {
+            const int end = (li + 1 < numLoops) ? loopStarts[li + 1] : (int)pts.size();
+            const int list = linkedList(pts, loopStarts[li], end, false);
+            if (list >= 0)
+            {
+                if (list == node(list).next)
+                    node(list).steiner = true;
+                holeQueue.push_back(getLeftmost(list));
+            }
+        }
+
+        std::sort(holeQueue.begin(), holeQueue.end(), [this](int a,int b) {
+            return nodes[a].x < nodes[b].x;
+        });
+
+        for (int hole : holeQueue)
+        {
+            outerNode = eliminateHole(hole, outerNode);
+        }
+
+        return outerNode;
+    }
+
+    // Find a bridge between the hole and outer loop and link them up
+    int eliminateHole(int hole,int outerNode)
+    {
+        const int bridge = findHoleBridge(hole, outerNode);
+        if (bridge < 0)
+            return outerNode;
+
+        const int bridgeReverse = splitPolygon(bridge, hole);
+
+        // Filter the collinear points around the cuts
+        filterPoints(bridgeReverse, node(bridgeReverse).next);
+        return filterPoints(bridge, node(bridge).next);
+    }
+
+    // David Eberly's algorithm for finding a bridge between a hole and the outer polygon
+    int findHoleBridge(int hole,int outerNode)
+    {
+        int p = outerNode;
+        const double hx = node(hole).x;
+        const double hy = node(hole).y;
+        double qx = -std::numeric_limits<double>::infinity();
+        int m = -1;
+
+        // Find a segment intersected by a ray from the hole's leftmost point to the left.
+        // The segment's endpoint with the lesser x will be a potential connection point.
+        do
+        {
+            const Node &pn = node(p), &nn = node(pn.next);
+            if (hy <= pn.y && hy >= nn.y && nn.y != pn.y)
+            {
+                const double x = pn.x + (hy - pn.y) * (nn.x - pn.x) / (nn.y - pn.y);
+                if (x <= hx && x > qx)
+                {
+                    qx = x;
+                    m = (pn.x < nn.x) ? p : pn.next;
+                    if (x == hx)
+                        return m;   // Hole touches the outer segment, pick the leftmost endpoint
+                }
+            }
+            p = pn.next;
+        } while (p != outerNode);
+
+        if (m < 0)
+            return -1;
+
+        // Look for points inside the triangle of the hole point, the segment intersection and the endpoint.
+        // If there are none, that's the connection.  Otherwise use the one with the minimum angle with the ray.
+        const int stop = m;
+        const double mx = node(m).x;
+        const double my = node(m).y;
+        double tanMin = std::numeric_limits<double>::infinity();
+
+        p = m;
+        do
+        {
+            const Node &pn = node(p);
+            if (hx >= pn.x && pn.x >= mx && hx != pn.x &&
+                pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, pn.x, pn.y))
+            {
+                const double tanCur = std::abs(hy - pn.y) / (hx - pn.x);
+                if (locallyInside(p, hole) &&
+                    (tanCur < tanMin || (tanCur == tanMin && (pn.x > node(m).x || sectorContainsSector(m, p)))))
+                {
+                    m = p;
+                    tanMin = tanCur;
+                }
+            }
+            p = pn.next;
+        } while (p != stop);
+
+        return m;
+    }
+
+    // Whether sector in vertex m contains sector in vertex p in the same coordinates
+    bool sectorContainsSector(int m,int p)
+    {
+        return area(node(m).prev, m, node(p).prev) < 0.0 && area(node(p).next, m, node(m).next) < 0.0;
+    }
+
+    // Interlink polygon nodes in z-order
+    void indexCurve(int start)
+    {
+        int p = start;
+        do
+        {
+            Node &pn = node(p);
+            pn.z = pn.z ? pn.z : zOrder(pn.x, pn.y);
+            pn.prevZ = pn.prev;
+            pn.nextZ = pn.next;
+            p = pn.next;
+        } while (p != start);
+
+        node(node(p).prevZ).nextZ = -1;
+        node(p).prevZ = -1;
+
+        sortLinked(p);
+    }
+
+    // Simon Tatham's linked list merge sort
+    int sortLinked(int list)
+    {
+        int inSize = 1;
+        for (;;)
+        {
+            int p = list;
+            list = -1;
+            int tail = -1;
+            int numMerges = 0;
+
+            while (p >= 0)
+            {
+                numMerges++;
+                int q = p;
+                int pSize = 0;
+                for (int ii = 0; ii < inSize; ii++)
+                {
+                    pSize++;
+                    q = node(q).nextZ;
+                    if (q < 0)
+                        break;
+                }
+
+                int qSize = inSize;
+                while (pSize > 0 || (qSize > 0 && q >= 0))
+                {
+                    int e;
+                    if (pSize == 0)
+                    {
+                        e = q;
+                        q = node(q).nextZ;
+                        qSize--;
+                    }
+                    else if (qSize == 0 || q < 0 || node(p).z <= node(q).z)
+                    {
+                        e = p;
+                        p = node(p).nextZ;
+                        pSize--;
+                    }
+                    else
+                    {
+                        e = q;
+                        q = node(q).nextZ;
+                        qSize--;
+                    }
+
+                    if (tail >= 0)
+                        node(tail).nextZ = e;
+                    else
+                        list = e;
+
+                    node(e).prevZ = tail;
+                    tail = e;
+                }
+
+                p = q;
+            }
+
+            node(tail).nextZ = -1;
+
+            if (numMerges <= 1)
+                return list;
+
+            inSize *= 2;
+        }
+    }
+
+    // Z-order of a point given coords and size of the data bounding box
+    int32_t zOrder(double x,double y) const
+    {
+        // Coords are transformed into non-negative 15-bit integer range
+        auto ix = (int32_t)((x - minX) * invSize);
+        auto iy = (int32_t)((y - minY) * invSize);
+
+        ix = (ix | (ix << 8)) & 0x00FF00FF;
+        ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+        ix = (ix | (ix << 2)) & 0x33333333;
+        ix = (ix | (ix << 1)) & 0x55555555;
+
+        iy = (iy | (iy << 8)) & 0x00FF00FF;
+        iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+        iy = (iy | (iy << 2)) & 0x33333333;
+        iy = (iy | (iy << 1)) & 0x55555555;
+
+        return ix | (iy << 1);
+    }
+
+    // Leftmost node of a polygon ring
+    int getLeftmost(int start)
+    {
+        int p = start;
+        int leftmost = start;
+        do
+        {
+            const Node &pn = node(p), &ln = node(leftmost);
+            if (pn.x < ln.x || (pn.x == ln.x && pn.y < ln.y))
+                leftmost = p;
+            p = pn.next;
+        } while (p != start);
+
+        return leftmost;
+    }
+
+    // Check if a point lies within a convex triangle
+    static bool pointInTriangle(double ax,double ay,double bx,double by,double cx,double cy,double px,double py)
+    {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+               (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+               (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    // Check if a diagonal between two polygon nodes is valid (lies in polygon interior)
+    bool isValidDiagonal(int a,int b)
+    {
+        const Node &an = node(a), &bn = node(b);
+        return node(an.next).i != bn.i && node(an.prev).i != bn.i && !intersectsPolygon(a, b) &&
+               // Locally visible
+               ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+                 // Doesn't make opposite-facing sectors
+                 (area(an.prev, a, bn.prev) != 0.0 || area(a, bn.prev, b) != 0.0)) ||
+                // Special zero-length case
+                (equals(a, b) && area(an.prev, a, an.next) > 0.0 && area(bn.prev, b, bn.next) > 0.0));
+    }
+
+    // Signed area of a triangle
+    static double area(const Node &p,const Node &q,const Node &r)
+    {
+        return (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
+    }
+    double area(int p,int q,int r)
+    {
+        return area(node(p), node(q), node(r));
+    }
+
+    bool equals(int p1,int p2)
+    {
+        return node(p1).x == node(p2).x && node(p1).y == node(p2).y;
+    }
+
+    static int sign(double val)
+    {
+        return (0.0 < val) - (val < 0.0);
+    }
+
+    // For collinear points p, q, r, check if point q lies on segment pr
+    bool onSegment(int p,int q,int r)
+    {
+        const Node &pn = node(p), &qn = node(q), &rn = node(r);
+        return qn.x <= std::max(pn.x, rn.x) && qn.x >= std::min(pn.x, rn.x) &&
+               qn.y <= std::max(pn.y, rn.y) && qn.y >= std::min(pn.y, rn.y);
+    }
+
+    // Check if two segments intersect
+    bool intersects(int p1,int q1,int p2,int q2)
+    {
+        const int o1 = sign(area(p1, q1, p2));
+        const int o2 = sign(area(p1, q1, q2));
+        const int o3 = sign(area(p2, q2, p1));
+        const int o4 = sign(area(p2, q2, q1));
+
+        if (o1 != o2 && o3 != o4)
+            return true;   // General case
+
+        if (o1 == 0 && onSegment(p1, p2, q1)) return true;   // p1, q1 and p2 are collinear and p2 lies on p1q1
+        if (o2 == 0 && onSegment(p1, q2, q1)) return true;   // p1, q1 and q2 are collinear and q2 lies on p1q1
+        if (o3 == 0 && onSegment(p2, p1, q2)) return true;   // p2, q2 and p1 are collinear and p1 lies on p2q2
+        if (o4 == 0 && onSegment(p2, q1, q2)) return true;   // p2, q2 and q1 are collinear and q1 lies on p2q2
+
+        return false;
+    }
+
+    // Check if a polygon diagonal intersects any polygon segments
+    bool intersectsPolygon(int a,int b)
+    {
+        const int ai = node(a).i, bi = node(b).i;
+        int p = a;
+        do
+        {
+            const Node &pn = node(p);
+            const int ni = node(pn.next).i;
+            if (pn.i != ai && ni != ai && pn.i != bi && ni != bi &&
+                intersects(p, pn.next, a, b))
+                return true;
+            p = pn.next;
+        } while (p != a);
+
+        return false;
+    }
+
+    // Check if a polygon diagonal is locally inside the polygon
+    bool locallyInside(int a,int b)
+    {
+        const Node &an = node(a);
+        return area(an.prev, a, an.next) < 0.0 ?
+            area(a, b, an.next) >= 0.0 && area(a, an.prev, b) >= 0.0 :
+            area(a, b, an.prev) < 0.0 || area(a, an.next, b) < 0.0;
+    }
+
+    // Check if the middle point of a polygon diagonal is inside the polygon
+    bool middleInside(int a,int b)
+    {
+        int p = a;
+        bool inside = false;
+        const double px = (node(a).x + node(b).x) / 2.0;
+        const double py = (node(a).y + node(b).y) / 2.0;
+        do
+        {
+            const Node &pn = node(p), &nn = node(pn.next);
+            if (((pn.y > py) != (nn.y > py)) && nn.y != pn.y &&
+                (px < (nn.x - pn.x) * (py - pn.y) / (nn.y - pn.y) + pn.x))
+                inside = !inside;
+            p = pn.next;
+        } while (p != a);
+
+        return inside;
+    }
+
+    // Link two polygon vertices with a bridge.  If the vertices belong to the same ring,
+    //  it splits the polygon into two.  If one belongs to the outer ring and another to a hole,
+    //  it merges it into a single ring.
+    int splitPolygon(int a,int b)
+    {
+        const int a2 = newNode(node(a).i, node(a).x, node(a).y);
+        const int b2 = newNode(node(b).i, node(b).x, node(b).y);
+        const int an = node(a).next;
+        const int bp = node(b).prev;
+
+        node(a).next = b;
+        node(b).prev = a;
+
+        node(a2).next = an;
+        node(an).prev = a2;
+
+        node(b2).next = a2;
+        node(a2).prev = b2;
+
+        node(bp).next = b2;
+        node(b2).prev = bp;
+
+        return b2;
+    }
+
+    // Create a node and link it with the previous one in a circular doubly linked list
+    int insertNode(int i,const Point2d &pt,int last)
+    {
+        const int p = newNode(i, pt.x(), pt.y());
+        if (last < 0)
+        {
+            node(p).prev = p;
+            node(p).next = p;
+        }
+        else
+        {
+            node(p).next = node(last).next;
+            node(p).prev = last;
+            node(node(last).next).prev = p;
+            node(last).next = p;
+        }
+        return p;
+    }
+
+    void removeNode(int p)
+    {
+        Node &pn = node(p);
+        node(pn.next).prev = pn.prev;
+        node(pn.prev).next = pn.next;
+
+        if (pn.prevZ >= 0)
+            node(pn.prevZ).nextZ = pn.nextZ;
+        if (pn.nextZ >= 0)
+            node(pn.nextZ).prevZ = pn.prevZ;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<int> holeQueue;
+    std::vector<int> *indices = nullptr;
+    bool hashing = false;
+    double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+    double invSize = 0.0;
+};
+
+/// Scratch space for tesselation, one per thread
+struct TesselatorScratch
+{
+    TessArena arena;
+    EarClipper earClipper;
+    std::vector<Point2d> pts;
+    std::vector<int> loopStarts;
+    std::vector<int> indices;
+    std::vector<TESSreal> tessRing;
+
+    /// Let go of anything a big polygon blew up past the limit
+    void trim()
+    {
+        earClipper.trim();
+        TrimScratch(pts);
+        TrimScratch(loopStarts);
+        TrimScratch(indices);
+        TrimScratch(tessRing);
+    }
+};
+static thread_local TesselatorScratch tessScratch;
 
 static const float PolyScale2 = 1e6;
-    
-void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris)
+
+// Ear clipped triangles need to cover the polygon to within this fraction of its area
+static const double EarClipMaxDeviation = 1e-4;
+
+// Ear clip the loops, which have already been copied into the scratch points.
+// Returns false if the result doesn't look right and libtess should have a go.
+static bool EarClipLoops(TesselatorScratch &scratch,const Point2f &org,VectorTriangles *tris,bool check)
 {
-    std::vector<VectorRing> rings(1);
-    rings[0] = ring;
-    TesselateLoops(rings, tris);
+    const auto &pts = scratch.pts;
+    auto &indices = scratch.indices;
+    indices.clear();
+    scratch.earClipper.run(pts, scratch.loopStarts, indices);
+
+    if (check)
+    {
+        // Area of the polygon, holes and all
+        double polyArea = 0.0;
+        for (unsigned int li = 0; li < scratch.loopStarts.size(); li++)
+        {
+            const int start = scratch.loopStarts[li];
+            const int end = (li + 1 < scratch.loopStarts.size()) ? scratch.loopStarts[li + 1] : (int)pts.size();
+            double loopArea = 0.0;
+            for (int ii = start, jj = end - 1; ii < end; jj = ii++)
+            {
+                loopArea += (pts[jj].x() - pts[ii].x()) * (pts[ii].y() + pts[jj].y());
+            }
+            polyArea += (li == 0) ? std::abs(loopArea) : -std::abs(loopArea);
+        }
+
+        // Area of the triangles
+        double trisArea = 0.0;
+        for (unsigned int ii = 0; ii < indices.size(); ii += 3)
+        {
+            const Point2d &a = pts[indices[ii]], &b = pts[indices[ii+1]], &c = pts[indices[ii+2]];
+            trisArea += std::abs((a.x() - c.x()) * (b.y() - a.y()) - (a.x() - b.x()) * (c.y() - a.y()));
+        }
+
+        // Overlapping or self-intersecting loops throw this off
+        const double deviation = std::abs(trisArea - polyArea);
+        if (polyArea <= 0.0 ? (trisArea > 0.0 || scratch.loopStarts.size() > 1) : (deviation > polyArea * EarClipMaxDeviation))
+        {
+            return false;
+        }
+    }
+
+    // Points are shared between triangles
+    const int startPoint = (int)tris->pts.size();
+    tris->pts.reserve(tris->pts.size() + pts.size());
+    for (const auto &pt : pts)
+    {
+        tris->pts.push_back(Point3f(pt.x()/PolyScale2+org.x(), pt.y()/PolyScale2+org.y(), 0.0));
+    }
+    tris->tris.reserve(tris->tris.size() + indices.size() / 3);
+    for (unsigned int ii = 0; ii < indices.size(); ii += 3)
+    {
+        // Same winding as libtess, counter-clockwise
+        const Point2d &a = pts[indices[ii]], &b = pts[indices[ii+1]], &c = pts[indices[ii+2]];
+        const bool ccw = (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x()) >= 0.0;
+
+        VectorTriangles::Triangle triOut;
+        triOut.pts[0] = indices[ii] + startPoint;
+        triOut.pts[1] = indices[ccw ? ii+1 : ii+2] + startPoint;
+        triOut.pts[2] = indices[ccw ? ii+2 : ii+1] + startPoint;
+        tris->tris.push_back(triOut);
+    }
+
+    return true;
 }
-    
-void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
+
+// Run the loops through libtess, which handles anything
+static void LibTessLoops(TesselatorScratch &scratch,const Point2f &org,VectorTriangles *tris)
 {
-    if (loops.size() < 1)
-        return;
-    if (loops[0].size() < 1)
-        return;
-    
     static const int vertexSize = 2;
     static const int stride = sizeof(TESSreal) * vertexSize;
     static const int verticesPerTriangle = 3;
-  
-    TESSalloc ma;
 
-    ma.memalloc = stdAlloc;
-    ma.memfree = stdFree;
-    ma.extraVertices = 256; // realloc not provided, allow 256 extra vertic
+    const auto &pts = scratch.pts;
+
+    TESSalloc ma;
+    memset(&ma, 0, sizeof(ma));
+    ma.memalloc = arenaAlloc;
+    ma.memrealloc = arenaRealloc;
+    ma.memfree = arenaFree;
+    ma.userData = &scratch.arena;
+    // The arena can grow, this is just a head start
+    ma.extraVertices = std::max(256, (int)pts.size() / 8);
 
     TESStesselator *tess = tessNewTess(&ma);
-    
-    Point2f org = (loops[0])[0];
-    for (unsigned int li=0;li<loops.size();li++)
+
+    auto &tessRing = scratch.tessRing;
+    for (unsigned int li = 0; li < scratch.loopStarts.size(); li++)
     {
-        
-        const VectorRing &ring = loops[li];
-        std::vector<TESSreal> tessRing;
-        for (unsigned int ii=0;ii<ring.size();ii++)
+        const int start = scratch.loopStarts[li];
+        const int end = (li + 1 < scratch.loopStarts.size()) ? scratch.loopStarts[li + 1] : (int)pts.size();
+        tessRing.clear();
+        for (int ii = start; ii < end; ii++)
         {
-            const Point2f &pt = ring[ii];
-            if (ii==ring.size()-1 && pt.x() == ring[0].x() && pt.y() == ring[0].y())
-                continue;
-            if (ii > 0)
-            {
-                // We're seeing a lot of duplicates
-                const Point2f &prevPt = ring[ii-1];
-                if (pt.x() == prevPt.x() && pt.y() == prevPt.y())
-                    continue;
-            }
-            tessRing.push_back(static_cast<TESSreal>((pt.x()-org.x())*PolyScale2));
-            tessRing.push_back(static_cast<TESSreal>((pt.y()-org.y())*PolyScale2));
+            tessRing.push_back(static_cast<TESSreal>(pts[ii].x()));
+            tessRing.push_back(static_cast<TESSreal>(pts[ii].y()));
         }
         tessAddContour(tess, vertexSize, tessRing.data(), stride, (int)tessRing.size() / vertexSize);
-        
     }
     tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, verticesPerTriangle, vertexSize, 0);
  
@@ -119,60 +1015,71 @@ void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris
           tris->pts.push_back(Point3f(pos[0]/PolyScale2+org.x(), pos[1]/PolyScale2+org.y(), 0.0));
           triOut.pts[j] = j + startPoint;
         }
-        
-         //Make sure this is pointed up
-//                   Point3f pts[3];
-//                   for (unsigned int jj=0;jj<3;jj++)
-//                       pts[jj] = tris->pts[triOut.pts[jj]];
-//                   Vector3f norm = (pts[1]-pts[0]).cross(pts[2]-pts[0]);
-//                   if (norm.z() >= 0.0)
-//                   {
-//                       int tmp = triOut.pts[0];
-//                       triOut.pts[0] = triOut.pts[2];
-//                       triOut.pts[2] = tmp;
-//                   }
-       
         tris->tris.push_back(triOut);
     }
  
     tessDeleteTess(tess);
+    scratch.arena.reset();
+}
+
+void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris,TesselateMethod method)
+{
+    std::vector<VectorRing> rings(1);
+    rings[0] = ring;
+    TesselateLoops(rings, tris, method);
+}
     
-    // Convert to triangles
-    //    printf("  ");
-//    int startPoint = (int)(tris->pts.size());
-//    for (unsigned int ii=0;ii<tessInfo.pts.size();ii++)
-//    {
-//        Point3f &pt = tessInfo.pts[ii];
-//        tris->pts.push_back(Point3f(pt.x()/PolyScale2+org.x(),pt.y()/PolyScale2+org.y(),0.0));
-//    }
-//
-//    // Convert to triangles
-//    for (unsigned int ii=0;ii<tessInfo.tris.size();ii++)
-//    {
-//        std::vector<int> &tri = tessInfo.tris[ii];
-//        if (tri.size() == 3)
-//        {
-//            VectorTriangles::Triangle triOut;
-//            for (unsigned int jj=0;jj<3;jj++)
-//            {
-//                triOut.pts[jj] = tri[jj]+startPoint;
-//            }
-//
-//            // Make sure this is pointed up
-//            Point3f pts[3];
-//            for (unsigned int jj=0;jj<3;jj++)
-//                pts[jj] = tris->pts[triOut.pts[jj]];
-//            Vector3f norm = (pts[1]-pts[0]).cross(pts[2]-pts[0]);
-//            if (norm.z() >= 0.0)
-//            {
-//                int tmp = triOut.pts[0];
-//                triOut.pts[0] = triOut.pts[2];
-//                triOut.pts[2] = tmp;
-//            }
-//
-//            tris->tris.push_back(triOut);
-//        }
-//    }
+void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris,TesselateMethod method)
+{
+    if (loops.size() < 1)
+        return;
+    if (loops[0].size() < 1)
+        return;
+
+    TesselatorScratch &scratch = tessScratch;
+    scratch.pts.clear();
+    scratch.loopStarts.clear();
+
+    // Copy the loops in relative to the first point, without the duplicates
+    const Point2f org = (loops[0])[0];
+    for (const auto &ring : loops)
+    {
+        const int start = (int)scratch.pts.size();
+        for (unsigned int ii=0;ii<ring.size();ii++)
+        {
+            const Point2f &pt = ring[ii];
+            if (ii==ring.size()-1 && pt.x() == ring[0].x() && pt.y() == ring[0].y())
+                continue;
+            if (ii > 0)
+            {
+                // We're seeing a lot of duplicates
+                const Point2f &prevPt = ring[ii-1];
+                if (pt.x() == prevPt.x() && pt.y() == prevPt.y())
+                    continue;
+            }
+            // Rounded the way libtess would see them, so both come out the same
+            scratch.pts.emplace_back((TESSreal)((pt.x()-org.x())*PolyScale2),
+                                     (TESSreal)((pt.y()-org.y())*PolyScale2));
+        }
+
+        // Ear clipping wants rings with some area.  libtess doesn't care.
+        if ((int)scratch.pts.size() - start < 3)
+        {
+            scratch.pts.resize(start);
+            if (scratch.loopStarts.empty())
+                return;
+            continue;
+        }
+        scratch.loopStarts.push_back(start);
+    }
+
+    if (method == TesselateLibTess ||
+        !EarClipLoops(scratch, org, tris.get(), method == TesselateAuto))
+    {
+        LibTessLoops(scratch, org, tris.get());
+    }
+
+    scratch.trim();
 }
 
 }
@@ -18,6 +18,11 @@
 
 #import "Texture.h"
 #import "WhirlyKitLog.h"
+#if defined(__SSE2__)
+#import <immintrin.h>
+#elif defined(__ARM_NEON)
+#import <arm_neon.h>
+#endif
 
 using namespace WhirlyKit;
 using namespace Eigen;
@@ -31,205 +36,560 @@ using namespace Eigen;
 namespace WhirlyKit
 {
 
-// Convert a buffer in RGBA to 2-byte 565
+// Per pixel versions of the conversions.  These also handle whatever the vector loops leave over.
 // Code courtesy: http://stackoverflow.com/questions/7930148/opengl-es-on-ios-texture-loading-how-do-i-get-from-a-rgba8888-png-file-to-a-r
-RawDataRef ConvertRGBATo565(const RawDataRef &inData)
+static inline uint16_t PixelTo565(uint32_t p)
 {
-    const uint32_t pixelCount = inData->getLen()/4;
-    void *temp = malloc(pixelCount * 2);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
+    return (uint16_t)(((p << 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 19) & 0x001F));
+}
+
+static inline uint16_t PixelTo4444(uint32_t p)
+{
+    return (uint16_t)(((p << 8) & 0xF000) | ((p >> 4) & 0x0F00) | ((p >> 16) & 0x00F0) | (p >> 28));
+}
+
+static inline uint16_t PixelTo5551(uint32_t p)
+{
+    return (uint16_t)(((p << 8) & 0xF800) | ((p >> 5) & 0x07C0) | ((p >> 18) & 0x003E) | (p >> 31));
+}
+
+// Red and green bytes, in that order
+static inline uint16_t PixelToRG(uint32_t p)
+{
+    return (uint16_t)(p & 0xFFFF);
+}
+
+// Bit offset of the byte we want, or -1 for the RGB average
+static int SingleByteShift(WKSingleByteSource source)
+{
+    switch (source)
     {
-        const uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 3);
-        const uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 2);
-        const uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 3);
-        
-        *outPixel16++ = (r << 11) | (g << 5) | (b << 0);
+        case WKSingleRed:   return 0;
+        case WKSingleGreen: return 8;
+        case WKSingleBlue:  return 16;
+        case WKSingleAlpha: return 24;
+        case WKSingleRGB:
+        default:            return -1;
     }
+}
 
-    ANALYSIS_ASSUME_FREED(temp);
+static inline uint8_t PixelTo8(uint32_t p,int shift)
+{
+    if (shift >= 0)
+        return (uint8_t)((p >> shift) & 0xFF);
+    return (uint8_t)(((p & 0xFF) + ((p >> 8) & 0xFF) + ((p >> 16) & 0xFF)) / 3);
+}
+
+// For sums up to 765, sum/3 == (sum * DivideBy3Mult) >> 17
+static const uint16_t DivideBy3Mult = 0xAAAB;
+
+#if defined(__SSE2__) && defined(__GNUC__) && !defined(__AVX2__)
+// We'll check for AVX2 at runtime
+#define WK_TEXTURE_AVX2 1
+#define WK_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define WK_TEXTURE_AVX2 1
+#define WK_TARGET_AVX2
+#endif
+
+#if defined(__SSE2__)
+
+// Each of these converts 4 pixels (SSE2) or 8 pixels (AVX2) in 32 bit lanes into 16 bit values, still in 32 bit lanes
+struct Pixel16Op565
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo565(p); }
+    static inline __m128i vec(__m128i p)
+    {
+        return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),
+                                         _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0))),
+                            _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x001F)));
+    }
+#if defined(WK_TEXTURE_AVX2)
+    WK_TARGET_AVX2 static inline __m256i vec256(__m256i p)
+    {
+        return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(p, 8), _mm256_set1_epi32(0xF800)),
+                                               _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0))),
+                               _mm256_and_si256(_mm256_srli_epi32(p, 19), _mm256_set1_epi32(0x001F)));
+    }
+#endif
+};
+
+struct Pixel16Op4444
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo4444(p); }
+    static inline __m128i vec(__m128i p)
+    {
+        return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF000)),
+                                         _mm_and_si128(_mm_srli_epi32(p, 4), _mm_set1_epi32(0x0F00))),
+                            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x00F0)),
+                                         _mm_srli_epi32(p, 28)));
+    }
+#if defined(WK_TEXTURE_AVX2)
+    WK_TARGET_AVX2 static inline __m256i vec256(__m256i p)
+    {
+        return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(p, 8), _mm256_set1_epi32(0xF000)),
+                                               _mm256_and_si256(_mm256_srli_epi32(p, 4), _mm256_set1_epi32(0x0F00))),
+                               _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(p, 16), _mm256_set1_epi32(0x00F0)),
+                                               _mm256_srli_epi32(p, 28)));
+    }
+#endif
+};
+
+struct Pixel16Op5551
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo5551(p); }
+    static inline __m128i vec(__m128i p)
+    {
+        return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),
+                                         _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07C0))),
+                            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x003E)),
+                                         _mm_srli_epi32(p, 31)));
+    }
+#if defined(WK_TEXTURE_AVX2)
+    WK_TARGET_AVX2 static inline __m256i vec256(__m256i p)
+    {
+        return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(p, 8), _mm256_set1_epi32(0xF800)),
+                                               _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07C0))),
+                               _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(p, 18), _mm256_set1_epi32(0x003E)),
+                                               _mm256_srli_epi32(p, 31)));
+    }
+#endif
+};
 
-    return std::make_shared<RawDataWrapper>(temp,pixelCount*2,true);
+struct Pixel16OpRG
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelToRG(p); }
+    static inline __m128i vec(__m128i p) { return _mm_and_si128(p, _mm_set1_epi32(0xFFFF)); }
+#if defined(WK_TEXTURE_AVX2)
+    WK_TARGET_AVX2 static inline __m256i vec256(__m256i p) { return _mm256_and_si256(p, _mm256_set1_epi32(0xFFFF)); }
+#endif
+};
+
+// SSE2 only has a signed 32->16 bit pack, so sign extend the low halves first
+static inline __m128i Pack32To16(__m128i a,__m128i b)
+{
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                           _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
 }
 
+template<typename Op>
+static void ConvertTo16SSE2(const uint32_t *in,size_t pixelCount,uint16_t *out)
+{
+    size_t ii = 0;
+    for (; ii + 8 <= pixelCount; ii += 8)
+    {
+        const __m128i p0 = Op::vec(_mm_loadu_si128((const __m128i *)(in + ii)));
+        const __m128i p1 = Op::vec(_mm_loadu_si128((const __m128i *)(in + ii + 4)));
+        _mm_storeu_si128((__m128i *)(out + ii), Pack32To16(p0, p1));
+    }
+    for (; ii < pixelCount; ii++)
+        out[ii] = Op::pixel(in[ii]);
+}
 
-// Convert a buffer in RGBA to 2-byte 4444
-RawDataRef ConvertRGBATo4444(const RawDataRef &inData)
+// Sum of R, G, and B or just the one byte we want, 4 pixels at a time
+static inline __m128i SingleByteSSE2(__m128i p,int shift)
 {
-    const uint32_t pixelCount = inData->getLen()/4;
-    void *temp = malloc(pixelCount * 2);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    if (shift >= 0)
+        return _mm_and_si128(_mm_srl_epi32(p, _mm_cvtsi32_si128(shift)), byteMask);
+    return _mm_add_epi32(_mm_add_epi32(_mm_and_si128(p, byteMask),
+                                       _mm_and_si128(_mm_srli_epi32(p, 8), byteMask)),
+                         _mm_and_si128(_mm_srli_epi32(p, 16), byteMask));
+}
+
+static void ConvertTo8SSE2(const uint32_t *in,size_t pixelCount,int shift,uint8_t *out)
+{
+    const __m128i div3 = _mm_set1_epi16((short)DivideBy3Mult);
+
+    size_t ii = 0;
+    for (; ii + 16 <= pixelCount; ii += 16)
     {
-        const uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 4);
-        const uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 4);
-        const uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 4);
-        const uint32_t a = (((*inPixel32 >> 24) & 0xFF) >> 4);
-        
-        *outPixel16++ = (r << 12) | (g << 8) | (b << 4) | (a<< 0);
+        // Everything fits in a signed 16 bit value after this
+        __m128i lo = _mm_packs_epi32(SingleByteSSE2(_mm_loadu_si128((const __m128i *)(in + ii)), shift),
+                                     SingleByteSSE2(_mm_loadu_si128((const __m128i *)(in + ii + 4)), shift));
+        __m128i hi = _mm_packs_epi32(SingleByteSSE2(_mm_loadu_si128((const __m128i *)(in + ii + 8)), shift),
+                                     SingleByteSSE2(_mm_loadu_si128((const __m128i *)(in + ii + 12)), shift));
+        if (shift < 0)
+        {
+            lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, div3), 1);
+            hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, div3), 1);
+        }
+        _mm_storeu_si128((__m128i *)(out + ii), _mm_packus_epi16(lo, hi));
     }
+    for (; ii < pixelCount; ii++)
+        out[ii] = PixelTo8(in[ii], shift);
+}
 
-    ANALYSIS_ASSUME_FREED(temp);
+#if defined(WK_TEXTURE_AVX2)
 
-    return std::make_shared<RawDataWrapper>(temp,pixelCount*2,true);
+template<typename Op>
+WK_TARGET_AVX2 static void ConvertTo16AVX2(const uint32_t *in,size_t pixelCount,uint16_t *out)
+{
+    size_t ii = 0;
+    for (; ii + 16 <= pixelCount; ii += 16)
+    {
+        const __m256i p0 = Op::vec256(_mm256_loadu_si256((const __m256i *)(in + ii)));
+        const __m256i p1 = Op::vec256(_mm256_loadu_si256((const __m256i *)(in + ii + 8)));
+        // The pack works within 128 bit lanes, so put the 64 bit chunks back in order
+        _mm256_storeu_si256((__m256i *)(out + ii), _mm256_permute4x64_epi64(_mm256_packus_epi32(p0, p1), 0xD8));
+    }
+    ConvertTo16SSE2<Op>(in + ii, pixelCount - ii, out + ii);
 }
 
-// Convert a buffer in RGBA to 2-byte 5551
-RawDataRef ConvertRGBATo5551(const RawDataRef &inData)
+WK_TARGET_AVX2 static inline __m256i SingleByteAVX2(__m256i p,int shift)
 {
-    const uint32_t pixelCount = inData->getLen()/4;
-    void *temp = malloc(pixelCount * 2);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    if (shift >= 0)
+        return _mm256_and_si256(_mm256_srl_epi32(p, _mm_cvtsi32_si128(shift)), byteMask);
+    return _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(p, byteMask),
+                                             _mm256_and_si256(_mm256_srli_epi32(p, 8), byteMask)),
+                            _mm256_and_si256(_mm256_srli_epi32(p, 16), byteMask));
+}
+
+WK_TARGET_AVX2 static void ConvertTo8AVX2(const uint32_t *in,size_t pixelCount,int shift,uint8_t *out)
+{
+    const __m256i div3 = _mm256_set1_epi16((short)DivideBy3Mult);
+    // The packs interleave 4 pixel groups across the 128 bit lanes.  This undoes that.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t ii = 0;
+    for (; ii + 32 <= pixelCount; ii += 32)
+    {
+        __m256i lo = _mm256_packs_epi32(SingleByteAVX2(_mm256_loadu_si256((const __m256i *)(in + ii)), shift),
+                                        SingleByteAVX2(_mm256_loadu_si256((const __m256i *)(in + ii + 8)), shift));
+        __m256i hi = _mm256_packs_epi32(SingleByteAVX2(_mm256_loadu_si256((const __m256i *)(in + ii + 16)), shift),
+                                        SingleByteAVX2(_mm256_loadu_si256((const __m256i *)(in + ii + 24)), shift));
+        if (shift < 0)
+        {
+            lo = _mm256_srli_epi16(_mm256_mulhi_epu16(lo, div3), 1);
+            hi = _mm256_srli_epi16(_mm256_mulhi_epu16(hi, div3), 1);
+        }
+        _mm256_storeu_si256((__m256i *)(out + ii), _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order));
+    }
+    ConvertTo8SSE2(in + ii, pixelCount - ii, shift, out + ii);
+}
+
+#endif
+
+#elif defined(__ARM_NEON)
+
+// Each of these converts 4 pixels in 32 bit lanes into 16 bit values, still in 32 bit lanes
+struct Pixel16Op565
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo565(p); }
+    static inline uint32x4_t vec(uint32x4_t p)
     {
-        const uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 3);
-        const uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 3);
-        const uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 3);
-        const uint32_t a = (((*inPixel32 >> 24) & 0xFF) >> 7);
-        
-        *outPixel16++ = (r << 11) | (g << 6) | (b << 1) | (a << 0);
+        return vorrq_u32(vorrq_u32(vandq_u32(vshlq_n_u32(p, 8), vdupq_n_u32(0xF800)),
+                                   vandq_u32(vshrq_n_u32(p, 5), vdupq_n_u32(0x07E0))),
+                         vandq_u32(vshrq_n_u32(p, 19), vdupq_n_u32(0x001F)));
     }
+};
+
+struct Pixel16Op4444
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo4444(p); }
+    static inline uint32x4_t vec(uint32x4_t p)
+    {
+        return vorrq_u32(vorrq_u32(vandq_u32(vshlq_n_u32(p, 8), vdupq_n_u32(0xF000)),
+                                   vandq_u32(vshrq_n_u32(p, 4), vdupq_n_u32(0x0F00))),
+                         vorrq_u32(vandq_u32(vshrq_n_u32(p, 16), vdupq_n_u32(0x00F0)),
+                                   vshrq_n_u32(p, 28)));
+    }
+};
+
+struct Pixel16Op5551
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelTo5551(p); }
+    static inline uint32x4_t vec(uint32x4_t p)
+    {
+        return vorrq_u32(vorrq_u32(vandq_u32(vshlq_n_u32(p, 8), vdupq_n_u32(0xF800)),
+                                   vandq_u32(vshrq_n_u32(p, 5), vdupq_n_u32(0x07C0))),
+                         vorrq_u32(vandq_u32(vshrq_n_u32(p, 18), vdupq_n_u32(0x003E)),
+                                   vshrq_n_u32(p, 31)));
+    }
+};
+
+struct Pixel16OpRG
+{
+    static inline uint16_t pixel(uint32_t p) { return PixelToRG(p); }
+    // Narrowing takes care of this
+    static inline uint32x4_t vec(uint32x4_t p) { return p; }
+};
+
+template<typename Op>
+static void ConvertTo16NEON(const uint32_t *in,size_t pixelCount,uint16_t *out)
+{
+    size_t ii = 0;
+    for (; ii + 8 <= pixelCount; ii += 8)
+    {
+        const uint16x4_t lo = vmovn_u32(Op::vec(vld1q_u32(in + ii)));
+        const uint16x4_t hi = vmovn_u32(Op::vec(vld1q_u32(in + ii + 4)));
+        vst1q_u16(out + ii, vcombine_u16(lo, hi));
+    }
+    for (; ii < pixelCount; ii++)
+        out[ii] = Op::pixel(in[ii]);
+}
+
+// Sum of R, G, and B divided by 3, for 8 pixels
+static inline uint8x8_t AverageRGBNEON(uint8x8_t r,uint8x8_t g,uint8x8_t b)
+{
+    const uint16x4_t div3 = vdup_n_u16(DivideBy3Mult);
+    const uint16x8_t sum = vaddw_u8(vaddl_u8(r, g), b);
+    const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(sum), div3), 16);
+    const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(sum), div3), 16);
+    return vshrn_n_u16(vcombine_u16(lo, hi), 1);
+}
+
+static void ConvertTo8NEON(const uint32_t *in,size_t pixelCount,int shift,uint8_t *out)
+{
+    const uint8_t *inBytes = (const uint8_t *)in;
+
+    size_t ii = 0;
+    for (; ii + 16 <= pixelCount; ii += 16)
+    {
+        // This splits out the channels as it loads
+        const uint8x16x4_t rgba = vld4q_u8(inBytes + 4*ii);
+        if (shift >= 0)
+        {
+            vst1q_u8(out + ii, rgba.val[shift/8]);
+        } else {
+            const uint8x8_t lo = AverageRGBNEON(vget_low_u8(rgba.val[0]), vget_low_u8(rgba.val[1]), vget_low_u8(rgba.val[2]));
+            const uint8x8_t hi = AverageRGBNEON(vget_high_u8(rgba.val[0]), vget_high_u8(rgba.val[1]), vget_high_u8(rgba.val[2]));
+            vst1q_u8(out + ii, vcombine_u8(lo, hi));
+        }
+    }
+    for (; ii < pixelCount; ii++)
+        out[ii] = PixelTo8(in[ii], shift);
+}
+
+#else
 
+struct Pixel16Op565  { static inline uint16_t pixel(uint32_t p) { return PixelTo565(p); } };
+struct Pixel16Op4444 { static inline uint16_t pixel(uint32_t p) { return PixelTo4444(p); } };
+struct Pixel16Op5551 { static inline uint16_t pixel(uint32_t p) { return PixelTo5551(p); } };
+struct Pixel16OpRG   { static inline uint16_t pixel(uint32_t p) { return PixelToRG(p); } };
+
+#endif
+
+#if defined(WK_TEXTURE_AVX2) && !defined(__AVX2__)
+static bool HasAVX2()
+{
+    static const bool hasAVX2 = []{
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return hasAVX2;
+}
+#endif
+
+// RGBA pixels to 16 bits per pixel, using the best version this machine has
+template<typename Op>
+static void ConvertTo16(const unsigned char *inData,size_t pixelCount,unsigned char *outData)
+{
+    const uint32_t *in = (const uint32_t *)inData;
+    uint16_t *out = (uint16_t *)outData;
+#if defined(__AVX2__)
+    ConvertTo16AVX2<Op>(in, pixelCount, out);
+#elif defined(WK_TEXTURE_AVX2)
+    if (HasAVX2())
+        ConvertTo16AVX2<Op>(in, pixelCount, out);
+    else
+        ConvertTo16SSE2<Op>(in, pixelCount, out);
+#elif defined(__SSE2__)
+    ConvertTo16SSE2<Op>(in, pixelCount, out);
+#elif defined(__ARM_NEON)
+    ConvertTo16NEON<Op>(in, pixelCount, out);
+#else
+    for (size_t ii = 0; ii < pixelCount; ii++)
+        out[ii] = Op::pixel(in[ii]);
+#endif
+}
+
+// RGBA pixels to 8 bits per pixel, using the best version this machine has
+static void ConvertTo8(const unsigned char *inData,size_t pixelCount,WKSingleByteSource source,unsigned char *out)
+{
+    const uint32_t *in = (const uint32_t *)inData;
+    const int shift = SingleByteShift(source);
+#if defined(__AVX2__)
+    ConvertTo8AVX2(in, pixelCount, shift, out);
+#elif defined(WK_TEXTURE_AVX2)
+    if (HasAVX2())
+        ConvertTo8AVX2(in, pixelCount, shift, out);
+    else
+        ConvertTo8SSE2(in, pixelCount, shift, out);
+#elif defined(__SSE2__)
+    ConvertTo8SSE2(in, pixelCount, shift, out);
+#elif defined(__ARM_NEON)
+    ConvertTo8NEON(in, pixelCount, shift, out);
+#else
+    for (size_t ii = 0; ii < pixelCount; ii++)
+        out[ii] = PixelTo8(in[ii], shift);
+#endif
+}
+
+// Width padded out to a multiple of align
+static int PaddedWidth(int width,int align)
+{
+    return (width + align - 1) / align * align;
+}
+
+// Copy rows into a wider buffer, zeroing the extra
+static void PadRows(const unsigned char *inBytes,int rowBytes,int height,int outRowBytes,unsigned char *outBytes)
+{
+    for (int h=0;h<height;h++)
+    {
+        memcpy(outBytes, inBytes, rowBytes);
+        memset(outBytes + rowBytes, 0, outRowBytes - rowBytes);
+        inBytes += rowBytes;
+        outBytes += outRowBytes;
+    }
+}
+
+// Pull the red and green out of each RGBA row, zeroing any padding
+static void RGBATo16Rows(const unsigned char *inBytes,int width,int height,int outWidth,unsigned char *outBytes)
+{
+    if (outWidth == width)
+    {
+        ConvertTo16<Pixel16OpRG>(inBytes, (size_t)width * height, outBytes);
+        return;
+    }
+
+    for (int h=0;h<height;h++)
+    {
+        ConvertTo16<Pixel16OpRG>(inBytes, width, outBytes);
+        memset(outBytes + 2*width, 0, 2*(outWidth - width));
+        inBytes += 4*width;
+        outBytes += 2*outWidth;
+    }
+}
+
+// Wrap up a buffer we've malloc'ed
+static RawDataRef WrapConverted(void *temp,size_t len)
+{
     ANALYSIS_ASSUME_FREED(temp);
 
-    return std::make_shared<RawDataWrapper>(temp,pixelCount*2,true);
+    return std::make_shared<RawDataWrapper>(temp,len,true);
+}
+
+RawDataRef ConvertRGBATo565(const RawDataRef &inData)
+{
+    const size_t pixelCount = inData->getLen()/4;
+    void *temp = malloc(pixelCount * 2);
+    ConvertTo16<Pixel16Op565>(inData->getRawData(), pixelCount, (unsigned char *)temp);
+    return WrapConverted(temp, pixelCount*2);
+}
+
+RawDataRef ConvertRGBATo4444(const RawDataRef &inData)
+{
+    const size_t pixelCount = inData->getLen()/4;
+    void *temp = malloc(pixelCount * 2);
+    ConvertTo16<Pixel16Op4444>(inData->getRawData(), pixelCount, (unsigned char *)temp);
+    return WrapConverted(temp, pixelCount*2);
+}
+
+RawDataRef ConvertRGBATo5551(const RawDataRef &inData)
+{
+    const size_t pixelCount = inData->getLen()/4;
+    void *temp = malloc(pixelCount * 2);
+    ConvertTo16<Pixel16Op5551>(inData->getRawData(), pixelCount, (unsigned char *)temp);
+    return WrapConverted(temp, pixelCount*2);
 }
 
-// Convert a buffer in A to 1-byte alpha but align it to 32 bits
 RawDataRef ConvertAToA(const RawDataRef &inData,int width,int height)
 {
     if (width % 4 == 0)
         return inData;
-    
-    int extra = 4 - (width % 4);
-    if (extra == 4) extra = 0;
-    int outWidth = width + extra;
-    
-    unsigned char *temp = (unsigned char *)malloc(outWidth*height);
-    
-    const unsigned char *inBytes = (const unsigned char *)inData->getRawData();
-    unsigned char *outBytes = (unsigned char *)temp;
-    for (int32_t h=0;h<height;h++) {
-        bzero(&outBytes[width], extra);
-        bcopy(inBytes, outBytes, width);
-        inBytes += width;
-        outBytes += outWidth;
-    }
-
-    ANALYSIS_ASSUME_FREED(temp);
 
-    return std::make_shared<RawDataWrapper>(temp,outWidth*height,true);
+    const int outWidth = PaddedWidth(width, 4);
+    void *temp = malloc(outWidth*height);
+    PadRows(inData->getRawData(), width, height, outWidth, (unsigned char *)temp);
+    return WrapConverted(temp, outWidth*height);
 }
 
-// Convert a buffer in RG to a 2-byte RG but align it to 32 bits
 RawDataRef ConvertRGToRG(const RawDataRef &inData,int width,int height)
 {
     if (width % 2 == 0)
         return inData;
-    
-    int extra = 2 - (width % 2);
-    if (extra == 2) extra = 0;
-    const int outWidth = width + extra;
-    
-    unsigned char *temp = (unsigned char *)malloc(outWidth*height*2);
-    
-    const unsigned char *inBytes = (const unsigned char *)inData->getRawData();
-    unsigned char *outBytes = (unsigned char *)temp;
-    for (int32_t h=0;h<height;h++) {
-        bzero(&outBytes[width], 2*extra);
-        bcopy(inBytes, outBytes, 2*width);
-        inBytes += 2*width;
-        outBytes += 2*outWidth;
-    }
-
-    ANALYSIS_ASSUME_FREED(temp);
 
-    return std::make_shared<RawDataWrapper>(temp,outWidth*height*2,true);
+    const int outWidth = PaddedWidth(width, 2);
+    void *temp = malloc(outWidth*height*2);
+    PadRows(inData->getRawData(), 2*width, height, 2*outWidth, (unsigned char *)temp);
+    return WrapConverted(temp, outWidth*height*2);
 }
 
 RawDataRef ConvertRGBATo16(const RawDataRef &inData,int width,int height,bool pad)
 {
-    int extra = 2 - (width % 2);
-    if (extra == 2) extra = 0;
-    
     // Metal doesn't seem to care if we pad
-    if (!pad)
-        extra = 0;
-    
-    const int outWidth = width + extra;
+    const int outWidth = pad ? PaddedWidth(width, 2) : width;
+    void *temp = malloc(outWidth*height*2);
+    RGBATo16Rows(inData->getRawData(), width, height, outWidth, (unsigned char *)temp);
+    return WrapConverted(temp, outWidth*height*2);
+}
 
-    unsigned char *temp = (unsigned char *)malloc(outWidth*height*2);
-    bzero(temp,outWidth*height*2);
-    
-    const uint32_t *inPixel32row  = (uint32_t *)inData->getRawData();
-    uint8_t *outPixel8row = (uint8_t *)temp;
-    for (int32_t h=0;h<height;h++) {
-        const uint32_t *inPixel32 = inPixel32row;
-        uint8_t *outPixel8 = outPixel8row;
-        for (int32_t w=0;w<width;w++) {
-            uint32_t r = ((*inPixel32 >> 0)  & 0xFF);
-            uint32_t g = ((*inPixel32 >> 8)  & 0xFF);
-            outPixel8[0] = r;
-            outPixel8[1] = g;
-            
-            inPixel32++;
-            outPixel8+=2;
-        }
-        
-        inPixel32row += width;
-        outPixel8row += 2*outWidth;
-    }
+RawDataRef ConvertRGBATo8(const RawDataRef &inData,WKSingleByteSource source)
+{
+    const size_t pixelCount = inData->getLen()/4;
+    void *temp = malloc(pixelCount);
+    ConvertTo8(inData->getRawData(), pixelCount, source, (unsigned char *)temp);
+    return WrapConverted(temp, pixelCount);
+}
 
-    ANALYSIS_ASSUME_FREED(temp);
+void ConvertRGBATo565(const RawData &inData,std::vector<unsigned char> &outData)
+{
+    const size_t pixelCount = inData.getLen()/4;
+    outData.resize(pixelCount * 2);
+    ConvertTo16<Pixel16Op565>(inData.getRawData(), pixelCount, outData.data());
+}
 
-    return std::make_shared<RawDataWrapper>(temp,outWidth*height*2,true);
+void ConvertRGBATo4444(const RawData &inData,std::vector<unsigned char> &outData)
+{
+    const size_t pixelCount = inData.getLen()/4;
+    outData.resize(pixelCount * 2);
+    ConvertTo16<Pixel16Op4444>(inData.getRawData(), pixelCount, outData.data());
 }
 
-// Convert a buffer in RGBA to 1-byte alpha
-RawDataRef ConvertRGBATo8(const RawDataRef &inData,WKSingleByteSource source)
+void ConvertRGBATo5551(const RawData &inData,std::vector<unsigned char> &outData)
 {
-    const uint32_t pixelCount = inData->getLen()/4;
-    void *temp = malloc(pixelCount);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint8_t *outPixel8 = (uint8_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
-    {
-        const uint32_t r = ((*inPixel32 >> 0)  & 0xFF);
-        const uint32_t g = ((*inPixel32 >> 8)  & 0xFF);
-        const uint32_t b = ((*inPixel32 >> 16) & 0xFF);
-        const uint32_t a = ((*inPixel32 >> 24) & 0xFF);
-        int sum = 0;
-        switch (source)     // todo: is the compiler smart enough to hoist this out of the loop?
-        {
-            case WKSingleRed:
-                sum = r;
-                break;
-            case WKSingleGreen:
-                sum = g;
-                break;
-            case WKSingleBlue:
-                sum = b;
-                break;
-            case WKSingleRGB:
-                sum = ((int)r + (int)g + (int)b)/3;
-                break;
-            case WKSingleAlpha:
-                sum = a;
-                break;
-        }
-        *outPixel8++ = (uint8_t)sum;
-    }
+    const size_t pixelCount = inData.getLen()/4;
+    outData.resize(pixelCount * 2);
+    ConvertTo16<Pixel16Op5551>(inData.getRawData(), pixelCount, outData.data());
+}
 
-    ANALYSIS_ASSUME_FREED(temp);
+void ConvertAToA(const RawData &inData,int width,int height,std::vector<unsigned char> &outData)
+{
+    const int outWidth = PaddedWidth(width, 4);
+    outData.resize(outWidth*height);
+    PadRows(inData.getRawData(), width, height, outWidth, outData.data());
+}
+
+void ConvertRGToRG(const RawData &inData,int width,int height,std::vector<unsigned char> &outData)
+{
+    const int outWidth = PaddedWidth(width, 2);
+    outData.resize(outWidth*height*2);
+    PadRows(inData.getRawData(), 2*width, height, 2*outWidth, outData.data());
+}
 
-    return std::make_shared<RawDataWrapper>(temp,pixelCount,true);
+void ConvertRGBATo16(const RawData &inData,int width,int height,bool pad,std::vector<unsigned char> &outData)
+{
+    const int outWidth = pad ? PaddedWidth(width, 2) : width;
+    outData.resize(outWidth*height*2);
+    RGBATo16Rows(inData.getRawData(), width, height, outWidth, outData.data());
+}
+
+void ConvertRGBATo8(const RawData &inData,WKSingleByteSource source,std::vector<unsigned char> &outData)
+{
+    const size_t pixelCount = inData.getLen()/4;
+    outData.resize(pixelCount);
+    ConvertTo8(inData.getRawData(), pixelCount, source, outData.data());
+}
+
+// Conversion buffers bigger than this aren't worth hanging on to
+static const size_t MaxConvertBufferKeep = 4 * 1024 * 1024;
+
+void TrimConvertBuffer(std::vector<unsigned char> &buffer)
+{
+    if (buffer.capacity() > MaxConvertBufferKeep)
+        std::vector<unsigned char>().swap(buffer);
 }
 
 TextureBase::TextureBase(SimpleIdentity thisId)
@@ -278,51 +638,63 @@ void Texture::setRawData(RawData *rawData,int inWidth,int inHeight)
 
 RawDataRef Texture::processData()
 {
-    if (!texData)
-        return NULL;
+    std::vector<unsigned char> buffer;
+    RawDataRef data = processData(buffer);
+    if (!data || data == texData)
+        return data;
+
+    // Converted into the buffer, so hand it over to something that owns it
+    return std::make_shared<MutableRawData>(std::move(buffer));
+}
     
-	if (isPVRTC || isPKM)
-	{
+RawDataRef Texture::processData(std::vector<unsigned char> &buffer)
+{
+    if (!texData || isPVRTC || isPKM)
         return texData;
-	} else {
-        // Depending on the format, we may need to mess around with the bytes
-        switch (format)
-        {
-            case TexTypeUnsignedByte:
-            default:
-                return texData;
-                break;
-            case TexTypeShort565:
-                return ConvertRGBATo565(texData);
-                break;
-            case TexTypeShort4444:
-                return ConvertRGBATo4444(texData);
-                break;
-            case TexTypeShort5551:
-                return ConvertRGBATo5551(texData);
-                break;
-            case TexTypeSingleChannel:
-                if (texData->getLen() == width * height)
-                    return ConvertAToA(texData,width,height);
-                return ConvertRGBATo8(texData,byteSource);
-                break;
-            case TexTypeDoubleChannel:
-                if (texData->getLen()  == width * height * 2)
-                    return ConvertRGToRG(texData,width,height);
-                else if (texData->getLen() == width * height * 4)
-                    return ConvertRGBATo16(texData,width,height,true);
+
+    const RawData &inData = *texData;
+    switch (format)
+    {
+        case TexTypeUnsignedByte:
+        default:
+            return texData;
+        case TexTypeShort565:
+            ConvertRGBATo565(inData,buffer);
+            break;
+        case TexTypeShort4444:
+            ConvertRGBATo4444(inData,buffer);
+            break;
+        case TexTypeShort5551:
+            ConvertRGBATo5551(inData,buffer);
+            break;
+        case TexTypeSingleChannel:
+            if (inData.getLen() == width * height)
+            {
+                if (width % 4 == 0)
+                    return texData;
+                ConvertAToA(inData,width,height,buffer);
+            } else
+                ConvertRGBATo8(inData,byteSource,buffer);
+            break;
+        case TexTypeDoubleChannel:
+            if (inData.getLen() == width * height * 2)
+            {
+                if (width % 2 == 0)
+                    return texData;
+                ConvertRGToRG(inData,width,height,buffer);
+            } else if (inData.getLen() == width * height * 4)
+                ConvertRGBATo16(inData,width,height,true,buffer);
+            else {
                 wkLogLevel(Error,"Texture: Not handling RG conversion case.");
-                break;
-//            case GL_COMPRESSED_RGB8_ETC2:
-//                // Can't convert this (for now)
-//                return texData;
-//                break;
-        }
-	}
-    
-    return RawDataRef();
+                return RawDataRef();
+            }
+            break;
+    }
+
+    // The caller owns the buffer, we're just pointing into it
+    return std::make_shared<RawDataWrapper>(buffer.data(),buffer.size(),false);
 }
-    
+
 void Texture::setPKMData(RawDataRef inData)
 {
     texData = inData;
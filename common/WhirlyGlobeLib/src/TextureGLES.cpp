@@ -138,7 +138,9 @@ bool TextureGLES::createInRenderer(const RenderSetupInfo *inSetupInfo)
     
     CheckGLError("Texture::createInGL() glTexParameteri()");
     
-    RawDataRef convertedData = processData();
+    // Converted data only needs to last until we hand it to OpenGL, so reuse the memory
+    static thread_local std::vector<unsigned char> convertBuffer;
+    RawDataRef convertedData = processData(convertBuffer);
     
     // If it's in an optimized form, we can use that more efficiently
     if (isPVRTC)
@@ -205,6 +207,8 @@ bool TextureGLES::createInRenderer(const RenderSetupInfo *inSetupInfo)
     
     // Once we've moved it over to OpenGL, let's get rid of this copy
     texData.reset();
+    convertedData.reset();
+    TrimConvertBuffer(convertBuffer);
     
     return true;
 }
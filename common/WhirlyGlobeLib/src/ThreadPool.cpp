@@ -0,0 +1,299 @@
+/*  ThreadPool.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "ThreadPool.h"
+#import "WhirlyKitLog.h"
+#import <map>
+#import <algorithm>
+
+namespace WhirlyKit
+{
+
+// Which pool (and which worker in it) the current thread belongs to
+static thread_local ThreadPool *currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+ThreadPool::ThreadPool(int numThreads)
+{
+    numThreads = std::max(numThreads, 1);
+    workers.reserve(numThreads);
+    for (int ii = 0; ii < numThreads; ii++)
+    {
+        workers.emplace_back(std::make_unique<Worker>());
+    }
+    // Don't start until the queues are all in place
+    for (int ii = 0; ii < numThreads; ii++)
+    {
+        workers[ii]->thread = std::thread(&ThreadPool::workerMain, this, ii);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guardLock(sleepLock);
+        shutdown = true;
+    }
+    sleepCond.notify_all();
+
+    for (auto &worker : workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+int ThreadPool::workerIndex() const
+{
+    return (currentPool == this) ? currentWorker : -1;
+}
+
+void ThreadPool::run(Group &group,Task task)
+{
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    group.queued.fetch_add(1, std::memory_order_release);
+
+    // Workers keep their own tasks close, everyone else spreads them out
+    int which = workerIndex();
+    if (which < 0)
+    {
+        which = (int)(nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size());
+    }
+
+    {
+        auto &worker = *workers[which];
+        std::lock_guard<std::mutex> guardLock(worker.lock);
+        worker.tasks.push_back(QueuedTask { std::move(task), &group });
+        numQueued.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> guardLock(sleepLock);
+    }
+    sleepCond.notify_one();
+}
+
+bool ThreadPool::takeFromQueue(std::deque<QueuedTask> &tasks,const Group *group,bool newest,QueuedTask &task)
+{
+    if (tasks.empty())
+    {
+        return false;
+    }
+    if (!group)
+    {
+        if (newest)
+        {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        return true;
+    }
+
+    const int num = (int)tasks.size();
+    for (int ii = 0; ii < num; ii++)
+    {
+        const auto it = tasks.begin() + (newest ? num - 1 - ii : ii);
+        if (it->group == group)
+        {
+            task = std::move(*it);
+            tasks.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTask(int which,const Group *group,QueuedTask &task)
+{
+    const int numWorkers = (int)workers.size();
+
+    // Newest from our own queue, it's most likely to be warm
+    if (which >= 0)
+    {
+        auto &worker = *workers[which];
+        std::lock_guard<std::mutex> guardLock(worker.lock);
+        if (takeFromQueue(worker.tasks, group, true, task))
+        {
+            return true;
+        }
+    }
+
+    // Oldest from everyone else's
+    const int start = (which >= 0) ? which + 1 : (int)(nextWorker.load(std::memory_order_relaxed) % numWorkers);
+    for (int ii = 0; ii < numWorkers; ii++)
+    {
+        const int victim = (start + ii) % numWorkers;
+        if (victim == which)
+        {
+            continue;
+        }
+        auto &worker = *workers[victim];
+        std::lock_guard<std::mutex> guardLock(worker.lock);
+        if (takeFromQueue(worker.tasks, group, false, task))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::runOne(int which,const Group *group)
+{
+    if ((group ? group->queued : numQueued).load(std::memory_order_acquire) <= 0)
+    {
+        return false;
+    }
+
+    QueuedTask task;
+    if (!takeTask(which, group, task))
+    {
+        return false;
+    }
+    numQueued.fetch_sub(1, std::memory_order_relaxed);
+    task.group->queued.fetch_sub(1, std::memory_order_relaxed);
+
+    try
+    {
+        task.task();
+    }
+    catch (const std::exception &ex)
+    {
+        wkLogLevel(Error, "ThreadPool: Exception in task: %s", ex.what());
+    }
+    catch (...)
+    {
+        wkLogLevel(Error, "ThreadPool: Exception in task");
+    }
+
+    if (task.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Wake up anyone waiting on the group
+        {
+            std::lock_guard<std::mutex> guardLock(sleepLock);
+        }
+        sleepCond.notify_all();
+    }
+
+    return true;
+}
+
+void ThreadPool::workerMain(int which)
+{
+    currentPool = this;
+    currentWorker = which;
+
+    while (true)
+    {
+        if (runOne(which, nullptr))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+        sleepCond.wait(lock, [this]{ return shutdown || numQueued.load(std::memory_order_acquire) > 0; });
+        if (shutdown && numQueued.load(std::memory_order_acquire) <= 0)
+        {
+            break;
+        }
+    }
+
+    currentPool = nullptr;
+    currentWorker = -1;
+}
+
+void ThreadPool::wait(Group &group)
+{
+    const int which = workerIndex();
+    while (group.pending.load(std::memory_order_acquire) > 0)
+    {
+        // Help out with our own group rather than sitting idle.
+        // Other groups' tasks could take much longer than we're willing to wait.
+        if (runOne(which, &group))
+        {
+            continue;
+        }
+
+        // Whatever's left is running on other threads
+        std::unique_lock<std::mutex> lock(sleepLock);
+        sleepCond.wait_for(lock, std::chrono::milliseconds(1), [&group]{
+            return group.pending.load(std::memory_order_acquire) <= 0 ||
+                   group.queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void ThreadPool::parallelFor(int begin,int end,int minChunk,const std::function<void(int)> &func)
+{
+    const int num = end - begin;
+    if (num <= 0)
+    {
+        return;
+    }
+
+    // A few chunks per thread evens out the load
+    const int numChunks = std::max(1, std::min(num / std::max(minChunk, 1), getNumThreads() * 4));
+    if (numChunks == 1)
+    {
+        for (int ii = begin; ii < end; ii++)
+        {
+            func(ii);
+        }
+        return;
+    }
+
+    Group group;
+    for (int chunk = 0; chunk < numChunks; chunk++)
+    {
+        const int chunkBegin = begin + (int)((int64_t)num * chunk / numChunks);
+        const int chunkEnd = begin + (int)((int64_t)num * (chunk + 1) / numChunks);
+        run(group, [chunkBegin,chunkEnd,&func]{
+            for (int ii = chunkBegin; ii < chunkEnd; ii++)
+            {
+                func(ii);
+            }
+        });
+    }
+    wait(group);
+}
+
+ThreadPoolRef ThreadPool::sharedPool(int numThreads)
+{
+    static std::mutex poolsLock;
+    static std::map<int,std::weak_ptr<ThreadPool>> pools;
+
+    numThreads = std::max(numThreads, 1);
+
+    std::lock_guard<std::mutex> guardLock(poolsLock);
+    auto &entry = pools[numThreads];
+    ThreadPoolRef pool = entry.lock();
+    if (!pool)
+    {
+        pool = std::make_shared<ThreadPool>(numThreads);
+        entry = pool;
+    }
+    return pool;
+}
+
+}
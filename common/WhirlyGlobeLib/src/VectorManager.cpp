@@ -151,13 +151,14 @@ public:
         
         // Decide if we'll appending to an existing drawable or create a new one
         const int ptCount = (int)(2*(pts.size()+1));
-        if (!drawable || (drawable->getNumPoints()+ptCount > MaxDrawablePoints))
+        if (!drawable || (drawable->getNumPoints()+ptCount > drawable->getMaxPoints()))
         {
             // We're done with it, toss it to the scene
             if (drawable)
                 flush();
             
             drawable = sceneRender->makeBasicDrawableBuilder(vecBuilderName);
+            drawable->setIndexPolicy(DrawableIndexAuto);
             drawMbr.reset();
             drawable->setType(primType);
             vecInfo->setupBasicDrawable(drawable);
@@ -414,14 +415,15 @@ public:
 
             // Decide if we'll appending to an existing drawable or create a new one
             if (!drawable ||
-                (drawable->getNumPoints()+ptCount > MaxDrawablePoints) ||
-                (drawable->getNumTris()+triCount > MaxDrawableTriangles))
+                (drawable->getNumPoints()+ptCount > drawable->getMaxPoints()) ||
+                (drawable->getNumTris()+triCount > drawable->getMaxTriangles()))
             {
                 // We're done with it, toss it to the scene
                 if (drawable)
                     flush();
                 
                 drawable = sceneRender->makeBasicDrawableBuilder(vecBuilderName);
+                drawable->setIndexPolicy(DrawableIndexAuto);
                 drawMbr.reset();
                 drawable->setType(Triangles);
                 vecInfo->setupBasicDrawable(drawable);
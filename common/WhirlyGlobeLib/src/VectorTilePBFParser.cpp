@@ -54,10 +54,10 @@ const vector_tile_Tile_Layer VectorTilePBFParser::_defaultLayer = {
 const vector_tile_Tile_Feature VectorTilePBFParser::_defaultFeature = {
     /* has_id   */ false,
     /* id       */ 0LL,
-    /* tags     */ { &VectorTilePBFParser::intVecDecode, nullptr },
+    /* tags     */ { &VectorTilePBFParser::packedIntsDecode, nullptr },
     /* has_type */ false,
     /* type     */ vector_tile_Tile_GeomType_UNKNOWN,
-    /* geometry */ { &VectorTilePBFParser::intVecDecode, nullptr },
+    /* geometry */ { &VectorTilePBFParser::packedIntsDecode, nullptr },
 };
 
 const vector_tile_Tile_Value VectorTilePBFParser::_defaultValue = {
@@ -116,6 +116,10 @@ bool VectorTilePBFParser::parse(const uint8_t* data, size_t length)
         /*extensions */ nullptr,
     };
 
+    // Packed fields within this range can be decoded later, in place
+    _tileBegin = data;
+    _tileEnd = data + length;
+
     auto stream = pb_istream_from_buffer(data, length);
     if (!pb_decode(&stream, vector_tile_Tile_fields, &tile))
     {
@@ -153,12 +157,12 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
     _layerKeys.reserve(layerKeyHeuristic(layerBytes));
     _layerValues.clear();
     _layerValues.reserve(layerValueHeuristic(layerBytes));
+    // These only fill up if the encoder didn't pack tags or geometry
     _featureTags.clear();
-    _featureTags.reserve(featureTagHeuristic(layerBytes));
     _featureGeometry.clear();
-    _featureGeometry.reserve(featureGeometryHeuristic(layerBytes));
     _features.clear();
     _features.reserve(featureHeuristic(layerBytes));
+    _layerTable = LayerTable();
 
     if (!pb_decode(stream, vector_tile_Tile_Layer_fields, &layer))
     {
@@ -202,8 +206,7 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
         return true;
     }
 
-    size_t prevTagIndex = 0;
-    size_t prevGeomIndex = 0;
+    FeatureAttributes featureAttrs(*this);
     for (auto const &feature : _features)
     {
         if (_checkCancelled(_styleInst))
@@ -212,32 +215,49 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
             return false;
         }
 
-        auto attributes = std::make_shared<MutableDictionaryC>();
-        attributes->setString(layerNameKey, layerName);
-        attributes->setInt(geometryTypeKey, (int)feature.geomType);
-        attributes->setInt(layerOrderKey, (int)_layerCount);
-
-        const bool tagsOk = processTags(attributes, prevTagIndex, prevGeomIndex, feature);
-        //const auto curTagIndex = prevTagIndex;
-        const auto curGeomIndex = prevGeomIndex;
-        const auto curGeomCount = feature.geomIndex - prevGeomIndex;
-        prevTagIndex = feature.tagIndex;
-        prevGeomIndex = feature.geomIndex;
-        
-        if (!tagsOk)
+        const uint32_t *tags = nullptr;
+        size_t tagCount = 0;
+        if (!unpackInts(feature.tags, _featureTags, _tagScratch, tags, tagCount))
         {
+            _parseErrors += 1;
             _skippedFeatureCount += 1;
             continue;
         }
 
         SimpleIDUSet styleIDs(featureStyleHeuristic());
-        if (!checkStyles(styleIDs, attributes, layerName))
+        if (_zeroCopy)
+        {
+            // Let the styles pick through the tile data before we copy anything out
+            featureAttrs.reset(layerName, feature.geomType, (int)_layerCount, tags, tagCount);
+            if (!checkStyles(styleIDs, featureAttrs, layerName))
+            {
+                _skippedFeatureCount += 1;
+                continue;
+            }
+        }
+
+        if (!_layerTable.table)
+        {
+            startLayerTable(layerName);
+        }
+        const auto attributes = processTags(feature.geomType, tags, tagCount);
+
+        if (!_zeroCopy && !checkStyles(styleIDs, *attributes, layerName))
         {
             // Skip this feature
             _skippedFeatureCount += 1;
             continue;
         }
 
+        const uint32_t *geometry = nullptr;
+        size_t geomCount = 0;
+        if (!unpackInts(feature.geom, _featureGeometry, _geomScratch, geometry, geomCount))
+        {
+            _parseErrors += 1;
+            _skippedFeatureCount += 1;
+            continue;
+        }
+
         _featureCount += 1;
 
         auto vecObj = std::make_shared<VectorObject>();
@@ -248,12 +268,12 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
             switch (feature.geomType)
             {
                 case GeomTypeLineString:
-                    parseLineString(&_featureGeometry[curGeomIndex], curGeomCount, vecObj->shapes);
+                    parseLineString(geometry, geomCount, vecObj->shapes);
                     break;
                 case GeomTypePolygon:
                 {
                     auto shape = VectorAreal::createAreal();
-                    if (parsePolygon(&_featureGeometry[curGeomIndex], curGeomCount, *shape))
+                    if (parsePolygon(geometry, geomCount, *shape))
                     {
                         vecObj->shapes.insert(shape);
                     }
@@ -262,7 +282,7 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
                 case GeomTypePoint:
                 {
                     auto shape = VectorPoints::createPoints();
-                    if (parsePoints(&_featureGeometry[curGeomIndex], curGeomCount, *shape))
+                    if (parsePoints(geometry, geomCount, *shape))
                     {
                         vecObj->shapes.insert(shape);
                     }
@@ -323,9 +343,14 @@ bool VectorTilePBFParser::featureDecode(pb_istream_t *stream, const pb_field_ite
 
 bool VectorTilePBFParser::featureDecode(pb_istream_t *stream, const pb_field_iter_t *field)
 {
+    PackedIntsArg tags { PackedInts(), &_featureTags, _tileBegin, _tileEnd };
+    PackedIntsArg geom { PackedInts(), &_featureGeometry, _tileBegin, _tileEnd };
+    tags.ints.start = tags.ints.end = (uint32_t)_featureTags.size();
+    geom.ints.start = geom.ints.end = (uint32_t)_featureGeometry.size();
+
     auto feature = _defaultFeature;
-    feature.tags.arg = &_featureTags;
-    feature.geometry.arg = &_featureGeometry;
+    feature.tags.arg = &tags;
+    feature.geometry.arg = &geom;
 
     if (!pb_decode(stream, vector_tile_Tile_Feature_fields, &feature))
     {
@@ -333,23 +358,142 @@ bool VectorTilePBFParser::featureDecode(pb_istream_t *stream, const pb_field_ite
     }
 
     const auto geomType = static_cast<MapnikGeometryType>(feature.type);
-    _features.emplace_back(_featureTags.size(),_featureGeometry.size(),geomType);
+    _features.emplace_back(tags.ints,geom.ints,geomType);
+
+    return true;
+}
+
+bool VectorTilePBFParser::unpackInts(const PackedInts &ints, const std::vector<uint32_t> &unpacked,
+                                     std::vector<uint32_t> &scratch, const uint32_t *&values, size_t &count)
+{
+    if (!ints.packed)
+    {
+        values = unpacked.data() + ints.start;
+        count = ints.end - ints.start;
+        return true;
+    }
 
+    scratch.clear();
+    auto stream = pb_istream_from_buffer(ints.packed, ints.packedBytes);
+    while (stream.bytes_left)
+    {
+        uint64_t value;
+        if (!pb_decode_varint(&stream, &value))
+        {
+            return false;
+        }
+        scratch.push_back((uint32_t)value);
+    }
+    values = scratch.data();
+    count = scratch.size();
     return true;
 }
 
-bool VectorTilePBFParser::processTags(const MutableDictionaryCRef &attributes, size_t tagIdx, size_t geomIdx, const Feature &feature)
+void VectorTilePBFParser::startLayerTable(const std::string &layerName)
+{
+    auto &table = *(_layerTable.table = std::make_shared<InternedDictionaryTable>());
+    _layerTable.keys.assign(_layerKeys.size(), -1);
+    _layerTable.values.assign(_layerValues.size(), -1);
+    _layerTable.geomTypes.clear();
+
+    // Every feature gets these
+    _layerTable.layerNameKey = table.addKey(layerNameKey);
+    _layerTable.geometryTypeKey = table.addKey(geometryTypeKey);
+    _layerTable.layerOrderKey = table.addKey(layerOrderKey);
+    _layerTable.layerNameValue = table.addString(layerName);
+    _layerTable.layerOrderValue = table.addInt((int)_layerCount);
+}
+
+uint32_t VectorTilePBFParser::tableKey(uint32_t keyIndex)
+{
+    auto &key = _layerTable.keys[keyIndex];
+    if (key < 0)
+    {
+        key = (int)_layerTable.table->addKey(_layerKeys[keyIndex]);
+    }
+    return (uint32_t)key;
+}
+
+int VectorTilePBFParser::tableValue(uint32_t valueIndex)
+{
+    auto &tableVal = _layerTable.values[valueIndex];
+    if (tableVal < 0)
+    {
+        auto &table = *_layerTable.table;
+        const auto &value = _layerValues[valueIndex];
+        switch (value.type) {
+            case SmallValue::SmallValString: tableVal = (int)table.addString(value.stringValue); break;
+            case SmallValue::SmallValFloat:  tableVal = (int)table.addDouble(value.floatValue); break;
+            case SmallValue::SmallValDouble: tableVal = (int)table.addDouble(value.doubleValue); break;
+            case SmallValue::SmallValInt:    tableVal = (int)table.addInt((int)value.intValue); break;
+            case SmallValue::SmallValUInt:   tableVal = (int)table.addInt((int)value.uintValue); break;
+            case SmallValue::SmallValSInt:   tableVal = (int)table.addInt((int)value.sintValue); break;
+            case SmallValue::SmallValBool:   tableVal = (int)table.addInt((int)value.boolValue); break;
+            default:
+            case SmallValue::SmallValNone:
+                break;
+        }
+    }
+    return tableVal;
+}
+
+uint32_t VectorTilePBFParser::tableGeomType(MapnikGeometryType geomType)
+{
+    for (const auto &entry : _layerTable.geomTypes)
+    {
+        if (entry.first == geomType)
+        {
+            return entry.second;
+        }
+    }
+    const auto val = _layerTable.table->addInt((int)geomType);
+    _layerTable.geomTypes.emplace_back(geomType, val);
+    return val;
+}
+
+InternedDictionaryCRef VectorTilePBFParser::processTags(MapnikGeometryType geomType, const uint32_t *tags, size_t tagCount)
 {
-    const auto tagCount = feature.tagIndex - tagIdx;
     if (tagCount % 2 != 0)
     {
         wkLogLevel(Warn, "VectorTilePBFParser: Odd feature tags!");
     }
 
-    for (size_t m = tagIdx; m + 1 < feature.tagIndex; m += 2)
+    const auto &table = *_layerTable.table;
+
+    std::vector<InternedDictionaryC::Field> fields;
+    fields.reserve(3 + tagCount / 2);
+
+    // Follow the same rules as setting the values on a MutableDictionaryC in order.
+    // Strings always replace, other values replace the same type and remove a different one.
+    const auto setField = [&](uint32_t key, uint32_t value)
     {
-        const auto keyIndex = _featureTags[m];
-        const auto valueIndex = _featureTags[m + 1];
+        for (auto it = fields.begin(); it != fields.end(); ++it)
+        {
+            if (it->key == key)
+            {
+                const auto newType = table.getValueType(value);
+                if (newType == DictTypeString || newType == table.getValueType(it->value))
+                {
+                    it->value = value;
+                }
+                else
+                {
+                    fields.erase(it);
+                }
+                return;
+            }
+        }
+        fields.push_back(InternedDictionaryC::Field { key, value });
+    };
+
+    setField(_layerTable.layerNameKey, _layerTable.layerNameValue);
+    setField(_layerTable.geometryTypeKey, tableGeomType(geomType));
+    setField(_layerTable.layerOrderKey, _layerTable.layerOrderValue);
+
+    for (size_t m = 0; m + 1 < tagCount; m += 2)
+    {
+        const auto keyIndex = tags[m];
+        const auto valueIndex = tags[m + 1];
 
         if (keyIndex >= _layerKeys.size() || valueIndex >= _layerValues.size()) {
             wkLogLevel(Warn, "VectorTilePBFParser: Invalid feature tag %d/%d (%d/%d)", keyIndex, valueIndex, (int)_layerKeys.size(), (int)_layerValues.size());
@@ -357,35 +501,25 @@ bool VectorTilePBFParser::processTags(const MutableDictionaryCRef &attributes, s
             continue;
         }
 
-        const auto &key = _layerKeys[keyIndex];
-        if (key.empty()) {
+        if (_layerKeys[keyIndex].empty()) {
             continue;
         }
 
-        // TODO: We don't really need transient string allocations here
-        const auto skey = std::string(key);
-
-        const auto &value = _layerValues[valueIndex];
-        switch (value.type) {
-            case SmallValue::SmallValString: attributes->setString(skey, std::string(value.stringValue)); break;
-            case SmallValue::SmallValFloat:  attributes->setDouble(skey, value.floatValue); break;
-            case SmallValue::SmallValDouble: attributes->setDouble(skey, value.doubleValue); break;
-            case SmallValue::SmallValInt:    attributes->setInt(skey, value.intValue); break;
-            case SmallValue::SmallValUInt:   attributes->setInt(skey, (int)value.uintValue); break;
-            case SmallValue::SmallValSInt:   attributes->setInt(skey, (int)value.sintValue); break;
-            case SmallValue::SmallValBool:   attributes->setInt(skey, (int)value.boolValue); break;
-            default:
-            case SmallValue::SmallValNone:
-                _unknownValueTypes += 1;
-                wkLogLevel(Warn, "VectorTilePBFParser: Invalid Value Type %d", value.type);
-                break;
+        const int value = tableValue(valueIndex);
+        if (value < 0)
+        {
+            _unknownValueTypes += 1;
+            wkLogLevel(Warn, "VectorTilePBFParser: Invalid Value Type %d", _layerValues[valueIndex].type);
+            continue;
         }
+
+        setField(tableKey(keyIndex), (uint32_t)value);
     }
-    
-    return true;
+
+    return std::make_shared<InternedDictionaryC>(_layerTable.table, std::move(fields));
 }
 
-bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDictionaryCRef &attributes, const std::string &layerName)
+bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const Dictionary &attributes, const std::string &layerName)
 {
     // Ask for the styles that correspond to this feature
     // If there are none, we can skip this.
@@ -393,7 +527,7 @@ bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDicti
     // Do a quick inclusion check
     if (!_uuidName.empty())
     {
-        std::string uuidVal = attributes->getString(_uuidName); // TODO: extra string copy
+        std::string uuidVal = attributes.getString(_uuidName); // TODO: extra string copy
         if (_uuidValues.find(uuidVal) == _uuidValues.end())
         {
             // Skip this feature
@@ -402,7 +536,7 @@ bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDicti
     }
     
     // TODO: populate a reused vector?
-    const auto styles = _styleDelegate->stylesForFeature(_styleInst, *attributes, _tileData->ident, layerName);
+    const auto styles = _styleDelegate->stylesForFeature(_styleInst, attributes, _tileData->ident, layerName);
     for (const auto &style : styles)
     {
         styleIDs.insert(style->getUuid(_styleInst));
@@ -725,5 +859,223 @@ bool VectorTilePBFParser::intVecDecode(pb_istream_t *stream, const pb_field_iter
     return true;
 }
 
+// Record where a repeated-integer lives in the tile so we can decode it later
+bool VectorTilePBFParser::packedIntsDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg)
+{
+    auto &info = **(PackedIntsArg**)arg;
+    auto &ints = info.ints;
+
+    // Unpacked values show up one at a time in a temporary buffer, so only
+    // a single packed run within the tile itself can be left where it is.
+    const auto *data = (const uint8_t*)stream->state;
+    if (!ints.packed && ints.start == ints.end &&
+        data >= info.tileBegin && data + stream->bytes_left <= info.tileEnd)
+    {
+        ints.packed = data;
+        ints.packedBytes = (uint32_t)stream->bytes_left;
+        return pb_read(stream, nullptr, stream->bytes_left);
+    }
+
+    // Otherwise decode everything we have so far into the fallback vector.
+    // Nothing else adds to it while a feature is being decoded, so the range stays contiguous.
+    if (ints.packed)
+    {
+        auto packedStream = pb_istream_from_buffer(ints.packed, ints.packedBytes);
+        void *vecArg = info.unpacked;
+        if (!intVecDecode(&packedStream, field, &vecArg))
+        {
+            return false;
+        }
+        ints.packed = nullptr;
+        ints.packedBytes = 0;
+    }
+
+    void *vecArg = info.unpacked;
+    if (!intVecDecode(stream, field, &vecArg))
+    {
+        return false;
+    }
+    ints.end = (uint32_t)info.unpacked->size();
+    return true;
+}
+
+void VectorTilePBFParser::FeatureAttributes::reset(const std::string &inLayerName, MapnikGeometryType inGeomType,
+                                                   int inLayerOrder, const uint32_t *inTags, size_t inNumTags)
+{
+    layerName = &inLayerName;
+    geomType = inGeomType;
+    layerOrder = inLayerOrder;
+    tags = inTags;
+    numTags = inNumTags;
+}
+
+DictionaryValueC VectorTilePBFParser::FeatureAttributes::find(const std::string &name) const
+{
+    DictionaryValueC entry;
+    if (name.empty())
+    {
+        return entry;
+    }
+
+    // The built-in values go in first
+    if (name == layerNameKey)
+    {
+        entry.type = DictTypeString;
+        entry.stringVal = *layerName;
+    }
+    else if (name == geometryTypeKey)
+    {
+        entry.type = DictTypeInt;
+        entry.intVal = (int)geomType;
+    }
+    else if (name == layerOrderKey)
+    {
+        entry.type = DictTypeInt;
+        entry.intVal = layerOrder;
+    }
+
+    // Then the tags, in order, following the dictionary's rules for setting an existing key
+    for (size_t m = 0; m + 1 < numTags; m += 2)
+    {
+        const auto keyIndex = tags[m];
+        const auto valueIndex = tags[m + 1];
+        if (keyIndex >= parser._layerKeys.size() || valueIndex >= parser._layerValues.size() ||
+            parser._layerKeys[keyIndex] != name)
+        {
+            continue;
+        }
+
+        DictionaryValueC tagEntry;
+        const auto &value = parser._layerValues[valueIndex];
+        switch (value.type)
+        {
+            case SmallValue::SmallValString: tagEntry.type = DictTypeString; tagEntry.stringVal = value.stringValue; break;
+            case SmallValue::SmallValFloat:  tagEntry.type = DictTypeDouble; tagEntry.doubleVal = value.floatValue; break;
+            case SmallValue::SmallValDouble: tagEntry.type = DictTypeDouble; tagEntry.doubleVal = value.doubleValue; break;
+            case SmallValue::SmallValInt:    tagEntry.type = DictTypeInt;    tagEntry.intVal = (int)value.intValue; break;
+            case SmallValue::SmallValUInt:   tagEntry.type = DictTypeInt;    tagEntry.intVal = (int)value.uintValue; break;
+            case SmallValue::SmallValSInt:   tagEntry.type = DictTypeInt;    tagEntry.intVal = (int)value.sintValue; break;
+            case SmallValue::SmallValBool:   tagEntry.type = DictTypeInt;    tagEntry.intVal = (int)value.boolValue; break;
+            default:
+            case SmallValue::SmallValNone:
+                // Never set
+                continue;
+        }
+
+        // Strings always replace, other values replace the same type and remove a different one
+        if (tagEntry.type == DictTypeString || entry.type == DictTypeNone || entry.type == tagEntry.type)
+        {
+            entry = tagEntry;
+        }
+        else
+        {
+            entry = DictionaryValueC();
+        }
+    }
+
+    return entry;
+}
+
+int VectorTilePBFParser::FeatureAttributes::count() const
+{
+    return (int)getKeys().size();
+}
+
+bool VectorTilePBFParser::FeatureAttributes::hasField(const std::string &name) const
+{
+    return find(name).type != DictTypeNone;
+}
+
+DictionaryType VectorTilePBFParser::FeatureAttributes::getType(const std::string &name) const
+{
+    return find(name).type;
+}
+
+int VectorTilePBFParser::FeatureAttributes::getInt(const std::string &name,int defVal) const
+{
+    return find(name).getInt(defVal);
+}
+
+int64_t VectorTilePBFParser::FeatureAttributes::getInt64(const std::string &name,int64_t defVal) const
+{
+    return find(name).getInt64(defVal);
+}
+
+SimpleIdentity VectorTilePBFParser::FeatureAttributes::getIdentity(const std::string &name) const
+{
+    return find(name).getIdentity();
+}
+
+bool VectorTilePBFParser::FeatureAttributes::getBool(const std::string &name,bool defVal) const
+{
+    return find(name).getBool(defVal);
+}
+
+RGBAColor VectorTilePBFParser::FeatureAttributes::getColor(const std::string &name,const RGBAColor &defVal) const
+{
+    return find(name).getColor(defVal);
+}
+
+double VectorTilePBFParser::FeatureAttributes::getDouble(const std::string &name,double defVal) const
+{
+    return find(name).getDouble(defVal);
+}
+
+std::string VectorTilePBFParser::FeatureAttributes::getString(const std::string &name) const
+{
+    return getString(name, std::string());
+}
+
+std::string VectorTilePBFParser::FeatureAttributes::getString(const std::string &name,const std::string &defVal) const
+{
+    return find(name).getString(defVal);
+}
+
+DictionaryRef VectorTilePBFParser::FeatureAttributes::getDict(const std::string &name) const
+{
+    // Tiles don't have nested dictionaries
+    return DictionaryRef();
+}
+
+DictionaryEntryRef VectorTilePBFParser::FeatureAttributes::getEntry(const std::string &name) const
+{
+    return find(name).getEntry();
+}
+
+std::vector<DictionaryEntryRef> VectorTilePBFParser::FeatureAttributes::getArray(const std::string &name) const
+{
+    // Or arrays
+    return std::vector<DictionaryEntryRef>();
+}
+
+std::vector<std::string> VectorTilePBFParser::FeatureAttributes::getKeys() const
+{
+    std::vector<std::string> names { layerNameKey, geometryTypeKey, layerOrderKey };
+    for (size_t m = 0; m + 1 < numTags; m += 2)
+    {
+        const auto keyIndex = tags[m];
+        if (keyIndex < parser._layerKeys.size())
+        {
+            const auto &key = parser._layerKeys[keyIndex];
+            if (std::find(names.begin(), names.end(), key) == names.end())
+            {
+                names.emplace_back(key);
+            }
+        }
+    }
+
+    // Some of them may not have ended up with a value
+    std::vector<std::string> keys;
+    keys.reserve(names.size());
+    for (auto &name : names)
+    {
+        if (find(name).type != DictTypeNone)
+        {
+            keys.push_back(std::move(name));
+        }
+    }
+    return keys;
+}
+
 }   // namespace WhirlyKit
 
@@ -51,6 +51,8 @@ void WideVectorDrawableBuilder::Init(unsigned int numVert,
     basicDrawable->Init();
     basicDrawable->setupStandardAttributes();
     basicDrawable->setType(Triangles);
+    // Let big batches of wide vectors go past 64k vertices
+    basicDrawable->setIndexPolicy(DrawableIndexAuto);
     if (numVert > 0)
     {
         basicDrawable->points.reserve(numVert);
@@ -253,6 +255,16 @@ unsigned int WideVectorDrawableBuilder::getNumTris()
     return basicDrawable->getNumTris();
 }
 
+unsigned int WideVectorDrawableBuilder::getMaxPoints()
+{
+    return basicDrawable->getMaxPoints();
+}
+
+unsigned int WideVectorDrawableBuilder::getMaxTriangles()
+{
+    return basicDrawable->getMaxTriangles();
+}
+
 int WideVectorDrawableBuilder::getCenterLineCount()
 {
     return centerline.size();
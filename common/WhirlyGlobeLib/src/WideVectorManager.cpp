@@ -703,18 +703,20 @@ struct WideVectorDrawableConstructor
             }
         } else {
             // Basic mode builds up a lot more geometry
-            int ptGuess = std::min(std::max(ptCount,0),(int)MaxDrawablePoints);
-            int triGuess = std::min(std::max(triCount,0),(int)MaxDrawableTriangles);
+            const int maxPoints = (int)MaxDrawablePointsForPolicy(DrawableIndexAuto);
+            const int maxTris = (int)MaxDrawableTrianglesForPolicy(DrawableIndexAuto);
+            int ptGuess = std::min(std::max(ptCount,0),maxPoints);
+            int triGuess = std::min(std::max(triCount,0),maxTris);
 
             if (!drawable ||
-                (drawable->getNumPoints()+ptGuess > MaxDrawablePoints) ||
-                (drawable->getNumTris()+triGuess > MaxDrawableTriangles))
+                (drawable->getNumPoints()+ptGuess > drawable->getMaxPoints()) ||
+                (drawable->getNumTris()+triGuess > drawable->getMaxTriangles()))
             {
                 flush();
                 
     //            NSLog(@"Pts = %d, tris = %d",ptGuess,triGuess);
-                int ptAlloc = std::min(std::max(ptCountAllocate,0),(int)MaxDrawablePoints);
-                int triAlloc = std::min(std::max(triCountAllocate,0),(int)MaxDrawableTriangles);
+                int ptAlloc = std::min(std::max(ptCountAllocate,0),maxPoints);
+                int triAlloc = std::min(std::max(triCountAllocate,0),maxTris);
                 WideVectorDrawableBuilderRef wideDrawable = sceneRender->makeWideVectorDrawableBuilder("Wide Vector");
                 wideDrawable->Init(ptAlloc,triAlloc,0,
                                    vecInfo->implType,
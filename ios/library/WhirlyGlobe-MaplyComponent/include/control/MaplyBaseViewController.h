@@ -43,6 +43,13 @@
 typedef double (^ZoomEasingBlock)(double z0,double z1,double t);
 typedef void (__strong ^InitCompletionBlock)(void);
 
+/// How the layout engine finds objects that might overlap.
+/// The tree is faster for dense or very large sets of labels and markers.
+typedef NS_ENUM(NSInteger, MaplyLayoutOverlapIndex) {
+    MaplyLayoutOverlapGrid,
+    MaplyLayoutOverlapTree,
+};
+
 /** 
     When selecting multiple objects, one or more of these is returned.
     
@@ -159,6 +166,25 @@ typedef void (__strong ^InitCompletionBlock)(void);
  */
 @property (nonatomic,assign) bool layoutFade;
 
+/**
+    Keep the layout order and previous placements between layout passes.
+
+    Objects that haven't moved much on screen try their last spot first, which is much cheaper with lots of labels and markers.  Off by default.
+ */
+@property (nonatomic,assign) bool layoutIncremental;
+
+/**
+    How the layout engine finds objects that might overlap.  MaplyLayoutOverlapGrid by default.
+ */
+@property (nonatomic,assign) MaplyLayoutOverlapIndex layoutOverlapIndex;
+
+/**
+    Pre-cluster large cluster groups on a flat map with a per-zoom index.
+
+    Markers very close together go straight into a cluster rather than being checked one by one, which speeds up clustering with lots of markers.  Off by default.
+ */
+@property (nonatomic,assign) bool layoutClusterIndex;
+
 /**
     Controls the way height changes while animating the view
     For simple, linear zoom use:
@@ -1480,6 +1506,30 @@ typedef void (__strong ^InitCompletionBlock)(void);
  */
 - (NSArray * _Nullable)labelsAndMarkersAtCoord:(MaplyCoordinate)coord;
 
+/**
+    Return all the selectable labels and markers near each of a set of screen points.
+
+    This is the batch version of labelsAndMarkersAtCoord:, handy for multi-touch or hover.  The view is only set up once for the whole set.
+
+    @param screenPts An array of NSValues wrapping CGPoints in screen coordinates.
+
+    @return An array with one entry per point, each an array of MaplySelectedObject (possibly empty).
+
+    This is not thread safe and will block the main thread.
+ */
+- (NSArray<NSArray *> * _Nullable)labelsAndMarkersAtScreenPoints:(NSArray<NSValue *> * _Nonnull)screenPts;
+
+/**
+    Return all the selectable labels and markers within a polygon on the screen (a lasso, say).
+
+    Vector objects are not included.
+
+    @param region An array of NSValues wrapping CGPoints in screen coordinates, outlining the polygon.
+
+    This is not thread safe and will block the main thread.
+ */
+- (NSArray * _Nullable)labelsAndMarkersInScreenRegion:(NSArray<NSValue *> * _Nonnull)region;
+
 /// Turn on/off performance output (goes to the log periodically).
 @property (nonatomic,assign) bool performanceOutput;
 
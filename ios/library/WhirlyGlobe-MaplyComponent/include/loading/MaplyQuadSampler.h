@@ -79,6 +79,11 @@
 /// If set, we'll try to load a single level
 @property (nonatomic) bool singleLevel;
 
+/// Number of threads to evaluate tile importance on.
+/// Zero (the default) evaluates everything on the layer thread.
+/// Ignored if the coordinate system isn't thread safe.
+@property (nonatomic) int importanceThreads;
+
 /// If set, the tiles are clipped to this boundary
 @property (nonatomic) MaplyBoundingBoxD clipBounds;
 @property (nonatomic,readonly) bool hasClipBounds;
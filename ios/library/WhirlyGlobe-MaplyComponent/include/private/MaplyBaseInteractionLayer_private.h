@@ -210,6 +210,10 @@
 // Find MaplySelectableObjects at a screen point
 - (NSObject*__nullable)selectLabelsAndMarkerForScreenPoint:(CGPoint)screenPoint;
 - (NSMutableArray*__nullable)selectMultipleLabelsAndMarkersForScreenPoint:(CGPoint)screenPoint;
+// Same for a whole set of screen points, one array per point
+- (NSArray<NSMutableArray*>*__nullable)selectMultipleLabelsAndMarkersForScreenPoints:(const WhirlyKit::Point2fVector &)screenPts;
+// Find MaplySelectableObjects within a screen polygon
+- (NSMutableArray*__nullable)selectLabelsAndMarkersInScreenRegion:(const WhirlyKit::Point2fVector &)region;
 - (NSMutableArray*__nullable)convertSelectedObjects:(const std::vector<WhirlyKit::SelectionManager::SelectedObject> &)selectedObjs;
 - (NSMutableArray*__nullable)convertSelectedVecObjects:(NSArray<MaplyVectorObject *>*__nullable)vecObjs;
 
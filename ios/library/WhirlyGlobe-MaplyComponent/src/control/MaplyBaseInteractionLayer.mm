@@ -3668,6 +3668,32 @@ typedef std::set<GeomModelInstances *,struct GeomModelInstancesCmp> GeomModelIns
     return retSelectArr;
 }
 
+- (NSArray<NSMutableArray*>*)selectMultipleLabelsAndMarkersForScreenPoints:(const Point2fVector &)screenPts
+{
+    SelectionManagerRef selectManager = std::dynamic_pointer_cast<SelectionManager>(scene->getManager(kWKSelectionManager));
+    if (!selectManager)
+        return nil;
+    std::vector<std::vector<SelectionManager::SelectedObject>> selectedObjs;
+    selectManager->pickObjects(screenPts,10.0,visualView->makeViewState(layerThread.renderer),selectedObjs);
+
+    NSMutableArray *retArr = [NSMutableArray arrayWithCapacity:selectedObjs.size()];
+    for (const auto &ptObjs : selectedObjs)
+        [retArr addObject:[self convertSelectedObjects:ptObjs]];
+
+    return retArr;
+}
+
+- (NSMutableArray*)selectLabelsAndMarkersInScreenRegion:(const Point2fVector &)region
+{
+    SelectionManagerRef selectManager = std::dynamic_pointer_cast<SelectionManager>(scene->getManager(kWKSelectionManager));
+    if (!selectManager)
+        return nil;
+    std::vector<SelectionManager::SelectedObject> selectedObjs;
+    selectManager->pickObjectsInRegion(region,visualView->makeViewState(layerThread.renderer),selectedObjs);
+
+    return [self convertSelectedObjects:selectedObjs];
+}
+
 - (NSMutableArray*__nullable)convertSelectedObjects:(const std::vector<WhirlyKit::SelectionManager::SelectedObject> &)selectedObjs
 {
     NSMutableArray *retSelectArr = [NSMutableArray array];
@@ -115,12 +115,18 @@ using namespace WhirlyKit;
 {
     MaplyLocationTracker *_locationTracker;
     bool _layoutFade;
+    bool _layoutIncremental;
+    MaplyLayoutOverlapIndex _layoutOverlapIndex;
+    bool _layoutClusterIndex;
     NSMutableArray<InitCompletionBlock> *_postInitCalls;
 }
 
 - (instancetype)init{
     self = [super init];
     _layoutFade = false;
+    _layoutIncremental = false;
+    _layoutOverlapIndex = MaplyLayoutOverlapGrid;
+    _layoutClusterIndex = false;
     _postInitCalls = [NSMutableArray new];
     return self;
 }
@@ -211,6 +217,49 @@ using namespace WhirlyKit;
     return _layoutFade;
 }
 
+- (void)setLayoutIncremental:(bool)enable
+{
+    _layoutIncremental = enable;
+    if (auto rc = renderControl)
+    {
+        rc->layoutLayer.incrementalLayout = enable;
+    }
+}
+
+- (bool)layoutIncremental
+{
+    return _layoutIncremental;
+}
+
+- (void)setLayoutOverlapIndex:(MaplyLayoutOverlapIndex)index
+{
+    _layoutOverlapIndex = index;
+    if (auto rc = renderControl)
+    {
+        rc->layoutLayer.overlapIndex = (index == MaplyLayoutOverlapTree) ?
+                OverlapHelper::OverlapTreeIndex : OverlapHelper::OverlapGridIndex;
+    }
+}
+
+- (MaplyLayoutOverlapIndex)layoutOverlapIndex
+{
+    return _layoutOverlapIndex;
+}
+
+- (void)setLayoutClusterIndex:(bool)enable
+{
+    _layoutClusterIndex = enable;
+    if (auto rc = renderControl)
+    {
+        rc->layoutLayer.clusterIndex = enable;
+    }
+}
+
+- (bool)layoutClusterIndex
+{
+    return _layoutClusterIndex;
+}
+
 // Kick off the analytics logic.  First we need the server name.
 - (void)startAnalytics
 {
@@ -311,6 +360,9 @@ using namespace WhirlyKit;
 
     // Apply layout fade option set before init to the newly-created manager
     [self setLayoutFade:_layoutFade];
+    [self setLayoutIncremental:_layoutIncremental];
+    [self setLayoutOverlapIndex:_layoutOverlapIndex];
+    [self setLayoutClusterIndex:_layoutClusterIndex];
 
     // Set up defaults for the hints
     NSDictionary *newHints = [NSDictionary dictionary];
@@ -1232,6 +1284,36 @@ static const float PerfOutputDelay = 15.0;
     return [renderControl->interactLayer selectMultipleLabelsAndMarkersForScreenPoint:[self screenPointFromGeo:coord]];
 }
 
+static void ScreenPointsFromValues(NSArray<NSValue *> *vals,Point2fVector &pts)
+{
+    pts.reserve(vals.count);
+    for (NSValue *val in vals)
+    {
+        const CGPoint pt = [val CGPointValue];
+        pts.emplace_back(pt.x,pt.y);
+    }
+}
+
+- (NSArray<NSArray *> *)labelsAndMarkersAtScreenPoints:(NSArray<NSValue *> *)screenPts
+{
+    if (!renderControl)
+        return nil;
+
+    Point2fVector pts;
+    ScreenPointsFromValues(screenPts, pts);
+    return [renderControl->interactLayer selectMultipleLabelsAndMarkersForScreenPoints:pts];
+}
+
+- (NSArray *)labelsAndMarkersInScreenRegion:(NSArray<NSValue *> *)region
+{
+    if (!renderControl)
+        return nil;
+
+    Point2fVector pts;
+    ScreenPointsFromValues(region, pts);
+    return [renderControl->interactLayer selectLabelsAndMarkersInScreenRegion:pts];
+}
+
 #pragma mark - Properties
 
 - (UIColor *)clearColor
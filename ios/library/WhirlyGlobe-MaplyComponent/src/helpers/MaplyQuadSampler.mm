@@ -169,6 +169,16 @@ using namespace WhirlyKit;
     params.singleLevel = singleLevel;
 }
 
+- (int)importanceThreads
+{
+    return params.importanceThreads;
+}
+
+- (void)setImportanceThreads:(int)importanceThreads
+{
+    params.importanceThreads = std::max(importanceThreads, 0);
+}
+
 - (void)setForceMinLevel:(bool)forceMinLevel
 {
     params.forceMinLevel = forceMinLevel;
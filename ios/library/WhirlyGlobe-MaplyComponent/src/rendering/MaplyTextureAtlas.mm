@@ -110,6 +110,7 @@ typedef std::set<SubTexToAtlas> SubTexToAtlasSet;
         if (!foundAtlas)
         {
             foundAtlas = new DynamicTextureAtlas("Maply Texture Atlas",atlasSize,16,tex->getFormat());
+            foundAtlas->setLayout(DynamicTextureSkyline);
             atlases.insert(foundAtlas);
             if (foundAtlas->addTexture(sceneRender,texs, -1, NULL, NULL, subTex, changes, 0))
                 scene->addSubTexture(subTex);
@@ -55,6 +55,20 @@ static double MAX_EXTENT = 20037508.342789244;
 
 static int BackImageWidth = 16, BackImageHeight = 16;
 
+// The C++ styles are safe to build concurrently, so spread them over the cores.
+// The builds create plenty of autoreleased objects (fonts, strings, vector objects)
+//  and the pool threads never drain an autorelease pool of their own, so each build gets one.
+static void SetupBuildPool(const MapboxVectorTileParserRef &parser)
+{
+    const int numThreads = std::max(1, (int)[NSProcessInfo processInfo].activeProcessorCount - 1);
+    parser->setBuildPool(ThreadPool::sharedPool(numThreads), MapboxVectorTileParser::ThreadInfoFunction(),
+                         [](const std::function<void()> &buildFn) {
+        @autoreleasepool {
+            buildFn();
+        }
+    });
+}
+
 @implementation MapboxVectorInterpreter
 {
     NSObject<MaplyRenderControllerProtocol> * __weak viewC;
@@ -87,7 +101,8 @@ static int BackImageWidth = 16, BackImageHeight = 16;
     
     // Same for the vector, uh, vector styles
     NSObject<MaplyVectorStyleDelegateSecret> *testVecStyle = (NSObject<MaplyVectorStyleDelegateSecret> *)inVectorStyle;
-    if ([testVecStyle respondsToSelector:@selector(getVectorStyleImpl)]) {
+    const bool vecStyleImpl = [testVecStyle respondsToSelector:@selector(getVectorStyleImpl)];
+    if (vecStyleImpl) {
         vecStyle = [testVecStyle getVectorStyleImpl];
     } else
         vecStyle = std::make_shared<VectorStyleDelegateWrapper>(inViewC,inVectorStyle);
@@ -95,6 +110,8 @@ static int BackImageWidth = 16, BackImageHeight = 16;
     imageTileParser = std::make_shared<MapboxVectorTileParser>(nullptr,imageStyle);
     imageTileParser->setLocalCoords();
     vecTileParser = std::make_shared<MapboxVectorTileParser>(nullptr,vecStyle);
+    if (vecStyleImpl)
+        SetupBuildPool(vecTileParser);
     
     return self;
 }
@@ -107,12 +124,15 @@ static int BackImageWidth = 16, BackImageHeight = 16;
 
     // Same for the vector, uh, vector styles
     NSObject<MaplyVectorStyleDelegateSecret> *testVecStyle = (NSObject<MaplyVectorStyleDelegateSecret> *)inVectorStyle;
-    if ([testVecStyle respondsToSelector:@selector(getVectorStyleImpl)]) {
+    const bool vecStyleImpl = [testVecStyle respondsToSelector:@selector(getVectorStyleImpl)];
+    if (vecStyleImpl) {
         vecStyle = [testVecStyle getVectorStyleImpl];
     } else
         vecStyle = std::make_shared<VectorStyleDelegateWrapper>(inViewC,inVectorStyle);
 
     vecTileParser = std::make_shared<MapboxVectorTileParser>(nullptr,vecStyle);
+    if (vecStyleImpl)
+        SetupBuildPool(vecTileParser);
 
     return self;
 }
@@ -60,6 +60,9 @@ public:
     virtual void enumerateResources(RendererFrameInfoMTL *frameInfo,ResourceRefsMTL &resources) override;
     virtual void enumerateBuffers(ResourceRefsMTL &resources);
 
+    /// Index type for the triangle buffer
+    MTLIndexType mtlIndexType() const { return use32BitIndices ? MTLIndexTypeUInt32 : MTLIndexTypeUInt16; }
+
     /// Some drawables have a pre-render phase that uses the GPU for calculation
     virtual void encodeDirectCalculate(RendererFrameInfoMTL *frameInfo,id<MTLRenderCommandEncoder> cmdEncode,Scene *scene) override;
 
@@ -35,7 +35,7 @@ public:
     DynamicTextureMTL(const std::string &name);
     
     /// Called after construction to do the actual work
-    void setup(int texSize,int cellSize,TextureType format,bool clearTextures);
+    void setup(int texSize,int cellSize,TextureType format,bool clearTextures,DynamicTextureLayout layout=DynamicTextureGrid);
     
     /// Add the data at a given location in the texture
     void addTextureData(int startX,int startY,int width,int height,RawDataRef data);
@@ -37,6 +37,17 @@
 /// Zero by default, meaning all visible objects will be displayed (that can fit).
 @property (nonatomic,assign) int maxDisplayObjects;
 
+/// Keep the layout order and placements between passes rather than starting over.
+/// Off by default.
+@property (nonatomic,assign) bool incrementalLayout;
+
+/// How the layout finds objects that might overlap.  The grid is the default.
+@property (nonatomic,assign) WhirlyKit::OverlapHelper::IndexType overlapIndex;
+
+/// Pre-cluster large cluster groups on a flat map with a per-zoom index.
+/// Off by default.
+@property (nonatomic,assign) bool clusterIndex;
+
 /// Initialize with the renderer (for screen size)
 - (id)initWithRenderer:(WhirlyKit::SceneRenderer *)renderer;
 
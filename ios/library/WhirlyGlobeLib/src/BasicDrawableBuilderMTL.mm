@@ -99,6 +99,9 @@ BasicDrawableRef BasicDrawableBuilderMTL::getDrawable()
     BasicDrawableMTLRef draw = std::dynamic_pointer_cast<BasicDrawableMTL>(basicDraw);
     
     if (!drawableGotten) {
+        // Metal wants the attributes in their own buffers
+        unpackInterleaved();
+
         int ptsIndex = addAttribute(BDFloat3Type, a_PositionNameID);
         VertexAttributeMTL *ptsAttr = (VertexAttributeMTL *)basicDraw->vertexAttributes[ptsIndex];
         ptsAttr->slot = WhirlyKitShader::WKSVertexPositionAttribute;
@@ -106,6 +109,7 @@ BasicDrawableRef BasicDrawableBuilderMTL::getDrawable()
         for (auto pt : points)
             ptsAttr->addVector3f(pt);
         draw->tris = tris;
+        draw->use32BitIndices = needs32BitIndices();
         
         // Expression uniforms, if we have those
         if (colorExp || opacityExp || includeExp) {
@@ -610,7 +610,7 @@ void BasicDrawableInstanceMTL::encodeDirect(RendererFrameInfoMTL *frameInfo,id<M
                     // This actually draws the triangles (well, in a bit)
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset];
                     break;
@@ -630,7 +630,7 @@ void BasicDrawableInstanceMTL::encodeDirect(RendererFrameInfoMTL *frameInfo,id<M
                 case Triangles:
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                        instanceCount:numInst];
@@ -649,7 +649,7 @@ void BasicDrawableInstanceMTL::encodeDirect(RendererFrameInfoMTL *frameInfo,id<M
                     break;
                 case Triangles:
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                       indirectBuffer:indirectBuffer.buffer
@@ -673,7 +673,7 @@ void BasicDrawableInstanceMTL::encodeDirect(RendererFrameInfoMTL *frameInfo,id<M
                 case Triangles:
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                        instanceCount:instDrawMTL->calcDataEntries];
@@ -823,7 +823,7 @@ void BasicDrawableInstanceMTL::encodeIndirect(id<MTLIndirectRenderCommand> cmdEn
                     // This actually draws the triangles (well, in a bit)
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                        instanceCount:1
@@ -847,7 +847,7 @@ void BasicDrawableInstanceMTL::encodeIndirect(id<MTLIndirectRenderCommand> cmdEn
                 case Triangles:
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                        instanceCount:numInst
@@ -873,7 +873,7 @@ void BasicDrawableInstanceMTL::encodeIndirect(id<MTLIndirectRenderCommand> cmdEn
                 case Triangles:
                     [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                           indexCount:basicDrawMTL->numTris*3
-                                           indexType:MTLIndexTypeUInt16
+                                           indexType:basicDrawMTL->mtlIndexType()
                                          indexBuffer:basicDrawMTL->triBuffer.buffer
                                    indexBufferOffset:basicDrawMTL->triBuffer.offset
                                        instanceCount:instDrawMTL->calcDataEntries
@@ -81,9 +81,11 @@ void BasicDrawableMTL::setupForRenderer(const RenderSetupInfo *inSetupInfo,Scene
     // And put the triangles in their own
     // Note: Could use 1 byte some of the time
     numTris = tris.size();
-    const int bufferSize = 3*2*numTris;
+    const int bufferSize = 3*indexSize()*numTris;
     if (bufferSize > 0) {
-        buffBuild.addData(&tris[0], bufferSize, &triBuffer);
+        std::vector<unsigned char> indices(bufferSize);
+        CopyIndices(tris, use32BitIndices, &indices[0]);
+        buffBuild.addData(&indices[0], bufferSize, &triBuffer);
         tris.clear();
     }
     
@@ -709,7 +711,7 @@ void BasicDrawableMTL::encodeDirect(RendererFrameInfoMTL *frameInfo,id<MTLRender
                 return;
             }
             // This actually draws the triangles (well, in a bit)
-            [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle indexCount:numTris*3 indexType:MTLIndexTypeUInt16 indexBuffer:triBuffer.buffer indexBufferOffset:triBuffer.offset];
+            [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle indexCount:numTris*3 indexType:mtlIndexType() indexBuffer:triBuffer.buffer indexBufferOffset:triBuffer.offset];
             break;
         default:
             break;
@@ -830,7 +832,7 @@ void BasicDrawableMTL::encodeIndirect(id<MTLIndirectRenderCommand> cmdEncode,Sce
                 return;
             }
             // This actually draws the triangles (well, in a bit)
-            [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle indexCount:numTris*3 indexType:MTLIndexTypeUInt16 indexBuffer:triBuffer.buffer indexBufferOffset:triBuffer.offset instanceCount:1 baseVertex:0 baseInstance:0];
+            [cmdEncode drawIndexedPrimitives:MTLPrimitiveTypeTriangle indexCount:numTris*3 indexType:mtlIndexType() indexBuffer:triBuffer.buffer indexBufferOffset:triBuffer.offset instanceCount:1 baseVertex:0 baseInstance:0];
             break;
         default:
             break;
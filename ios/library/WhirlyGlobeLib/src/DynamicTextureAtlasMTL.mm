@@ -28,9 +28,9 @@ DynamicTextureMTL::DynamicTextureMTL(const std::string &name)
 {
 }
 
-void DynamicTextureMTL::setup(int texSize,int cellSize,TextureType inType,bool clearTextures)
+void DynamicTextureMTL::setup(int texSize,int cellSize,TextureType inType,bool clearTextures,DynamicTextureLayout layout)
 {
-    DynamicTexture::setup(texSize,cellSize,inType,clearTextures);
+    DynamicTexture::setup(texSize,cellSize,inType,clearTextures,layout);
     
     switch (inType)
     {
@@ -220,8 +220,42 @@ NSData *FontTextureManager_iOS::renderGlyph(CGGlyph glyph, const FontManager_iOS
 std::unique_ptr<DrawableString> FontTextureManager_iOS::addString(
         PlatformThreadInfo *, NSAttributedString *str, ChangeSet &changes)
 {
+    // If the whole string has the same attributes, the text and those are
+    //  enough to find a string we've done before
+    std::string cacheKey;
+    if (str.length > 0)
+    {
+        NSRange attrRange;
+        NSDictionary *attrs = [str attributesAtIndex:0 longestEffectiveRange:&attrRange inRange:NSMakeRange(0,str.length)];
+        UIFont *uiFont = attrs[NSFontAttributeName];
+        if (attrRange.length == str.length && [uiFont isKindOfClass:[UIFont class]])
+        {
+            NSNumber *outlineSize = attrs[kOutlineAttributeSize];
+            const RGBAColor colors[3] = {
+                [attrs[NSForegroundColorAttributeName] asRGBAColor],
+                [attrs[NSBackgroundColorAttributeName] asRGBAColor],
+                [attrs[kOutlineAttributeColor] asRGBAColor],
+            };
+            const float sizes[2] = { (float)uiFont.pointSize, [outlineSize floatValue] };
+
+            cacheKey = [str.string UTF8String] ?: "";
+            cacheKey.push_back('\0');
+            cacheKey.append([uiFont.fontName UTF8String] ?: "");
+            cacheKey.push_back('\0');
+            cacheKey.append((const char *)colors, sizeof(colors));
+            cacheKey.append((const char *)sizes, sizeof(sizes));
+
+            std::lock_guard<std::mutex> guardLock(lock);
+            if (auto cachedString = findCachedString(cacheKey))
+            {
+                return cachedString;
+            }
+        }
+    }
+
     auto drawString = std::make_unique<DrawableString>();
     auto drawStringRep = std::make_unique<DrawStringRep>(drawString->getId());
+    std::vector<CachedGlyph> cachedGlyphs;
 
     // Convert to runs of glyphs
     CTLineRef line = CTLineCreateWithAttributedString((__bridge CFAttributedStringRef)str);
@@ -240,7 +274,9 @@ std::unique_ptr<DrawableString> FontTextureManager_iOS::addString(
     if (!texAtlas)
     {
         // Let's do the biggest possible texture with small cells 32 bits deep
-        texAtlas = new DynamicTextureAtlas("Font Texture Atlas",2048,16,TexTypeUnsignedByte);
+        // Glyphs are all different sizes, so pack them tightly with a skyline
+        texAtlas = new DynamicTextureAtlas("Font Texture Atlas",2048,4,TexTypeUnsignedByte);
+        texAtlas->setLayout(DynamicTextureSkyline);
     }
 
     for (unsigned int ii=0;ii<CFArrayGetCount(runs);ii++)
@@ -336,6 +372,7 @@ std::unique_ptr<DrawableString> FontTextureManager_iOS::addString(
                     drawString->mbr.addPoint(rect.pts[1]);
 
                     glyphsUsed.insert(glyphInfo->glyph);
+                    cachedGlyphs.push_back(CachedGlyph { fm->getId(), glyphInfo->glyph });
                 }
             }
             
@@ -360,6 +397,10 @@ std::unique_ptr<DrawableString> FontTextureManager_iOS::addString(
     else if (drawStringRep)
     {
         drawStringReps.insert(drawStringRep.release());
+        if (!cacheKey.empty())
+        {
+            addCachedString(cacheKey,*drawString,std::move(cachedGlyphs));
+        }
     }
 
     return drawString;
@@ -50,6 +50,9 @@ namespace WhirlyKit
     if (!self)
         return nil;
     _maxDisplayObjects = 0;
+    _incrementalLayout = false;
+    _overlapIndex = OverlapHelper::OverlapGridIndex;
+    _clusterIndex = false;
     lastUpdate = 0.0;
     
     return self;
@@ -59,6 +62,19 @@ namespace WhirlyKit
 {
     layerThread = inLayerThread;
     scene = inScene;
+
+    // Settings made before we started
+    if (const auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager))
+    {
+        layoutManager->setIncrementalLayout(_incrementalLayout);
+        layoutManager->setOverlapIndex(_overlapIndex);
+        layoutManager->setClusterIndex(_clusterIndex);
+
+        // Spread the bigger layout passes over the other cores.
+        // This is our own pool so layout doesn't end up queued behind tile parsing.
+        const int numThreads = std::max(1, (int)[NSProcessInfo processInfo].activeProcessorCount - 1);
+        layoutManager->setLayoutPool(std::make_shared<ThreadPool>(numThreads));
+    }
     
     // Get us view updates, but we'll filter them
     [inLayerThread.viewWatcher addWatcherTarget:self selector:@selector(viewUpdate:) minTime:0.0 minDist:0.0 maxLagTime:0.0];
@@ -68,6 +84,10 @@ namespace WhirlyKit
 
 - (void)teardown
 {
+    if (const auto layoutManager = scene ? scene->getManager<LayoutManager>(kWKLayoutManager) : nullptr)
+    {
+        layoutManager->setLayoutPool(ThreadPoolRef());
+    }
     scene = NULL;
     [layerThread.viewWatcher removeWatcherTarget:self selector:@selector(viewUpdate:)];
 
@@ -150,6 +170,33 @@ static const float MaxDelay = 1.0;
         layoutManager->setMaxDisplayObjects(_maxDisplayObjects);
 }
 
+- (void)setIncrementalLayout:(bool)incrementalLayout
+{
+    _incrementalLayout = incrementalLayout;
+    if (const auto layoutManager = scene ? scene->getManager<LayoutManager>(kWKLayoutManager) : nullptr)
+    {
+        layoutManager->setIncrementalLayout(_incrementalLayout);
+    }
+}
+
+- (void)setOverlapIndex:(OverlapHelper::IndexType)overlapIndex
+{
+    _overlapIndex = overlapIndex;
+    if (const auto layoutManager = scene ? scene->getManager<LayoutManager>(kWKLayoutManager) : nullptr)
+    {
+        layoutManager->setOverlapIndex(_overlapIndex);
+    }
+}
+
+- (void)setClusterIndex:(bool)clusterIndex
+{
+    _clusterIndex = clusterIndex;
+    if (const auto layoutManager = scene ? scene->getManager<LayoutManager>(kWKLayoutManager) : nullptr)
+    {
+        layoutManager->setClusterIndex(_clusterIndex);
+    }
+}
+
 // Layout all the objects we're tracking
 - (void)updateLayout
 {